@@ -19,6 +19,11 @@ uint32_t ast_vm_ulongs = 0;
 uint32_t ast_vm_floats = 0;
 uint32_t ast_vm_doubles = 0;
 
+uint32_t ast_const_uints = 0;
+uint32_t ast_const_doubles = 0;
+uint32_t *ast_const_uint_data = NULL;
+double *ast_const_double_data = NULL;
+
 uint32_t ast_submit_sz = 0;
 uint32_t ast_submit_idx = 0;
 
@@ -75,6 +80,16 @@ extern bool create_epl_ast(char *source) {
 	ast_vm_floats = 0;
 	ast_vm_doubles = 0;
 
+	// Reset Constant Arrays
+	if (ast_const_uint_data)
+		free(ast_const_uint_data);
+	if (ast_const_double_data)
+		free(ast_const_double_data);
+	ast_const_uint_data = NULL;
+	ast_const_double_data = NULL;
+	ast_const_uints = 0;
+	ast_const_doubles = 0;
+
 	// Reset Storage Variables
 	ast_submit_sz = 0;
 	ast_submit_idx = 0;
@@ -220,7 +235,7 @@ static void print_node(ast* node) {
 	case NODE_VAR_CONST:
 		if (node->is_float) {
 			if (node->is_64bit)
-				printf("\tType: %d,\td[%lu]\t\t\t", node->type, node->uvalue);
+				printf("\tType: %d,\t%s[%lu]\t\t\t", node->type, node->is_vm_const ? "cd" : "d", node->uvalue);
 			else
 				printf("\tType: %d,\tf[%lu]\t\t\t", node->type, node->uvalue);
 		}
@@ -236,7 +251,9 @@ static void print_node(ast* node) {
 					printf("\tType: %d,\ti[%lu]\t\t\t", node->type, node->uvalue);
 				}
 				else {
-					if (node->is_vm_mem)
+					if (node->is_vm_const)
+						printf("\tType: %d,\tcu[%lu]\t\t\t", node->type, node->uvalue);
+					else if (node->is_vm_mem)
 						printf("\tType: %d,\tm[%lu]\t\t\t", node->type, node->uvalue);
 					else
 						printf("\tType: %d,\tu[%lu]\t\t\t", node->type, node->uvalue);
@@ -247,7 +264,7 @@ static void print_node(ast* node) {
 	case NODE_VAR_EXP:
 		if (node->is_float) {
 			if (node->is_64bit)
-				printf("\tType: %d,\td[x]\t\t\t", node->type);
+				printf("\tType: %d,\t%s[x]\t\t\t", node->type, node->is_vm_const ? "cd" : "d");
 			else
 				printf("\tType: %d,\tf[x]\t\t\t", node->type);
 		}
@@ -263,7 +280,9 @@ static void print_node(ast* node) {
 					printf("\tType: %d,\ti[x]\t\t\t", node->type);
 				}
 				else {
-					if (node->is_vm_mem)
+					if (node->is_vm_const)
+						printf("\tType: %d,\tcu[x]\t\t\t", node->type);
+					else if (node->is_vm_mem)
 						printf("\tType: %d,\tm[x]\t\t\t", node->type);
 					else
 						printf("\tType: %d,\tu[x]\t\t\t", node->type);
@@ -410,6 +429,90 @@ extern char* get_node_str(NODE_TYPE node_type) {
 	case NODE_FABS:			return "fabs";
 	case NODE_FMOD:			return "fmod";
 	case NODE_GCD:			return "gcd";
+	case NODE_POPCOUNT:		return "popcount";
+	case NODE_CLZ:			return "clz";
+	case NODE_BSWAP32:		return "bswap32";
+	case NODE_MULHI:		return "mulhi";
+	case NODE_MIN:			return "min";
+	case NODE_MAX:			return "max";
+	case NODE_SELECT:		return "select";
+	case NODE_SHA256_BLOCK:	return "sha256_block";
+	case NODE_MD5_BLOCK:	return "md5_block";
+	case NODE_KECCAK_F1600:	return "keccak_f1600";
+	case NODE_COPY:			return "copy";
+	case NODE_FILL:			return "fill";
+	case NODE_ARRAY_INIT:	return "array[x..]";
 	default: return "Unknown";
 	}
 }
+
+// Number Of Elements In The VM Array A Variable Node Refers To
+extern uint32_t get_array_size(ast *node) {
+	switch (node->data_type) {
+	case DT_INT:	return ast_vm_ints;
+	case DT_LONG:	return ast_vm_longs;
+	case DT_ULONG:	return ast_vm_ulongs;
+	case DT_FLOAT:	return ast_vm_floats;
+	case DT_DOUBLE:	return node->is_vm_const ? ast_const_doubles : ast_vm_doubles;
+	case DT_UINT:
+		if (node->is_vm_const)
+			return ast_const_uints;
+		if (node->is_vm_mem)
+			return VM_M_ARRAY_SIZE;
+		if (node->is_vm_storage)
+			return ast_submit_sz;
+		return ast_vm_uints;
+	default:
+		return 0;
+	}
+}
+
+// True If A Variable Is Passed To copy() / fill() Or A Crypto Block Function As The Start Of A Range Rather Than As A Value
+extern bool is_array_ref(ast *node) {
+	ast *param;
+	int arg = 0;
+
+	if (!node || !node->parent || (node->parent->type != NODE_PARAM) || (node != node->parent->left))
+		return false;
+
+	param = node->parent;
+	while (param->parent && (param->parent->type == NODE_PARAM) && (param == param->parent->right)) {
+		param = param->parent;
+		arg++;
+	}
+
+	if (!param->parent)
+		return false;
+	else if (param->parent->type == NODE_COPY)
+		return (arg < 2);
+	else if ((param->parent->type == NODE_FILL) || (param->parent->type == NODE_KECCAK_F1600))
+		return (arg == 0);
+	else if ((param->parent->type == NODE_SHA256_BLOCK) || (param->parent->type == NODE_MD5_BLOCK))
+		return (arg < 2);
+
+	return false;
+}
+
+// Element Type The Operands Of A Vector Node Are Converted To - Comparisons Compare In The
+// Widest Vector Operand Type & Return An Int Mask, Other Operators Work In Their Own Type
+extern DATA_TYPE get_vector_operand_type(ast *node) {
+	DATA_TYPE dt_l, dt_r;
+
+	switch (node->type) {
+	case NODE_EQ:
+	case NODE_NE:
+	case NODE_GT:
+	case NODE_LT:
+	case NODE_GE:
+	case NODE_LE:
+		dt_l = node->left->vec_len ? node->left->data_type : node->right->data_type;
+		dt_r = node->right->vec_len ? node->right->data_type : node->left->data_type;
+		if ((dt_l == DT_FLOAT) || (dt_r == DT_FLOAT))
+			return DT_FLOAT;
+		else if ((dt_l == DT_UINT) || (dt_r == DT_UINT))
+			return DT_UINT;
+		return DT_INT;
+	default:
+		return node->data_type;
+	}
+}
@@ -27,6 +27,7 @@
 #define CALL_STACK_SIZE 257				// Maximum Number Of Nested Function Calls
 #define REPEAT_STACK_SIZE 33			// Maximum Number Of Nested Repeat Statements
 #define CODE_STACK_SIZE 10000			// Maximum Number Of Lines Of C / OpenCL Code - TODO: Finalize Size
+#define CODE_BUF_CHUNK 65536			// Growth Step For In-Memory C Source Buffers
 
 #define MAX_AST_DEPTH 20000				// Maximum Depth Allowed In The AST Tree - TODO: Finalize Size
 
@@ -45,6 +46,12 @@ uint32_t ast_vm_ulongs;
 uint32_t ast_vm_floats;
 uint32_t ast_vm_doubles;
 
+// Read Only Constant Arrays (Shared By All Threads)
+uint32_t ast_const_uints;
+uint32_t ast_const_doubles;
+uint32_t *ast_const_uint_data;
+double *ast_const_double_data;
+
 // Number / Location Of Unsigned Ints To Send To Elastic Node For Validation
 uint32_t ast_submit_sz;
 uint32_t ast_submit_idx;
@@ -131,6 +138,19 @@ typedef enum {
 	NODE_FABS,
 	NODE_FMOD,
 	NODE_GCD,
+	NODE_POPCOUNT,
+	NODE_CLZ,
+	NODE_BSWAP32,
+	NODE_MULHI,
+	NODE_MIN,
+	NODE_MAX,
+	NODE_SELECT,
+	NODE_SHA256_BLOCK,
+	NODE_MD5_BLOCK,
+	NODE_KECCAK_F1600,
+	NODE_COPY,
+	NODE_FILL,
+	NODE_ARRAY_INIT,
 	NODE_ARRAY_INT,
 	NODE_ARRAY_UINT,
 	NODE_ARRAY_LONG,
@@ -226,12 +246,27 @@ typedef enum {
 	TOKEN_FABS,
 	TOKEN_FMOD,
 	TOKEN_GCD,
+	TOKEN_POPCOUNT,
+	TOKEN_CLZ,
+	TOKEN_BSWAP32,
+	TOKEN_MULHI,
+	TOKEN_MIN,
+	TOKEN_MAX,
+	TOKEN_SELECT,
+	TOKEN_SHA256_BLOCK,
+	TOKEN_MD5_BLOCK,
+	TOKEN_KECCAK_F1600,
+	TOKEN_COPY,
+	TOKEN_FILL,
+	TOKEN_VAR_RANGE,
 	TOKEN_ARRAY_INT,
 	TOKEN_ARRAY_UINT,
 	TOKEN_ARRAY_LONG,
 	TOKEN_ARRAY_ULONG,
 	TOKEN_ARRAY_FLOAT,
 	TOKEN_ARRAY_DOUBLE,
+	TOKEN_CONST_UINT,
+	TOKEN_CONST_DOUBLE,
 	TOKEN_SUBMIT_SZ,
 	TOKEN_SUBMIT_IDX,
 	TOKEN_FUNCTION,
@@ -257,7 +292,15 @@ typedef enum {
 	DT_FLOAT,
 	DT_DOUBLE,
 	DT_UINT_M,
-	DT_UINT_S
+	DT_UINT_S,
+	DT_UINT_C,
+	DT_DOUBLE_C,
+	DT_INT_V4,
+	DT_INT_V8,
+	DT_UINT_V4,
+	DT_UINT_V8,
+	DT_FLOAT_V4,
+	DT_FLOAT_V8
 } DATA_TYPE;
 
 // Token Type / Literal Value From ElasticPL Source Code
@@ -306,11 +349,35 @@ typedef struct AST {
 	bool is_float;
 	bool is_vm_mem;
 	bool is_vm_storage;
+	bool is_vm_const;
+	uint32_t vec_len;
 	struct AST*	parent;
 	struct AST*	left;
 	struct AST*	right;
 } ast;
 
+// Growable Buffer Holding Generated Source Code
+typedef struct CODE_BUF {
+	char *buf;
+	size_t len;
+	size_t sz;
+	bool error;		// Set If An Allocation Failed Since The Last Reset
+} CODE_BUF;
+
+// Location Of A Function's Generated C Code Within job_code
+typedef struct CODE_FUNC {
+	size_t decl_start;
+	size_t decl_len;
+	size_t code_start;
+	size_t code_len;
+} CODE_FUNC;
+
+extern CODE_BUF job_code;	// C Code For The Most Recently Converted Job
+extern CODE_FUNC job_consts;	// cu[] / cd[] Declarations & Definitions
+extern CODE_FUNC *job_funcs;	// One Entry Per Function (Starting At ast_func_idx)
+extern bool *job_func_calls;	// [caller * job_func_cnt + callee] Is Set If caller Calls callee
+extern int job_func_cnt;
+
 int stack_op_idx;
 int stack_exp_idx;
 int top_op;
@@ -337,8 +404,23 @@ static ast* pop_exp();
 static void push_exp(ast* exp);
 static int pop_op();
 static void push_op(int token_id);
-static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool is_vm_storage, int64_t val_int64, uint64_t val_uint64, double val_double, unsigned char *svalue, int token_num, int line_num, DATA_TYPE data_type, ast* left, ast* right);
+static DATA_TYPE get_promoted_type(DATA_TYPE dt_l, DATA_TYPE dt_r);
+static void set_data_type(ast *e, DATA_TYPE data_type);
+static DATA_TYPE get_arg_type(ast *arg);
+static void set_function_type(ast *e);
+static bool validate_block_arg(SOURCE_TOKEN *token, NODE_TYPE node_type, ast *ref, uint32_t len, DATA_TYPE data_type);
+static bool validate_array_ref(SOURCE_TOKEN *token, NODE_TYPE node_type, ast *ref, ast *n);
+static uint32_t get_vector_lanes(DATA_TYPE data_type, DATA_TYPE *elem_type);
+static bool has_side_effects(ast *e);
+static bool validate_vector_exp(SOURCE_TOKEN *token, ast *e, uint32_t var_lanes);
+static int get_init_values(SOURCE_TOKEN_LIST *token_list, int token_num, int *end, bool is_float, uint64_t **values);
+static bool create_array_init(SOURCE_TOKEN_LIST *token_list, int *token_num);
+static bool create_const_data(SOURCE_TOKEN_LIST *token_list, int *token_num);
+static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool is_vm_storage, bool is_vm_const, int64_t val_int64, uint64_t val_uint64, double val_double, unsigned char *svalue, int token_num, int line_num, DATA_TYPE data_type, ast* left, ast* right);
 extern char* get_node_str(NODE_TYPE node_type);
+extern uint32_t get_array_size(ast *node);
+extern bool is_array_ref(ast *node);
+extern DATA_TYPE get_vector_operand_type(ast *node);
 extern void dump_vm_ast(ast* root);
 static void print_node(ast* node);
 extern void clean_up_ast_internal(ast* node, bool keep_svalue);
@@ -347,17 +429,36 @@ static bool validate_ast();
 static bool validate_functions();
 static bool validate_function_calls();
 
+static bool code_buf_reserve(CODE_BUF *code, size_t len);
+extern bool code_buf_printf(CODE_BUF *code, const char *fmt, ...);
+extern bool code_buf_append(CODE_BUF *code, const char *str, size_t len);
+extern void code_buf_reset(CODE_BUF *code);
+extern void code_buf_free(CODE_BUF *code);
+static bool init_job_funcs();
+static int get_function_idx(unsigned char *name);
 extern bool convert_ast_to_c(char *work_str);
 extern bool convert_ast_to_opencl(FILE* f);
+static void convert_const_data(CODE_BUF *code, const char *qual);
 static bool convert_function(ast* root);
 static bool convert_node(ast* node);
+static bool push_node_code(ast *node, char *str);
+static const char *get_array_name(ast *node);
+static char *convert_array_init(ast *node);
+static const char *get_type_name(DATA_TYPE data_type);
+static const char *get_fill_cast(DATA_TYPE data_type);
 static void get_cast(char *lcast, char *rcast, DATA_TYPE ldata_type, DATA_TYPE rdata_type, bool right_only);
 static bool get_node_inputs(ast* node, char **lstr, char **rstr);
+static const char *get_vector_type_name(DATA_TYPE data_type, uint32_t lanes);
+static char *get_vector_operand(ast *arg, const char *str, DATA_TYPE data_type, uint32_t lanes, bool broadcast);
+static char *get_vector_select(ast *node, const char *cond, const char *a, const char *b);
+static char *convert_vector_var(ast *node, const char *idx, bool var_exp_flg);
+static bool convert_vector_node(ast *node, char *lstr, char *rstr, bool var_exp_flg);
 
 extern uint64_t calc_wcet();
 extern uint64_t get_verify_wcet();
 extern uint64_t get_main_wcet();
 static uint64_t calc_function_weight(ast* root, uint32_t *depth);
 static uint64_t get_node_weight(ast* node);
+static uint64_t get_range_weight(ast* node);
 
 #endif // ELASTICPL_H_
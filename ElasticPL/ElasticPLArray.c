@@ -0,0 +1,75 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Array Functions (copy, fill)
+//
+// Ranges are checked once per call instead of once per element.  A range
+// that does not fit in its array turns the whole call into a no-op.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "ElasticPLFunctions.h"
+
+static bool range_in_array(uint32_t size, uint64_t idx, uint64_t n) {
+	return (n <= size) && (idx <= (uint64_t)(size - n));
+}
+
+// memmove So Overlapping Ranges Of The Same Array Behave Like An Element By Element Copy Through A Temp
+extern void array_copy(void *dst_arr, uint32_t dst_size, const void *src_arr, uint32_t src_size, uint32_t elem_size, uint64_t dst, uint64_t src, uint64_t n) {
+	if (!n || !dst_arr || !src_arr || !range_in_array(dst_size, dst, n) || !range_in_array(src_size, src, n))
+		return;
+
+	memmove((char *)dst_arr + (dst * elem_size), (const char *)src_arr + (src * elem_size), (size_t)(n * elem_size));
+}
+
+extern void array_fill32(uint32_t *arr, uint32_t size, uint64_t dst, uint32_t value, uint64_t n) {
+	uint64_t i;
+
+	if (!n || !arr || !range_in_array(size, dst, n))
+		return;
+
+	if (!value) {
+		memset(&arr[dst], 0, (size_t)(n * sizeof(uint32_t)));
+		return;
+	}
+
+	for (i = 0; i < n; i++)
+		arr[dst + i] = value;
+}
+
+extern void array_fill64(uint64_t *arr, uint32_t size, uint64_t dst, uint64_t value, uint64_t n) {
+	uint64_t i;
+
+	if (!n || !arr || !range_in_array(size, dst, n))
+		return;
+
+	if (!value) {
+		memset(&arr[dst], 0, (size_t)(n * sizeof(uint64_t)));
+		return;
+	}
+
+	for (i = 0; i < n; i++)
+		arr[dst + i] = value;
+}
+
+extern void array_fillf(float *arr, uint32_t size, uint64_t dst, float value, uint64_t n) {
+	uint32_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	array_fill32((uint32_t *)arr, size, dst, bits, n);
+}
+
+extern void array_filld(double *arr, uint32_t size, uint64_t dst, double value, uint64_t n) {
+	uint64_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	array_fill64((uint64_t *)arr, size, dst, bits, n);
+}
@@ -7,6 +7,7 @@
 * any later version.
 */
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -20,9 +21,19 @@
 char *stack_code[CODE_STACK_SIZE];
 int stack_code_idx;
 
-// Work ID Used To Make ElasticPL Functions Unique Per Job
+CODE_BUF job_code;
+CODE_FUNC job_consts;
+CODE_FUNC *job_funcs = NULL;
+bool *job_func_calls = NULL;
+int job_func_cnt = 0;
+
+// Job Functions Are Hidden Inside Their Library, So The Same Suffix Is Used For
+// Every Job - Identical Functions Then Produce Identical Code Between Jobs
 char job_suffix[22];
 
+// Index Of The Function Being Converted (Used To Record Calls)
+static int cur_func = -1;
+
 // Hard Coded Tabs...Could Make This Dynamic
 char *tab[] = { "", "\t", "\t\t", "\t\t\t", "\t\t\t\t", "\t\t\t\t\t", "\t\t\t\t\t\t", "\t\t\t\t\t\t\t", "\t\t\t\t\t\t\t" };
 //char *tab[] = { "\t", "\t\t", "\t\t\t", "\t\t\t\t", "\t\t\t\t\t", "\t\t\t\t\t\t", "\t\t\t\t\t\t\t", "\t\t\t\t\t\t\t" };
@@ -42,64 +53,210 @@ static char* pop_code() {
 		return NULL;
 }
 
+static bool code_buf_reserve(CODE_BUF *code, size_t len) {
+	char *buf;
+	size_t sz;
+
+	if (code->len + len + 1 <= code->sz)
+		return true;
+
+	sz = code->sz + ((len + 1 + CODE_BUF_CHUNK) / CODE_BUF_CHUNK) * CODE_BUF_CHUNK;
+	buf = realloc(code->buf, sz);
+	if (!buf) {
+		code->error = true;
+		return false;
+	}
+	code->buf = buf;
+	code->sz = sz;
+
+	return true;
+}
+
+extern bool code_buf_append(CODE_BUF *code, const char *str, size_t len) {
+	if (!code_buf_reserve(code, len))
+		return false;
+
+	memcpy(&code->buf[code->len], str, len);
+	code->len += len;
+	code->buf[code->len] = 0;
+
+	return true;
+}
+
+extern bool code_buf_printf(CODE_BUF *code, const char *fmt, ...) {
+	va_list ap;
+	int len;
+
+	// Try To Write Directly Into The Free Space At The End Of The Buffer
+	va_start(ap, fmt);
+	len = vsnprintf(code->buf ? &code->buf[code->len] : NULL, code->sz - code->len, fmt, ap);
+	va_end(ap);
+
+	if (len < 0) {
+		code->error = true;
+		return false;
+	}
+
+	// Output Was Truncated - Grow The Buffer And Write Again
+	if (code->len + len >= code->sz) {
+		if (!code_buf_reserve(code, len))
+			return false;
+
+		va_start(ap, fmt);
+		vsnprintf(&code->buf[code->len], code->sz - code->len, fmt, ap);
+		va_end(ap);
+	}
+	code->len += len;
+
+	return true;
+}
+
+extern void code_buf_reset(CODE_BUF *code) {
+	code->len = 0;
+	code->error = false;
+	if (code->buf)
+		code->buf[0] = 0;
+}
+
+extern void code_buf_free(CODE_BUF *code) {
+	if (code->buf)
+		free(code->buf);
+	code->buf = NULL;
+	code->len = 0;
+	code->sz = 0;
+	code->error = false;
+}
+
+static bool init_job_funcs() {
+	int num = stack_exp_idx - ast_func_idx + 1;
+
+	if (job_funcs)
+		free(job_funcs);
+	if (job_func_calls)
+		free(job_func_calls);
+
+	job_funcs = calloc(num, sizeof(CODE_FUNC));
+	job_func_calls = calloc(num * num, sizeof(bool));
+	job_func_cnt = num;
+
+	if (!job_funcs || !job_func_calls) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for function list");
+		job_func_cnt = 0;
+		return false;
+	}
+
+	return true;
+}
+
+static int get_function_idx(unsigned char *name) {
+	int i;
+
+	for (i = ast_func_idx; i <= stack_exp_idx; i++) {
+		if (!strcmp(stack_exp[i]->svalue, name))
+			return i - ast_func_idx;
+	}
+	return -1;
+}
+
+// cu[] / cd[] Are Defined Once Per Program, So Every Miner Thread Reads The Same Copy
+static void convert_const_data(CODE_BUF *code, const char *qual) {
+	uint32_t i;
+
+	if (ast_const_uints) {
+		code_buf_printf(code, "%s uint32_t cu[%u] = {", qual, ast_const_uints);
+		for (i = 0; i < ast_const_uints; i++)
+			code_buf_printf(code, "%s0x%08X%s", (i % 8) ? " " : "\n\t", ast_const_uint_data[i], (i < ast_const_uints - 1) ? "," : "");
+		code_buf_printf(code, "\n};\n");
+	}
+
+	if (ast_const_doubles) {
+		code_buf_printf(code, "%s double cd[%u] = {", qual, ast_const_doubles);
+		for (i = 0; i < ast_const_doubles; i++)
+			code_buf_printf(code, "%s%.17g%s", (i % 8) ? " " : "\n\t", ast_const_double_data[i], (i < ast_const_doubles - 1) ? "," : "");
+		code_buf_printf(code, "\n};\n");
+	}
+}
+
 extern bool convert_ast_to_c(char *work_str) {
 	int i, j;
-	char file_name[100];
+	bool rc = true;
 
-	// Copy WorkID To Job Suffix
-	sprintf(job_suffix, "%s", work_str);
+	sprintf(job_suffix, "job");
 
-	sprintf(file_name, "./work/job_%s.h", job_suffix);
+	// Generated Code Is Kept In Memory Until The Library Is Compiled
+	code_buf_reset(&job_code);
 
-	FILE* f = fopen(file_name, "w");
-	if (!f){
+	if (!init_job_funcs())
 		return false;
-	}
+
+	// Write Constant Arrays - Split Builds Define Them In The Unit Holding main
+	job_consts.decl_start = job_code.len;
+	if (ast_const_uints)
+		code_buf_printf(&job_code, "extern EPL_HIDDEN const uint32_t cu[%u];\n", ast_const_uints);
+	if (ast_const_doubles)
+		code_buf_printf(&job_code, "extern EPL_HIDDEN const double cd[%u];\n", ast_const_doubles);
+	job_consts.decl_len = job_code.len - job_consts.decl_start;
+
+	job_consts.code_start = job_code.len;
+	convert_const_data(&job_code, "EPL_HIDDEN const");
+	job_consts.code_len = job_code.len - job_consts.code_start;
+	if (job_consts.code_len)
+		code_buf_append(&job_code, "\n", 1);
 
 	// Write Function Declarations
 	for (i = ast_func_idx; i <= stack_exp_idx; i++) {
+		job_funcs[i - ast_func_idx].decl_start = job_code.len;
 		if ((i == ast_main_idx) || (i == ast_verify_idx))
-			fprintf(f, "void %s_%s(uint32_t *, uint32_t, uint32_t *, uint32_t *, uint32_t *);\n", stack_exp[i]->svalue, job_suffix);
+			code_buf_printf(&job_code, "EPL_HIDDEN void %s_%s(uint32_t *, uint32_t, uint32_t *, uint32_t *, uint32_t *);\n", stack_exp[i]->svalue, job_suffix);
 		else
-			fprintf(f, "void %s_%s();\n", stack_exp[i]->svalue, job_suffix);
+			code_buf_printf(&job_code, "EPL_HIDDEN void %s_%s();\n", stack_exp[i]->svalue, job_suffix);
+		job_funcs[i - ast_func_idx].decl_len = job_code.len - job_funcs[i - ast_func_idx].decl_start;
 	}
-	fprintf(f, "\n");
-	fflush(f);
+	code_buf_append(&job_code, "\n", 1);
 
 	// Write Function Definitions
 	for (i = ast_func_idx; i <= stack_exp_idx; i++) {
 
 		stack_code_idx = 0;
 		tabs = 0;
+		cur_func = i - ast_func_idx;
+		job_funcs[cur_func].code_start = job_code.len;
 
 		if (!convert_function(stack_exp[i])) {
-			fclose(f);
-			return false;
+			rc = false;
+			break;
 		}
 
 		for (j = 0; j < stack_code_idx; j++) {
 			if (stack_code[j]) {
-				fprintf(f, "%s", stack_code[j]);
+				code_buf_append(&job_code, stack_code[j], strlen(stack_code[j]));
 				free(stack_code[j]);
 				stack_code[j] = NULL;
 			}
 		}
-		fprintf(f, "\n");
-		fflush(f);
+		code_buf_append(&job_code, "\n", 1);
+		job_funcs[cur_func].code_len = job_code.len - job_funcs[cur_func].code_start;
 	}
+	cur_func = -1;
 
-	fflush(f);
-	fclose(f);
-
-	return true;
+	return rc && !job_code.error;
 }
 
 extern bool convert_ast_to_opencl(FILE* f) {
+	CODE_BUF consts = { 0 };
 	int i, j;
 
 	if (!f)
 		return false;
 
+	// Write Constant Arrays
+	if (ast_const_uints || ast_const_doubles) {
+		convert_const_data(&consts, "__constant");
+		if (consts.buf)
+			fprintf(f, "%s\n", consts.buf);
+		code_buf_free(&consts);
+	}
+
 	// Write Function Declarations
 	for (i = ast_func_idx; i <= stack_exp_idx; i++) {
 		if (i == ast_main_idx)
@@ -160,7 +317,7 @@ extern bool convert_ast_to_opencl(FILE* f) {
 
 			fprintf(f, "\tuint res = 0;\n\n");
 			fprintf(f, "\tint idx = get_global_id(0); // Index in the wavefront Dim1\n");
-			fprintf(f, "\tint round_num = idx + (rnd[0] * get_global_size(0));  // Each GPU Thread Gets A Unique Round Number\n\n");
+			fprintf(f, "\tuint round_num = rnd[0] + idx;  // Each GPU Thread Gets A Unique Round Number\n\n");
 
 			fprintf(f, "\t// 96 Bytes of base_data is made up of:\n");
 			fprintf(f, "\t// 32 Byte Multiplicator\n");
@@ -334,6 +491,13 @@ static bool convert_node(ast* node) {
 	if (!get_node_inputs(node, &lstr, &rstr))
 		return false;
 
+	// Short Vectors Are Lowered To GCC Vector Extensions / OpenCL Vector Types
+	if (node->vec_len) {
+		if ((node->type == NODE_VAR_EXP) && node->parent->end_stmnt && (node == node->parent->left))
+			var_exp_flg = true;
+		return convert_vector_node(node, lstr, rstr, var_exp_flg);
+	}
+
 	switch (node->type) {
 	case NODE_FUNCTION:
 		str = malloc(350);
@@ -406,6 +570,10 @@ static bool convert_node(ast* node) {
 			else
 				sprintf(str, "%s_%s()", node->svalue, job_suffix);
 		}
+
+		// Record The Call Graph For Splitting The Job Into Translation Units
+		if (!opt_opencl && (cur_func >= 0) && (get_function_idx(node->svalue) >= 0))
+			job_func_calls[(cur_func * job_func_cnt) + get_function_idx(node->svalue)] = true;
 		break;
 	case NODE_VERIFY_BTY:
 		str = malloc(strlen(lstr) + 50);
@@ -447,12 +615,21 @@ static bool convert_node(ast* node) {
 		break;
 	case NODE_VAR_CONST:
 		str = malloc(30);
+
+		// Start Of A copy() / fill() Range - Only The Index Is Passed
+		if (is_array_ref(node)) {
+			sprintf(str, "%lu", node->uvalue);
+			break;
+		}
+
 		switch (node->data_type) {
 		case DT_INT:
 			sprintf(str, "i[%lu]", ((node->uvalue >= ast_vm_ints) ? 0 : node->uvalue));
 			break;
 		case DT_UINT:
-			if (node->is_vm_mem)
+			if (node->is_vm_const)
+				sprintf(str, "cu[%lu]", ((node->uvalue >= ast_const_uints) ? 0 : node->uvalue));
+			else if (node->is_vm_mem)
 				sprintf(str, "m[%lu]", ((node->uvalue >= ast_vm_uints) ? 0 : node->uvalue));
 			else if (node->is_vm_storage)
 				sprintf(str, "s[%lu]", ((node->uvalue >= ast_vm_uints) ? 0 : node->uvalue));
@@ -469,7 +646,10 @@ static bool convert_node(ast* node) {
 			sprintf(str, "f[%lu]", ((node->uvalue >= ast_vm_floats) ? 0 : node->uvalue));
 			break;
 		case DT_DOUBLE:
-			sprintf(str, "d[%lu]", ((node->uvalue >= ast_vm_doubles) ? 0 : node->uvalue));
+			if (node->is_vm_const)
+				sprintf(str, "cd[%lu]", ((node->uvalue >= ast_const_doubles) ? 0 : node->uvalue));
+			else
+				sprintf(str, "d[%lu]", ((node->uvalue >= ast_vm_doubles) ? 0 : node->uvalue));
 			break;
 		default:
 			applog(LOG_ERR, "Compiler Error: Invalid variable at Line: %d", node->line_num);
@@ -481,6 +661,12 @@ static bool convert_node(ast* node) {
 		}
 		break;
 	case NODE_VAR_EXP:
+		if (is_array_ref(node)) {
+			str = lstr;
+			lstr = NULL;
+			break;
+		}
+
 		if (node->parent->end_stmnt && (node == node->parent->left))
 			var_exp_flg = true;
 
@@ -494,7 +680,10 @@ static bool convert_node(ast* node) {
 				sprintf(str, "i[(((%s) < %u) ? %s : 0)]", lstr, ast_vm_ints, lstr);
 			break;
 		case DT_UINT:
-			if (node->is_vm_mem) {
+			if (node->is_vm_const) {
+				sprintf(str, "cu[(((%s) < %u) ? %s : 0)]", lstr, ast_const_uints, lstr);
+			}
+			else if (node->is_vm_mem) {
 				if (var_exp_flg)
 					sprintf(str, "if((%s) < %u)\n\t%sm[%s]", lstr, VM_M_ARRAY_SIZE, tab[tabs], lstr);
 				else
@@ -532,7 +721,9 @@ static bool convert_node(ast* node) {
 				sprintf(str, "f[(((%s) < %u) ? %s : 0)]", lstr, ast_vm_floats, lstr);
 			break;
 		case DT_DOUBLE:
-			if (var_exp_flg)
+			if (node->is_vm_const)
+				sprintf(str, "cd[(((%s) < %u) ? %s : 0)]", lstr, ast_const_doubles, lstr);
+			else if (var_exp_flg)
 				sprintf(str, "if((%s) < %u)\n\t%sd[%s]", lstr, ast_vm_doubles, tab[tabs], lstr);
 			else
 				sprintf(str, "d[(((%s) < %u) ? %s : 0)]", lstr, ast_vm_doubles, lstr);
@@ -882,6 +1073,98 @@ static bool convert_node(ast* node) {
 		sprintf(str, "gcd(%s, %s)", lstr, rstr);
 		use_elasticpl_math = true;
 		break;
+
+	// Bit Functions - Map To Compiler Builtins In ElasticPLRuntime.h / OpenCL Built-ins
+	case NODE_POPCOUNT:
+		str = malloc(strlen(lstr) + 40);
+		if (opt_opencl)
+			sprintf(str, "(uint)popcount((%s)(%s))", node->right->left->is_64bit ? "ulong" : "uint", lstr);
+		else
+			sprintf(str, "%s(%s)", node->right->left->is_64bit ? "popcnt64" : "popcnt32", lstr);
+		break;
+	case NODE_CLZ:
+		str = malloc(strlen(lstr) + 40);
+		if (opt_opencl)
+			sprintf(str, "(uint)clz((%s)(%s))", node->right->left->is_64bit ? "ulong" : "uint", lstr);
+		else
+			sprintf(str, "%s(%s)", node->right->left->is_64bit ? "clz64" : "clz32", lstr);
+		break;
+	case NODE_BSWAP32:
+		str = malloc(strlen(lstr) + 30);
+		if (opt_opencl)
+			sprintf(str, "swap32((uint)(%s))", lstr);
+		else
+			sprintf(str, "bswap32((uint32_t)(%s))", lstr);
+		break;
+	case NODE_MULHI:
+		str = malloc(strlen(lstr) + strlen(rstr) + 40);
+		if (opt_opencl)
+			sprintf(str, "mul_hi((ulong)(%s), (ulong)(%s))", lstr, rstr);
+		else
+			sprintf(str, "mulhi64((uint64_t)(%s), (uint64_t)(%s))", lstr, rstr);
+		break;
+	case NODE_MIN:
+	case NODE_MAX:
+		str = malloc(strlen(lstr) + strlen(rstr) + 50);
+		if (node->is_float)
+			sprintf(str, "%s%s((%s)(%s), (%s)(%s))", (node->type == NODE_MIN) ? "fmin" : "fmax", (!opt_opencl && !node->is_64bit) ? "f" : "", get_type_name(node->data_type), lstr, get_type_name(node->data_type), rstr);
+		else if (opt_opencl)
+			sprintf(str, "%s((%s)(%s), (%s)(%s))", (node->type == NODE_MIN) ? "min" : "max", get_type_name(node->data_type), lstr, get_type_name(node->data_type), rstr);
+		else
+			sprintf(str, "%s%s%s(%s, %s)", node->is_signed ? "i" : "u", (node->type == NODE_MIN) ? "min" : "max", node->is_64bit ? "64" : "32", lstr, rstr);
+		break;
+	case NODE_SELECT:
+		str = malloc(strlen(lstr) + strlen(rstr) + 20);
+		sprintf(str, "((%s) ? %s)", lstr, rstr);
+		break;
+
+	// Crypto Block Functions - Native Versions In ElasticPLCrypto.c / OpenCL Prelude
+	case NODE_SHA256_BLOCK:
+	case NODE_MD5_BLOCK:
+		str = malloc(strlen(lstr) + strlen(rstr) + 70);
+		sprintf(str, "%s(u, %u, (%s)(%s), (%s)(%s))", get_node_str(node->type), ast_vm_uints, opt_opencl ? "ulong" : "uint64_t", lstr, opt_opencl ? "ulong" : "uint64_t", rstr);
+		break;
+	case NODE_KECCAK_F1600:
+		str = malloc(strlen(lstr) + 50);
+		sprintf(str, "keccak_f1600(ul, %u, (%s)(%s))", ast_vm_ulongs, opt_opencl ? "ulong" : "uint64_t", lstr);
+		break;
+
+	// Array Functions - Native Versions In ElasticPLArray.c / OpenCL Prelude
+	case NODE_COPY:
+		str = malloc(strlen(lstr) + 100);
+		if (opt_opencl)
+			sprintf(str, "array_copy%d((%s *)%s, %u, (%s *)%s, %u, %s)", node->right->left->is_64bit ? 64 : 32,
+				node->right->left->is_64bit ? "ulong" : "uint", get_array_name(node->right->left), get_array_size(node->right->left),
+				node->right->left->is_64bit ? "ulong" : "uint", get_array_name(node->right->right->left), get_array_size(node->right->right->left), lstr);
+		else
+			sprintf(str, "array_copy(%s, %u, %s, %u, sizeof(%s[0]), %s)",
+				get_array_name(node->right->left), get_array_size(node->right->left),
+				get_array_name(node->right->right->left), get_array_size(node->right->right->left),
+				get_array_name(node->right->left), lstr);
+		break;
+	case NODE_FILL:
+		str = malloc(strlen(lstr) + 60);
+		if (opt_opencl)
+			sprintf(str, "array_fill%d((%s *)%s, %u, %s)", node->right->left->is_64bit ? 64 : 32, node->right->left->is_64bit ? "ulong" : "uint",
+				get_array_name(node->right->left), get_array_size(node->right->left), lstr);
+		else {
+			switch (node->right->left->data_type) {
+			case DT_INT:	sprintf(str, "array_fill32((uint32_t *)i, %u, %s)", ast_vm_ints, lstr);		break;
+			case DT_UINT:	sprintf(str, "array_fill32(u, %u, %s)", ast_vm_uints, lstr);				break;
+			case DT_LONG:	sprintf(str, "array_fill64((uint64_t *)l, %u, %s)", ast_vm_longs, lstr);	break;
+			case DT_ULONG:	sprintf(str, "array_fill64(ul, %u, %s)", ast_vm_ulongs, lstr);			break;
+			case DT_FLOAT:	sprintf(str, "array_fillf(f, %u, %s)", ast_vm_floats, lstr);				break;
+			default:		sprintf(str, "array_filld(d, %u, %s)", ast_vm_doubles, lstr);				break;
+			}
+		}
+		break;
+	case NODE_ARRAY_INIT:
+		str = convert_array_init(node);
+		if (!str) {
+			applog(LOG_ERR, "Compiler Error: Unable to allocate memory for table at Line: %d", node->line_num);
+			return false;
+		}
+		break;
 	default:
 		applog(LOG_ERR, "Compiler Error: Unknown expression at Line: %d", node->line_num);
 		return false;
@@ -893,6 +1176,13 @@ static bool convert_node(ast* node) {
 	lstr = NULL;
 	rstr = NULL;
 
+	return push_node_code(node, str);
+}
+
+// Push The Code For A Node (Freeing str) - Statements Are Terminated Here
+static bool push_node_code(ast *node, char *str) {
+	char *tmp = NULL;
+
 	// Terminate Statements
 	if (node->end_stmnt && (node->type != NODE_IF) && (node->type != NODE_ELSE) && (node->type != NODE_REPEAT) && (node->type != NODE_BLOCK) && (node->type != NODE_FUNCTION)) {
 		tmp = malloc(strlen(str) + 20);
@@ -917,6 +1207,359 @@ static bool convert_node(ast* node) {
 	return true;
 }
 
+// Vector Type Names - The C Prelude Names Are The OpenCL Names With A 'v' Prefix
+static const char *get_vector_type_name(DATA_TYPE data_type, uint32_t lanes) {
+	static const char *name[] = { "vint4", "vint8", "vuint4", "vuint8", "vfloat4", "vfloat8" };
+	int idx = ((data_type == DT_UINT) ? 2 : ((data_type == DT_FLOAT) ? 4 : 0)) + ((lanes == 8) ? 1 : 0);
+
+	return opt_opencl ? &name[idx][1] : name[idx];
+}
+
+// Operand Of A Vector Node Converted To The Element Type - Vectors Are Converted Lane By Lane,
+// Scalars Are Cast (GCC / OpenCL Widen Them In Binary Operators) Or Broadcast
+static char *get_vector_operand(ast *arg, const char *str, DATA_TYPE data_type, uint32_t lanes, bool broadcast) {
+	const char *vt = get_vector_type_name(data_type, lanes);
+	char *res = malloc(strlen(str) + 100);
+
+	if (!res)
+		return NULL;
+
+	if (arg->vec_len && (arg->data_type == data_type))
+		sprintf(res, "(%s)", str);
+	else if (arg->vec_len && opt_opencl)
+		sprintf(res, "convert_%s(%s)", vt, str);
+	else if (arg->vec_len)
+		sprintf(res, "__builtin_convertvector((%s), %s)", str, vt);
+	else if (broadcast && opt_opencl)
+		sprintf(res, "(%s)((%s)(%s))", vt, get_type_name(data_type), str);
+	else if (broadcast)
+		sprintf(res, "vdup%u(%s, %s, %s)", lanes, vt, get_type_name(data_type), str);
+	else
+		sprintf(res, "(%s)(%s)", get_type_name(data_type), str);
+
+	return res;
+}
+
+// select(mask, a, b) On Vectors - Lanes Where The Mask Is Non Zero Take a
+static char *get_vector_select(ast *node, const char *cond, const char *a, const char *b) {
+	ast *arg1 = node->right->left;
+	ast *arg2 = node->right->right->left;
+	ast *arg3 = node->right->right->right->left;
+	char *va, *vb, *str;
+
+	va = get_vector_operand(arg2, a, node->data_type, node->vec_len, true);
+	vb = get_vector_operand(arg3, b, node->data_type, node->vec_len, true);
+	str = malloc(strlen(cond) + (va ? strlen(va) : 0) + (vb ? strlen(vb) : 0) + 100);
+
+	if (!va || !vb || !str) {
+		if (va) free(va);
+		if (vb) free(vb);
+		if (str) free(str);
+		return NULL;
+	}
+
+	if (!arg1->vec_len)
+		sprintf(str, "((%s) ? %s : %s)", cond, va, vb);
+	else if (opt_opencl)
+		sprintf(str, "select(%s, %s, (%s) != 0)", vb, va, cond);
+	else
+		sprintf(str, "vselect(%s, %s, (%s) != 0, %s, %s)", get_vector_type_name(node->data_type, node->vec_len), get_vector_type_name(DT_INT, node->vec_len), cond, va, vb);
+
+	free(va);
+	free(vb);
+	return str;
+}
+
+// Vector Variables - x Must Be <= Size - Lanes.  OpenCL Has No Unaligned Vector Lvalues, So Stores
+// Are Returned As An Address For vstoreN (With The Same Range Check Prefix As A Scalar Store)
+static char *convert_vector_var(ast *node, const char *idx, bool var_exp_flg) {
+	const char *name = get_array_name(node);
+	const char *vt = get_vector_type_name(node->data_type, node->vec_len);
+	uint32_t limit = get_array_size(node) - node->vec_len;
+	char *guard, *addr, *str;
+	bool is_store = false;
+
+	switch (node->parent ? node->parent->type : NODE_ERROR) {
+	case NODE_ASSIGN:
+	case NODE_ADD_ASSIGN:
+	case NODE_SUB_ASSIGN:
+	case NODE_MUL_ASSIGN:
+	case NODE_LSHFT_ASSIGN:
+	case NODE_RSHFT_ASSIGN:
+	case NODE_AND_ASSIGN:
+	case NODE_XOR_ASSIGN:
+	case NODE_OR_ASSIGN:
+		is_store = (node == node->parent->left);
+		break;
+	default:
+		break;
+	}
+
+	guard = malloc((idx ? strlen(idx) : 0) + 50);
+	addr = malloc((idx ? (2 * strlen(idx)) : 0) + 50);
+	str = malloc((idx ? (3 * strlen(idx)) : 0) + 150);
+	if (!guard || !addr || !str) {
+		if (guard) free(guard);
+		if (addr) free(addr);
+		if (str) free(str);
+		return NULL;
+	}
+
+	guard[0] = 0;
+	if (node->type == NODE_VAR_CONST) {
+		sprintf(addr, "&%s[%lu]", name, node->uvalue);
+	}
+	else if (var_exp_flg) {
+		sprintf(guard, "if((%s) <= %u)\n\t%s", idx, limit, tab[tabs]);
+		sprintf(addr, "&%s[%s]", name, idx);
+	}
+	else {
+		sprintf(addr, "&%s[(((%s) <= %u) ? %s : 0)]", name, idx, limit, idx);
+	}
+
+	if (opt_opencl && is_store)
+		sprintf(str, "%s%s", guard, addr);
+	else if (opt_opencl)
+		sprintf(str, "vload%u(0, %s)", node->vec_len, addr);
+	else
+		sprintf(str, "%s(*(%s *)%s)", guard, vt, addr);
+
+	free(guard);
+	free(addr);
+	return str;
+}
+
+// Shift Counts Are Taken Modulo 32 In Every Backend (OpenCL Does This Itself)
+static bool convert_vector_node(ast *node, char *lstr, char *rstr, bool var_exp_flg) {
+	DATA_TYPE ot = get_vector_operand_type(node);
+	const char *vt = get_vector_type_name(ot, node->vec_len);
+	const char *op = "";
+	char *l = NULL, *r = NULL, *str = NULL, *addr;
+	bool is_shift = false;
+
+	switch (node->type) {
+	case NODE_VAR_CONST:
+	case NODE_VAR_EXP:
+		str = convert_vector_var(node, lstr, var_exp_flg);
+		break;
+
+	case NODE_ASSIGN:
+	case NODE_ADD_ASSIGN:
+	case NODE_SUB_ASSIGN:
+	case NODE_MUL_ASSIGN:
+	case NODE_LSHFT_ASSIGN:
+	case NODE_RSHFT_ASSIGN:
+	case NODE_AND_ASSIGN:
+	case NODE_XOR_ASSIGN:
+	case NODE_OR_ASSIGN:
+		switch (node->type) {
+		case NODE_ADD_ASSIGN:	op = "+";	break;
+		case NODE_SUB_ASSIGN:	op = "-";	break;
+		case NODE_MUL_ASSIGN:	op = "*";	break;
+		case NODE_LSHFT_ASSIGN:	op = "<<";	is_shift = true;	break;
+		case NODE_RSHFT_ASSIGN:	op = ">>";	is_shift = true;	break;
+		case NODE_AND_ASSIGN:	op = "&";	break;
+		case NODE_XOR_ASSIGN:	op = "^";	break;
+		case NODE_OR_ASSIGN:	op = "|";	break;
+		default:				break;
+		}
+		r = get_vector_operand(node->right, rstr, ot, node->vec_len, !op[0]);
+		str = r ? malloc((2 * strlen(lstr)) + strlen(r) + 100) : NULL;
+		if (!str)
+			break;
+
+		// OpenCL Stores Split The Range Check Prefix From The Address
+		if (opt_opencl) {
+			addr = strrchr(lstr, '\n');
+			addr = addr ? addr + 1 : lstr;
+			while (*addr == '\t')
+				addr++;
+			if (!op[0])
+				sprintf(str, "%.*svstore%u(%s, 0, %s)", (int)(addr - lstr), lstr, node->vec_len, r, addr);
+			else
+				sprintf(str, "%.*svstore%u(vload%u(0, %s) %s %s%s%s, 0, %s)", (int)(addr - lstr), lstr, node->vec_len, node->vec_len, addr, op, is_shift ? "(" : "", r, is_shift ? " & 31)" : "", addr);
+		}
+		else {
+			sprintf(str, "%s %s= %s%s%s", lstr, op, is_shift ? "(" : "", r, is_shift ? " & 31)" : "");
+		}
+		break;
+
+	case NODE_ADD:
+	case NODE_SUB:
+	case NODE_MUL:
+	case NODE_BITWISE_AND:
+	case NODE_BITWISE_XOR:
+	case NODE_BITWISE_OR:
+	case NODE_LSHIFT:
+	case NODE_RSHIFT:
+	case NODE_EQ:
+	case NODE_NE:
+	case NODE_GT:
+	case NODE_LT:
+	case NODE_GE:
+	case NODE_LE:
+		switch (node->type) {
+		case NODE_ADD:			op = "+";	break;
+		case NODE_SUB:			op = "-";	break;
+		case NODE_MUL:			op = "*";	break;
+		case NODE_BITWISE_AND:	op = "&";	break;
+		case NODE_BITWISE_XOR:	op = "^";	break;
+		case NODE_BITWISE_OR:	op = "|";	break;
+		case NODE_LSHIFT:		op = "<<";	is_shift = true;	break;
+		case NODE_RSHIFT:		op = ">>";	is_shift = true;	break;
+		case NODE_EQ:			op = "==";	break;
+		case NODE_NE:			op = "!=";	break;
+		case NODE_GT:			op = ">";	break;
+		case NODE_LT:			op = "<";	break;
+		case NODE_GE:			op = ">=";	break;
+		default:				op = "<=";	break;
+		}
+		l = get_vector_operand(node->left, lstr, ot, node->vec_len, false);
+		r = get_vector_operand(node->right, rstr, ot, node->vec_len, false);
+		str = (l && r) ? malloc(strlen(l) + strlen(r) + 25) : NULL;
+		if (str)
+			sprintf(str, "(%s %s %s%s%s)", l, op, is_shift ? "(" : "", r, is_shift ? " & 31)" : "");
+		break;
+
+	case NODE_COMPL:
+	case NODE_NEG:
+		str = malloc(strlen(lstr) + 10);
+		if (str)
+			sprintf(str, "%s(%s)", (node->type == NODE_COMPL) ? "~" : "-", lstr);
+		break;
+
+	// Rotates Work On The Unsigned Bits Of Int Vectors
+	case NODE_LROT:
+	case NODE_RROT:
+		r = get_vector_operand(node->right, rstr, DT_UINT, node->vec_len, true);
+		str = r ? malloc(strlen(lstr) + strlen(r) + 100) : NULL;
+		if (!str)
+			break;
+		op = (node->type == NODE_LROT) ? "" : "-";
+		if (opt_opencl && (ot == DT_INT))
+			sprintf(str, "as_int%u(rotate(as_uint%u(%s), %s%s))", node->vec_len, node->vec_len, lstr, op, r);
+		else if (opt_opencl)
+			sprintf(str, "rotate(%s, %s%s)", lstr, op, r);
+		else if (ot == DT_INT)
+			sprintf(str, "((%s)%s(%s, (%s)(%s), %s))", vt, (node->type == NODE_LROT) ? "vrotl32" : "vrotr32", get_vector_type_name(DT_UINT, node->vec_len), get_vector_type_name(DT_UINT, node->vec_len), lstr, r);
+		else
+			sprintf(str, "%s(%s, %s, %s)", (node->type == NODE_LROT) ? "vrotl32" : "vrotr32", vt, lstr, r);
+		break;
+
+	// Built By get_node_inputs
+	case NODE_SELECT:
+		str = lstr;
+		lstr = NULL;
+		break;
+
+	default:
+		applog(LOG_ERR, "Compiler Error: Unsupported vector expression at Line: %d", node->line_num);
+		break;
+	}
+
+	if (l) free(l);
+	if (r) free(r);
+	if (lstr) free(lstr);
+	if (rstr) free(rstr);
+
+	if (!str)
+		return false;
+
+	return push_node_code(node, str);
+}
+
+// VM Array Holding A Variable
+static const char *get_array_name(ast *node) {
+	switch (node->data_type) {
+	case DT_UINT:	return node->is_vm_mem ? "m" : (node->is_vm_storage ? "s" : "u");
+	case DT_LONG:	return "l";
+	case DT_ULONG:	return "ul";
+	case DT_FLOAT:	return "f";
+	case DT_DOUBLE:	return "d";
+	default:		return "i";
+	}
+}
+
+// Table Initializer - Values Go Into A Constant Array Which Is Copied In One Step
+static char *convert_array_init(ast *node) {
+	uint64_t *values = (uint64_t *)node->svalue;
+	const char *name = get_array_name(node);
+	char *str, *p;
+	double dval;
+	int k, len;
+
+	str = malloc((size_t)node->ivalue * 30 + 300);
+	if (!str)
+		return NULL;
+
+	p = str;
+	p += sprintf(p, "do {\n%s\t%sconst %s init_%d[%ld] = {", tab[tabs], opt_opencl ? "" : "static ", get_type_name(node->data_type), node->token_num, node->ivalue);
+
+	for (k = 0; k < node->ivalue; k++) {
+		if ((k % 12) == 0)
+			p += sprintf(p, "\n%s\t\t", tab[tabs]);
+
+		switch (node->data_type) {
+		case DT_INT:	p += sprintf(p, "%d", (int32_t)values[k]);					break;
+		case DT_UINT:	p += sprintf(p, "%uU", (uint32_t)values[k]);				break;
+		case DT_LONG:	p += sprintf(p, "%lldLL", (long long)(int64_t)values[k]);	break;
+		case DT_ULONG:	p += sprintf(p, "0x%llxUL", (unsigned long long)values[k]);	break;
+		case DT_FLOAT:
+			memcpy(&dval, &values[k], sizeof(dval));
+			len = sprintf(p, "%.9g", dval);
+			if (strpbrk(p, ".e"))
+				len += sprintf(p + len, "f");
+			p += len;
+			break;
+		default:
+			memcpy(&dval, &values[k], sizeof(dval));
+			p += sprintf(p, "%.17g", dval);
+			break;
+		}
+
+		if (k < node->ivalue - 1)
+			p += sprintf(p, ", ");
+	}
+
+	if (opt_opencl)
+		sprintf(p, "\n%s\t};\n%s\tint k;\n%s\tfor (k = 0; k < %ld; k++)\n%s\t\t%s[%lu + k] = init_%d[k];\n%s} while (0)",
+			tab[tabs], tab[tabs], tab[tabs], node->ivalue, tab[tabs], name, node->uvalue, node->token_num, tab[tabs]);
+	else
+		sprintf(p, "\n%s\t};\n%s\tmemcpy(&%s[%lu], init_%d, sizeof(init_%d));\n%s} while (0)",
+			tab[tabs], tab[tabs], name, node->uvalue, node->token_num, node->token_num, tab[tabs]);
+
+	return str;
+}
+
+// C Type For A Data Type (OpenCL Kernels #define The Fixed Width Names)
+static const char *get_type_name(DATA_TYPE data_type) {
+	switch (data_type) {
+	case DT_UINT:	return "uint32_t";
+	case DT_LONG:	return "int64_t";
+	case DT_ULONG:	return "uint64_t";
+	case DT_FLOAT:	return "float";
+	case DT_DOUBLE:	return "double";
+	default:		return "int32_t";
+	}
+}
+
+// fill() Values Are Passed As Raw Bits In OpenCL, So Floats Are Reinterpreted There
+static const char *get_fill_cast(DATA_TYPE data_type) {
+	if (opt_opencl && (data_type == DT_FLOAT))
+		return "as_uint";
+	else if (opt_opencl && (data_type == DT_DOUBLE))
+		return "as_ulong";
+	else if (opt_opencl && (data_type == DT_INT))
+		return "(uint)";
+	else if (opt_opencl && (data_type == DT_LONG))
+		return "(ulong)";
+	else if (data_type == DT_INT)
+		return "(uint32_t)";
+	else if (data_type == DT_LONG)
+		return "(uint64_t)";
+	return "";
+}
+
 static void get_cast(char *lcast, char *rcast, DATA_TYPE ldata_type, DATA_TYPE rdata_type, bool right_only) {
 	lcast[0] = 0;
 	rcast[0] = 0;
@@ -999,6 +1642,10 @@ static bool get_node_inputs(ast* node, char **lstr, char **rstr) {
 	case NODE_FLOOR:
 	case NODE_ABS:
 	case NODE_FABS:
+	case NODE_POPCOUNT:
+	case NODE_CLZ:
+	case NODE_BSWAP32:
+	case NODE_KECCAK_F1600:
 		*lstr = pop_code();
 		if (!lstr) {
 			applog(LOG_ERR, "Compiler Error: Corupted code stack at Line: %d", node->line_num);
@@ -1041,6 +1688,11 @@ static bool get_node_inputs(ast* node, char **lstr, char **rstr) {
 	case NODE_ATAN2:
 	case NODE_FMOD:
 	case NODE_GCD:
+	case NODE_MULHI:
+	case NODE_MIN:
+	case NODE_MAX:
+	case NODE_SHA256_BLOCK:
+	case NODE_MD5_BLOCK:
 		*rstr = pop_code();
 		*lstr = pop_code();
 		if (!lstr || !rstr) {
@@ -1073,6 +1725,58 @@ static bool get_node_inputs(ast* node, char **lstr, char **rstr) {
 		if(tmp[3]) { free(tmp[3]); tmp[3]=NULL; }
 		break;
 
+	// copy(a[x], b[y], n) / fill(a[x], value, n) - Returned As "x, y, n" / "x, value, n"
+	case NODE_COPY:
+	case NODE_FILL:
+		tmp[0] = pop_code();
+		tmp[1] = pop_code();
+		tmp[2] = pop_code();
+		if (!tmp[0] || !tmp[1] || !tmp[2]) {
+			if(tmp[0]) { free(tmp[0]); tmp[0]=NULL; }
+			if(tmp[1]) { free(tmp[1]); tmp[1]=NULL; }
+			if(tmp[2]) { free(tmp[2]); tmp[2]=NULL; }
+			applog(LOG_ERR, "Compiler Error: Corupted code stack at Line: %d", node->line_num);
+			return false;
+		}
+		*lstr = malloc(strlen(tmp[0]) + strlen(tmp[1]) + strlen(tmp[2]) + 100);
+		if (node->type == NODE_COPY)
+			sprintf(*lstr, "(%s)(%s), (%s)(%s), (%s)(%s)", opt_opencl ? "ulong" : "uint64_t", tmp[2], opt_opencl ? "ulong" : "uint64_t", tmp[1], opt_opencl ? "ulong" : "uint64_t", tmp[0]);
+		else
+			sprintf(*lstr, "(%s)(%s), %s((%s)(%s)), (%s)(%s)", opt_opencl ? "ulong" : "uint64_t", tmp[2], get_fill_cast(node->right->left->data_type), get_type_name(node->right->left->data_type), tmp[1], opt_opencl ? "ulong" : "uint64_t", tmp[0]);
+		free(tmp[0]);
+		free(tmp[1]);
+		free(tmp[2]);
+		break;
+
+	// select(cond, a, b) - Both Values Are Cast To The Result Type, Returned As "(a) : (b)"
+	case NODE_SELECT:
+		tmp[0] = pop_code();
+		tmp[1] = pop_code();
+		tmp[2] = pop_code();
+		if (!tmp[0] || !tmp[1] || !tmp[2]) {
+			if(tmp[0]) { free(tmp[0]); tmp[0]=NULL; }
+			if(tmp[1]) { free(tmp[1]); tmp[1]=NULL; }
+			if(tmp[2]) { free(tmp[2]); tmp[2]=NULL; }
+			applog(LOG_ERR, "Compiler Error: Corupted code stack at Line: %d", node->line_num);
+			return false;
+		}
+		// Vector select() Is Built Here, The Whole Expression Is Returned In lstr
+		if (node->vec_len) {
+			*lstr = get_vector_select(node, tmp[2], tmp[1], tmp[0]);
+			free(tmp[0]);
+			free(tmp[1]);
+			free(tmp[2]);
+			if (!*lstr)
+				return false;
+			break;
+		}
+		*lstr = tmp[2];
+		*rstr = malloc(strlen(tmp[1]) + strlen(tmp[0]) + 50);
+		sprintf(*rstr, "(%s)(%s) : (%s)(%s)", get_type_name(node->data_type), tmp[1], get_type_name(node->data_type), tmp[0]);
+		free(tmp[0]);
+		free(tmp[1]);
+		break;
+
 	case NODE_ELSE:
 	case NODE_BLOCK:
 	case NODE_COND_ELSE:
@@ -0,0 +1,335 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Crypto Block Functions (sha256_block, md5_block, keccak_f1600)
+//
+// Each call runs exactly one compression / permutation in place on the VM
+// arrays.  Words are taken as-is from u[] / ul[] (SHA-256 message words are
+// the big endian W[0..15], MD5 words are the little endian X[0..15]) so no
+// byte swapping is done here.  Calls with a range outside of the array are
+// ignored, matching the way the generated code skips out of range stores.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "ElasticPLFunctions.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define USE_SHA_NI
+	#include <cpuid.h>
+	#include <immintrin.h>
+#endif
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint64_t keccak_rc[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+	0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+	0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+	0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+	0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+	0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const int keccak_rotc[24] = { 1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44 };
+static const int keccak_piln[24] = { 10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1 };
+
+#define ROTL32(x, n)	(((x) << (n)) | ((x) >> (32 - (n))))
+#define ROTR32(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTL64(x, n)	(((x) << (n)) | ((x) >> (64 - (n))))
+
+// True When [idx, idx + len) Fits In An Array Of 'size' Elements
+static bool block_in_range(uint32_t size, uint64_t idx, uint32_t len) {
+	return (size >= len) && (idx <= (uint64_t)(size - len));
+}
+
+/*****************************************************************************
+SHA-256
+******************************************************************************/
+
+static void sha256_compress_c(uint32_t *state, const uint32_t *block) {
+	uint32_t w[64], s[8], t1, t2;
+	int i;
+
+	for (i = 0; i < 16; i++)
+		w[i] = block[i];
+
+	for (i = 16; i < 64; i++)
+		w[i] = (ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10)) + w[i - 7] +
+			(ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 16];
+
+	for (i = 0; i < 8; i++)
+		s[i] = state[i];
+
+	for (i = 0; i < 64; i++) {
+		t1 = s[7] + (ROTR32(s[4], 6) ^ ROTR32(s[4], 11) ^ ROTR32(s[4], 25)) + ((s[4] & s[5]) ^ (~s[4] & s[6])) + sha256_k[i] + w[i];
+		t2 = (ROTR32(s[0], 2) ^ ROTR32(s[0], 13) ^ ROTR32(s[0], 22)) + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+		s[7] = s[6];
+		s[6] = s[5];
+		s[5] = s[4];
+		s[4] = s[3] + t1;
+		s[3] = s[2];
+		s[2] = s[1];
+		s[1] = s[0];
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8; i++)
+		state[i] += s[i];
+}
+
+#ifdef USE_SHA_NI
+
+// SHA Extensions Version - The Words Are Already In Host Order, So Unlike The
+// Usual Byte Stream Implementations There Is No Shuffle On Load
+__attribute__((target("sha,sse4.1")))
+static void sha256_compress_ni(uint32_t *state, const uint32_t *block) {
+	__m128i st0, st1, tmp, msg, abef, cdgh;
+	__m128i w[4];
+	int i;
+
+	tmp = _mm_loadu_si128((const __m128i *)&state[0]);
+	st1 = _mm_loadu_si128((const __m128i *)&state[4]);
+	tmp = _mm_shuffle_epi32(tmp, 0xB1);			// CDAB
+	st1 = _mm_shuffle_epi32(st1, 0x1B);			// EFGH
+	st0 = _mm_alignr_epi8(tmp, st1, 8);			// ABEF
+	st1 = _mm_blend_epi16(st1, tmp, 0xF0);		// CDGH
+
+	abef = st0;
+	cdgh = st1;
+
+	for (i = 0; i < 16; i++) {
+		if (i < 4)
+			w[i] = _mm_loadu_si128((const __m128i *)&block[i * 4]);
+		else
+			w[i & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]),
+				_mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4)), w[(i + 3) & 3]);
+
+		msg = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i *)&sha256_k[i * 4]));
+		st1 = _mm_sha256rnds2_epu32(st1, st0, msg);
+		msg = _mm_shuffle_epi32(msg, 0x0E);
+		st0 = _mm_sha256rnds2_epu32(st0, st1, msg);
+	}
+
+	st0 = _mm_add_epi32(st0, abef);
+	st1 = _mm_add_epi32(st1, cdgh);
+
+	tmp = _mm_shuffle_epi32(st0, 0x1B);			// FEBA
+	st1 = _mm_shuffle_epi32(st1, 0xB1);			// DCHG
+	st0 = _mm_blend_epi16(tmp, st1, 0xF0);		// DCBA
+	st1 = _mm_alignr_epi8(st1, tmp, 8);			// HGFE
+
+	_mm_storeu_si128((__m128i *)&state[0], st0);
+	_mm_storeu_si128((__m128i *)&state[4], st1);
+}
+
+static bool cpu_has_sha_ni() {
+	unsigned int eax, ebx, ecx, edx;
+
+	if (__get_cpuid_max(0, NULL) < 7)
+		return false;
+
+	// SSSE3 & SSE4.1 (Leaf 1 ECX Bits 9 & 19), SHA (Leaf 7 EBX Bit 29)
+	__cpuid(1, eax, ebx, ecx, edx);
+	if (!(ecx & (1 << 9)) || !(ecx & (1 << 19)))
+		return false;
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1 << 29)) != 0;
+}
+
+#endif
+
+typedef void(*SHA256_COMPRESS)(uint32_t *state, const uint32_t *block);
+
+// Picked On First Use (Every Thread Would Pick The Same One)
+static SHA256_COMPRESS sha256_compress = NULL;
+
+extern void sha256_block(uint32_t *u, uint32_t size, uint64_t dst, uint64_t src) {
+	uint32_t block[16];
+
+	if (!u || !block_in_range(size, dst, 8) || !block_in_range(size, src, 16))
+		return;
+
+	if (!sha256_compress) {
+#ifdef USE_SHA_NI
+		sha256_compress = cpu_has_sha_ni() ? sha256_compress_ni : sha256_compress_c;
+#else
+		sha256_compress = sha256_compress_c;
+#endif
+	}
+
+	// Block Is Copied First In Case It Overlaps The State
+	memcpy(block, &u[src], sizeof(block));
+	sha256_compress(&u[dst], block);
+}
+
+/*****************************************************************************
+MD5
+******************************************************************************/
+
+#define MD5_F(x, y, z)	((z) ^ ((x) & ((y) ^ (z))))
+#define MD5_G(x, y, z)	((y) ^ ((z) & ((x) ^ (y))))
+#define MD5_H(x, y, z)	((x) ^ (y) ^ (z))
+#define MD5_I(x, y, z)	((y) ^ ((x) | ~(z)))
+
+#define MD5_STEP(f, a, b, c, d, x, t, s) \
+	(a) += f((b), (c), (d)) + (x) + (t); \
+	(a) = ROTL32((a), (s)); \
+	(a) += (b);
+
+extern void md5_block(uint32_t *u, uint32_t size, uint64_t dst, uint64_t src) {
+	uint32_t a, b, c, d, x[16];
+
+	if (!u || !block_in_range(size, dst, 4) || !block_in_range(size, src, 16))
+		return;
+
+	memcpy(x, &u[src], sizeof(x));
+
+	a = u[dst];
+	b = u[dst + 1];
+	c = u[dst + 2];
+	d = u[dst + 3];
+
+	// Round 1
+	MD5_STEP(MD5_F, a, b, c, d, x[0], 0xd76aa478, 7)
+	MD5_STEP(MD5_F, d, a, b, c, x[1], 0xe8c7b756, 12)
+	MD5_STEP(MD5_F, c, d, a, b, x[2], 0x242070db, 17)
+	MD5_STEP(MD5_F, b, c, d, a, x[3], 0xc1bdceee, 22)
+	MD5_STEP(MD5_F, a, b, c, d, x[4], 0xf57c0faf, 7)
+	MD5_STEP(MD5_F, d, a, b, c, x[5], 0x4787c62a, 12)
+	MD5_STEP(MD5_F, c, d, a, b, x[6], 0xa8304613, 17)
+	MD5_STEP(MD5_F, b, c, d, a, x[7], 0xfd469501, 22)
+	MD5_STEP(MD5_F, a, b, c, d, x[8], 0x698098d8, 7)
+	MD5_STEP(MD5_F, d, a, b, c, x[9], 0x8b44f7af, 12)
+	MD5_STEP(MD5_F, c, d, a, b, x[10], 0xffff5bb1, 17)
+	MD5_STEP(MD5_F, b, c, d, a, x[11], 0x895cd7be, 22)
+	MD5_STEP(MD5_F, a, b, c, d, x[12], 0x6b901122, 7)
+	MD5_STEP(MD5_F, d, a, b, c, x[13], 0xfd987193, 12)
+	MD5_STEP(MD5_F, c, d, a, b, x[14], 0xa679438e, 17)
+	MD5_STEP(MD5_F, b, c, d, a, x[15], 0x49b40821, 22)
+
+	// Round 2
+	MD5_STEP(MD5_G, a, b, c, d, x[1], 0xf61e2562, 5)
+	MD5_STEP(MD5_G, d, a, b, c, x[6], 0xc040b340, 9)
+	MD5_STEP(MD5_G, c, d, a, b, x[11], 0x265e5a51, 14)
+	MD5_STEP(MD5_G, b, c, d, a, x[0], 0xe9b6c7aa, 20)
+	MD5_STEP(MD5_G, a, b, c, d, x[5], 0xd62f105d, 5)
+	MD5_STEP(MD5_G, d, a, b, c, x[10], 0x02441453, 9)
+	MD5_STEP(MD5_G, c, d, a, b, x[15], 0xd8a1e681, 14)
+	MD5_STEP(MD5_G, b, c, d, a, x[4], 0xe7d3fbc8, 20)
+	MD5_STEP(MD5_G, a, b, c, d, x[9], 0x21e1cde6, 5)
+	MD5_STEP(MD5_G, d, a, b, c, x[14], 0xc33707d6, 9)
+	MD5_STEP(MD5_G, c, d, a, b, x[3], 0xf4d50d87, 14)
+	MD5_STEP(MD5_G, b, c, d, a, x[8], 0x455a14ed, 20)
+	MD5_STEP(MD5_G, a, b, c, d, x[13], 0xa9e3e905, 5)
+	MD5_STEP(MD5_G, d, a, b, c, x[2], 0xfcefa3f8, 9)
+	MD5_STEP(MD5_G, c, d, a, b, x[7], 0x676f02d9, 14)
+	MD5_STEP(MD5_G, b, c, d, a, x[12], 0x8d2a4c8a, 20)
+
+	// Round 3
+	MD5_STEP(MD5_H, a, b, c, d, x[5], 0xfffa3942, 4)
+	MD5_STEP(MD5_H, d, a, b, c, x[8], 0x8771f681, 11)
+	MD5_STEP(MD5_H, c, d, a, b, x[11], 0x6d9d6122, 16)
+	MD5_STEP(MD5_H, b, c, d, a, x[14], 0xfde5380c, 23)
+	MD5_STEP(MD5_H, a, b, c, d, x[1], 0xa4beea44, 4)
+	MD5_STEP(MD5_H, d, a, b, c, x[4], 0x4bdecfa9, 11)
+	MD5_STEP(MD5_H, c, d, a, b, x[7], 0xf6bb4b60, 16)
+	MD5_STEP(MD5_H, b, c, d, a, x[10], 0xbebfbc70, 23)
+	MD5_STEP(MD5_H, a, b, c, d, x[13], 0x289b7ec6, 4)
+	MD5_STEP(MD5_H, d, a, b, c, x[0], 0xeaa127fa, 11)
+	MD5_STEP(MD5_H, c, d, a, b, x[3], 0xd4ef3085, 16)
+	MD5_STEP(MD5_H, b, c, d, a, x[6], 0x04881d05, 23)
+	MD5_STEP(MD5_H, a, b, c, d, x[9], 0xd9d4d039, 4)
+	MD5_STEP(MD5_H, d, a, b, c, x[12], 0xe6db99e5, 11)
+	MD5_STEP(MD5_H, c, d, a, b, x[15], 0x1fa27cf8, 16)
+	MD5_STEP(MD5_H, b, c, d, a, x[2], 0xc4ac5665, 23)
+
+	// Round 4
+	MD5_STEP(MD5_I, a, b, c, d, x[0], 0xf4292244, 6)
+	MD5_STEP(MD5_I, d, a, b, c, x[7], 0x432aff97, 10)
+	MD5_STEP(MD5_I, c, d, a, b, x[14], 0xab9423a7, 15)
+	MD5_STEP(MD5_I, b, c, d, a, x[5], 0xfc93a039, 21)
+	MD5_STEP(MD5_I, a, b, c, d, x[12], 0x655b59c3, 6)
+	MD5_STEP(MD5_I, d, a, b, c, x[3], 0x8f0ccc92, 10)
+	MD5_STEP(MD5_I, c, d, a, b, x[10], 0xffeff47d, 15)
+	MD5_STEP(MD5_I, b, c, d, a, x[1], 0x85845dd1, 21)
+	MD5_STEP(MD5_I, a, b, c, d, x[8], 0x6fa87e4f, 6)
+	MD5_STEP(MD5_I, d, a, b, c, x[15], 0xfe2ce6e0, 10)
+	MD5_STEP(MD5_I, c, d, a, b, x[6], 0xa3014314, 15)
+	MD5_STEP(MD5_I, b, c, d, a, x[13], 0x4e0811a1, 21)
+	MD5_STEP(MD5_I, a, b, c, d, x[4], 0xf7537e82, 6)
+	MD5_STEP(MD5_I, d, a, b, c, x[11], 0xbd3af235, 10)
+	MD5_STEP(MD5_I, c, d, a, b, x[2], 0x2ad7d2bb, 15)
+	MD5_STEP(MD5_I, b, c, d, a, x[9], 0xeb86d391, 21)
+
+	u[dst] += a;
+	u[dst + 1] += b;
+	u[dst + 2] += c;
+	u[dst + 3] += d;
+}
+
+/*****************************************************************************
+Keccak-f[1600]
+******************************************************************************/
+
+// A Single State Has Too Little Parallelism For AVX2 To Pay Off, So This Is
+// The Plain 64bit Version (Lanes Are ul[dst + x + 5y])
+extern void keccak_f1600(uint64_t *ul, uint32_t size, uint64_t dst) {
+	uint64_t *st, bc[5], t;
+	int i, j, r;
+
+	if (!ul || !block_in_range(size, dst, 25))
+		return;
+
+	st = &ul[dst];
+
+	for (r = 0; r < 24; r++) {
+
+		// Theta
+		for (i = 0; i < 5; i++)
+			bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+
+		for (i = 0; i < 5; i++) {
+			t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+			for (j = 0; j < 25; j += 5)
+				st[j + i] ^= t;
+		}
+
+		// Rho & Pi
+		t = st[1];
+		for (i = 0; i < 24; i++) {
+			j = keccak_piln[i];
+			bc[0] = st[j];
+			st[j] = ROTL64(t, keccak_rotc[i]);
+			t = bc[0];
+		}
+
+		// Chi
+		for (j = 0; j < 25; j += 5) {
+			for (i = 0; i < 5; i++)
+				bc[i] = st[j + i];
+			for (i = 0; i < 5; i++)
+				st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+		}
+
+		// Iota
+		st[0] ^= keccak_rc[r];
+	}
+}
@@ -19,4 +19,16 @@
 
 extern int32_t gcd(int32_t	a, int32_t b);
 
+// Crypto Block Functions - Update u[] / ul[] In Place, Out Of Range Calls Are Ignored
+extern void sha256_block(uint32_t *u, uint32_t size, uint64_t dst, uint64_t src);
+extern void md5_block(uint32_t *u, uint32_t size, uint64_t dst, uint64_t src);
+extern void keccak_f1600(uint64_t *ul, uint32_t size, uint64_t dst);
+
+// Array Functions - One Range Check Per Call, Out Of Range Calls Are Ignored
+extern void array_copy(void *dst_arr, uint32_t dst_size, const void *src_arr, uint32_t src_size, uint32_t elem_size, uint64_t dst, uint64_t src, uint64_t n);
+extern void array_fill32(uint32_t *arr, uint32_t size, uint64_t dst, uint32_t value, uint64_t n);
+extern void array_fill64(uint64_t *arr, uint32_t size, uint64_t dst, uint64_t value, uint64_t n);
+extern void array_fillf(float *arr, uint32_t size, uint64_t dst, float value, uint64_t n);
+extern void array_filld(double *arr, uint32_t size, uint64_t dst, double value, uint64_t n);
+
 #endif // ELASTICPLFUNCTIONS_H_
\ No newline at end of file
@@ -214,6 +214,20 @@ static uint64_t calc_function_weight(ast* root, uint32_t *ast_depth) {
 	return total_weight;
 }
 
+// copy() / fill() Cost One Unit Per Element - Counts Only Known At Runtime Are Charged For The Whole Array
+static uint64_t get_range_weight(ast* node) {
+	ast *ref = node->right->left;
+	ast *cnt = node->right->right->right->left;
+	uint64_t n = get_array_size(ref);
+
+	if ((cnt->type == NODE_CONSTANT) && ((uint64_t)cnt->ivalue < n))
+		n = (uint64_t)cnt->ivalue;
+	if (!n)
+		n = 1;
+
+	return overflow_safe_mul(ref->is_64bit ? 2 : 1, n);
+}
+
 static uint64_t get_node_weight(ast* node) {
 	uint64_t weight = 1;
 
@@ -224,6 +238,11 @@ static uint64_t get_node_weight(ast* node) {
 	if (node->is_64bit)
 		weight = 2;
 
+	// Vector Operations Cost Half A Scalar Operation Per Lane (One SIMD Instruction On
+	// Most CPUs, But Targets Without SIMD Run The Lanes One At A Time)
+	if (node->vec_len)
+		weight = node->vec_len / 2;
+
 	switch (node->type) {
 		case NODE_IF:
 		case NODE_ELSE:
@@ -304,6 +323,36 @@ static uint64_t get_node_weight(ast* node) {
 		case NODE_FABS:
 			return weight * 2;
 
+		// Bit Functions (Weight x 2, mulhi Weight x 3 Like A Multiply)
+		case NODE_POPCOUNT:
+		case NODE_CLZ:
+		case NODE_BSWAP32:
+		case NODE_MIN:
+		case NODE_MAX:
+		case NODE_SELECT:
+			return weight * 2;
+
+		case NODE_MULHI:
+			return weight * 3;
+
+		// Crypto Block Functions (Fixed Weight Per Compression / Permutation)
+		case NODE_MD5_BLOCK:
+			return 160;
+
+		case NODE_SHA256_BLOCK:
+			return 256;
+
+		case NODE_KECCAK_F1600:
+			return 480;
+
+		// Array Functions (Weight Per Element, Whole Array When The Count Is Not Constant)
+		case NODE_COPY:
+		case NODE_FILL:
+			return get_range_weight(node);
+
+		case NODE_ARRAY_INIT:
+			return weight * (uint64_t)node->ivalue;
+
 		// Medium Functions (Weight x 4)
 		case NODE_SIN:
 		case NODE_COS:
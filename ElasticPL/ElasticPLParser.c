@@ -16,7 +16,7 @@
 
 int num_exp = 0;
 
-static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool is_vm_storage, int64_t val_int64, uint64_t val_uint64, double val_double, unsigned char *svalue, int token_num, int line_num, DATA_TYPE data_type, ast* left, ast* right) {
+static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool is_vm_storage, bool is_vm_const, int64_t val_int64, uint64_t val_uint64, double val_double, unsigned char *svalue, int token_num, int line_num, DATA_TYPE data_type, ast* left, ast* right) {
 	DATA_TYPE dt_l, dt_r;
 	ast* e = calloc(1, sizeof(ast));
 
@@ -25,6 +25,7 @@ static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool
 		e->exp = exp_type;
 		e->is_vm_mem = is_vm_mem;
 		e->is_vm_storage = is_vm_storage;
+		e->is_vm_const = is_vm_const;
 		e->ivalue = val_int64;
 		e->uvalue = val_uint64;
 		e->fvalue = val_double;
@@ -37,63 +38,13 @@ static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool
 		e->right = right;
 
 		// ElasticPL Operator Nodes Inherit Data Type From Child Nodes
-		// Precedence Is Based On C99 Standard:
-		// double <- float <- uint64_t <- int64_t <- uint32_t <- int32_t
 		if ((data_type != DT_NONE) && (node_type != NODE_VAR_CONST) && (node_type != NODE_VAR_EXP) && (node_type != NODE_CONSTANT)) {
 			dt_l = left ? left->data_type : DT_NONE;
 			dt_r = right ? right->data_type : DT_NONE;
-
-			if ((dt_l == DT_DOUBLE) || (dt_r == DT_DOUBLE))
-				e->data_type = DT_DOUBLE;
-			else if ((dt_l == DT_FLOAT) || (dt_r == DT_FLOAT))
-				e->data_type = DT_FLOAT;
-			else if ((dt_l == DT_ULONG) || (dt_r == DT_ULONG))
-				e->data_type = DT_ULONG;
-			else if ((dt_l == DT_LONG) || (dt_r == DT_LONG))
-				e->data_type = DT_LONG;
-			else if ((dt_l == DT_UINT) || (dt_r == DT_UINT))
-				e->data_type = DT_UINT;
-			else
-				e->data_type = DT_INT;
+			data_type = get_promoted_type(dt_l, dt_r);
 		}
 
-		// Set Indicators Based On Data Type
-		switch (e->data_type) {
-		case DT_INT:
-			e->is_64bit = false;
-			e->is_signed = true;
-			e->is_float = false;
-			break;
-		case DT_UINT:
-			e->is_64bit = false;
-			e->is_signed = false;
-			e->is_float = false;
-			break;
-		case DT_LONG:
-			e->is_64bit = true;
-			e->is_signed = true;
-			e->is_float = false;
-			break;
-		case DT_ULONG:
-			e->is_64bit = true;
-			e->is_signed = false;
-			e->is_float = false;
-			break;
-		case DT_FLOAT:
-			e->is_64bit = false;
-			e->is_signed = true;
-			e->is_float = true;
-			break;
-		case DT_DOUBLE:
-			e->is_64bit = true;
-			e->is_signed = true;
-			e->is_float = true;
-			break;
-		default:
-			e->is_64bit = false;
-			e->is_signed = false;
-			e->is_float = false;
-		}
+		set_data_type(e, data_type);
 
 		if (left)
 			e->left->parent = e;
@@ -103,6 +54,105 @@ static ast* add_exp(NODE_TYPE node_type, EXP_TYPE exp_type, bool is_vm_mem, bool
 	return e;
 }
 
+// Precedence Is Based On C99 Standard:
+// double <- float <- uint64_t <- int64_t <- uint32_t <- int32_t
+static DATA_TYPE get_promoted_type(DATA_TYPE dt_l, DATA_TYPE dt_r) {
+	if ((dt_l == DT_DOUBLE) || (dt_r == DT_DOUBLE))
+		return DT_DOUBLE;
+	else if ((dt_l == DT_FLOAT) || (dt_r == DT_FLOAT))
+		return DT_FLOAT;
+	else if ((dt_l == DT_ULONG) || (dt_r == DT_ULONG))
+		return DT_ULONG;
+	else if ((dt_l == DT_LONG) || (dt_r == DT_LONG))
+		return DT_LONG;
+	else if ((dt_l == DT_UINT) || (dt_r == DT_UINT))
+		return DT_UINT;
+	else
+		return DT_INT;
+}
+
+// Set Data Type & Indicators Based On Data Type
+static void set_data_type(ast *e, DATA_TYPE data_type) {
+	e->data_type = data_type;
+
+	switch (data_type) {
+	case DT_INT:
+		e->is_64bit = false;
+		e->is_signed = true;
+		e->is_float = false;
+		break;
+	case DT_UINT:
+		e->is_64bit = false;
+		e->is_signed = false;
+		e->is_float = false;
+		break;
+	case DT_LONG:
+		e->is_64bit = true;
+		e->is_signed = true;
+		e->is_float = false;
+		break;
+	case DT_ULONG:
+		e->is_64bit = true;
+		e->is_signed = false;
+		e->is_float = false;
+		break;
+	case DT_FLOAT:
+		e->is_64bit = false;
+		e->is_signed = true;
+		e->is_float = true;
+		break;
+	case DT_DOUBLE:
+		e->is_64bit = true;
+		e->is_signed = true;
+		e->is_float = true;
+		break;
+	default:
+		e->is_64bit = false;
+		e->is_signed = false;
+		e->is_float = false;
+	}
+}
+
+// Positive Literals Are Parsed As Unsigned, But Compare Like The Signed Literal The C Code Contains
+static DATA_TYPE get_arg_type(ast *arg) {
+	if ((arg->type == NODE_CONSTANT) && !arg->is_float && !arg->is_signed) {
+		if (arg->uvalue <= INT32_MAX)
+			return DT_INT;
+		else if (arg->uvalue <= INT64_MAX)
+			return DT_LONG;
+	}
+	return arg->data_type;
+}
+
+// Bit Functions Return A Type Based On Their Arguments (Other Built-ins Are Left As Is)
+static void set_function_type(ast *e) {
+	ast *arg1 = (e->right) ? e->right->left : NULL;
+	ast *arg2 = (e->right && e->right->right) ? e->right->right->left : NULL;
+	ast *arg3 = (e->right && e->right->right && e->right->right->right) ? e->right->right->right->left : NULL;
+
+	switch (e->type) {
+	case NODE_POPCOUNT:
+	case NODE_CLZ:
+	case NODE_BSWAP32:
+		set_data_type(e, DT_UINT);
+		break;
+	case NODE_MULHI:
+		set_data_type(e, DT_ULONG);
+		break;
+	case NODE_MIN:
+	case NODE_MAX:
+		if (arg1 && arg2)
+			set_data_type(e, get_promoted_type(get_arg_type(arg1), get_arg_type(arg2)));
+		break;
+	case NODE_SELECT:
+		if (arg2 && arg3)
+			set_data_type(e, get_promoted_type(get_arg_type(arg2), get_arg_type(arg3)));
+		break;
+	default:
+		break;
+	}
+}
+
 static void push_op(int token_id) {
 	stack_op[++stack_op_idx] = token_id;
 	top_op = token_id;
@@ -142,7 +192,213 @@ static ast* pop_exp() {
 	return exp;
 }
 
+// Crypto Blocks Start At A Variable Of u[] (ul[] For keccak_f1600), Constant Indexes Are Range Checked Here
+static bool validate_block_arg(SOURCE_TOKEN *token, NODE_TYPE node_type, ast *ref, uint32_t len, DATA_TYPE data_type) {
+	uint32_t size;
+
+	if (((ref->type != NODE_VAR_CONST) && (ref->type != NODE_VAR_EXP)) || (ref->data_type != data_type) ||
+		ref->is_vm_mem || ref->is_vm_storage || ref->is_vm_const) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid inputs for '%s'", token->line_num, get_node_str(node_type));
+		return false;
+	}
+
+	size = get_array_size(ref);
+
+	if ((ref->type == NODE_VAR_CONST) && ((size < len) || (ref->uvalue > (uint64_t)(size - len)))) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - '%s' block of %d elements is out of bounds", token->line_num, get_node_str(node_type), len);
+		return false;
+	}
+
+	return true;
+}
+
+// copy() / fill() Ranges Start At A Variable Of i[], u[], l[], ul[], f[] Or d[] & Must Fit In That Array
+static bool validate_array_ref(SOURCE_TOKEN *token, NODE_TYPE node_type, ast *ref, ast *n) {
+	uint32_t size;
+
+	if (((ref->type != NODE_VAR_CONST) && (ref->type != NODE_VAR_EXP)) || ref->is_vm_mem || ref->is_vm_storage || ref->is_vm_const ||
+		(n->data_type == DT_NONE) || n->is_float) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid inputs for '%s'", token->line_num, get_node_str(node_type));
+		return false;
+	}
+
+	size = get_array_size(ref);
+
+	if ((n->type == NODE_CONSTANT) && ((n->is_signed && (n->ivalue < 0)) || (n->uvalue > size) ||
+		((ref->type == NODE_VAR_CONST) && (ref->uvalue > (uint64_t)(size - n->uvalue))))) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - '%s' range is out of bounds", token->line_num, get_node_str(node_type));
+		return false;
+	}
+
+	return true;
+}
+
+// Short Vector Variables (i4[], u8[], f4[], ...) - Number Of Lanes & Element Type
+static uint32_t get_vector_lanes(DATA_TYPE data_type, DATA_TYPE *elem_type) {
+	switch (data_type) {
+	case DT_INT_V4:		*elem_type = DT_INT;	return 4;
+	case DT_INT_V8:		*elem_type = DT_INT;	return 8;
+	case DT_UINT_V4:	*elem_type = DT_UINT;	return 4;
+	case DT_UINT_V8:	*elem_type = DT_UINT;	return 8;
+	case DT_FLOAT_V4:	*elem_type = DT_FLOAT;	return 4;
+	case DT_FLOAT_V8:	*elem_type = DT_FLOAT;	return 8;
+	default:			*elem_type = data_type;	return 0;
+	}
+}
+
+static bool has_side_effects(ast *e) {
+	if (!e)
+		return false;
+
+	switch (e->type) {
+	case NODE_ASSIGN:
+	case NODE_ADD_ASSIGN:
+	case NODE_SUB_ASSIGN:
+	case NODE_MUL_ASSIGN:
+	case NODE_DIV_ASSIGN:
+	case NODE_MOD_ASSIGN:
+	case NODE_LSHFT_ASSIGN:
+	case NODE_RSHFT_ASSIGN:
+	case NODE_AND_ASSIGN:
+	case NODE_XOR_ASSIGN:
+	case NODE_OR_ASSIGN:
+	case NODE_INCREMENT_R:
+	case NODE_INCREMENT_L:
+	case NODE_DECREMENT_R:
+	case NODE_DECREMENT_L:
+	case NODE_CALL_FUNCTION:
+	case NODE_VERIFY_BTY:
+	case NODE_VERIFY_POW:
+	case NODE_SHA256_BLOCK:
+	case NODE_MD5_BLOCK:
+	case NODE_KECCAK_F1600:
+	case NODE_COPY:
+	case NODE_FILL:
+		return true;
+	default:
+		return has_side_effects(e->left) || has_side_effects(e->right);
+	}
+}
+
+// Vector Values Are Only Allowed In Element-wise Operators, select() & Assignments To Vector Variables.
+// All Vector Operands Must Have The Same Number Of Lanes, Scalar Operands Are Converted To The Element
+// Type.  Side Effects Are Rejected Because The Range Checked Index And OpenCL's vload / vstore Pair
+// Evaluate The Index Expression More Than Once.
+static bool validate_vector_exp(SOURCE_TOKEN *token, ast *e, uint32_t var_lanes) {
+	ast *arg[4] = { NULL, NULL, NULL, NULL }, *p;
+	uint32_t lanes = 0;
+	int i, num = 0;
+
+	if ((e->type == NODE_VAR_CONST) || (e->type == NODE_VAR_EXP)) {
+		if (e->left && e->left->vec_len) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector value used as array index", token->line_num);
+			return false;
+		}
+		if (var_lanes && has_side_effects(e->left)) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector index can not contain assignments, increments or function calls", token->line_num);
+			return false;
+		}
+		e->vec_len = var_lanes;
+		return true;
+	}
+
+	// Other Than Assignments, Statements Only Take Values In Their Condition / Iteration Count
+	if ((e->exp == EXP_STATEMENT) && (e->type != NODE_ASSIGN) && ((e->type < NODE_ADD_ASSIGN) || (e->type > NODE_OR_ASSIGN))) {
+		if (((e->type == NODE_IF) || (e->type == NODE_REPEAT)) && e->left && e->left->vec_len) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector values can not be used with '%s'", token->line_num, get_node_str(e->type));
+			return false;
+		}
+		return true;
+	}
+
+	if (e->exp == EXP_FUNCTION) {
+		for (p = e->right; p && (num < 4); p = p->right)
+			arg[num++] = p->left;
+	}
+	else {
+		arg[num++] = e->left;
+		arg[num++] = e->right;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (!arg[i] || !arg[i]->vec_len)
+			continue;
+		if (lanes && (lanes != arg[i]->vec_len)) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector sizes do not match", token->line_num);
+			return false;
+		}
+		lanes = arg[i]->vec_len;
+	}
+
+	if (!lanes)
+		return true;
+
+	switch (e->type) {
+	case NODE_ASSIGN:
+	case NODE_ADD_ASSIGN:
+	case NODE_SUB_ASSIGN:
+	case NODE_MUL_ASSIGN:
+	case NODE_LSHFT_ASSIGN:
+	case NODE_RSHFT_ASSIGN:
+	case NODE_AND_ASSIGN:
+	case NODE_XOR_ASSIGN:
+	case NODE_OR_ASSIGN:
+	case NODE_LSHIFT:
+	case NODE_RSHIFT:
+	case NODE_LROT:
+	case NODE_RROT:
+		if (!e->left->vec_len) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Left operand of vector '%s' must be a vector", token->line_num, get_node_str(e->type));
+			return false;
+		}
+		set_data_type(e, e->left->data_type);
+		break;
+	case NODE_EQ:
+	case NODE_NE:
+	case NODE_GT:
+	case NODE_LT:
+	case NODE_GE:
+	case NODE_LE:
+		set_data_type(e, DT_INT);
+		break;
+	case NODE_ADD:
+	case NODE_SUB:
+	case NODE_MUL:
+	case NODE_BITWISE_AND:
+	case NODE_BITWISE_XOR:
+	case NODE_BITWISE_OR:
+		set_data_type(e, get_promoted_type(e->left->vec_len ? e->left->data_type : e->right->data_type, e->right->vec_len ? e->right->data_type : e->left->data_type));
+		break;
+	case NODE_COMPL:
+	case NODE_NEG:
+		break;
+	case NODE_SELECT:
+		if (arg[1]->vec_len || arg[2]->vec_len)
+			set_data_type(e, get_promoted_type(arg[1]->vec_len ? arg[1]->data_type : arg[2]->data_type, arg[2]->vec_len ? arg[2]->data_type : arg[1]->data_type));
+		else if (e->is_64bit) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector 'select' values must be 32bit", token->line_num);
+			return false;
+		}
+		break;
+	default:
+		applog(LOG_ERR, "Syntax Error: Line: %d - Vector values can not be used with '%s'", token->line_num, get_node_str(e->type));
+		return false;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (has_side_effects(arg[i])) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Vector expressions can not contain assignments, increments or function calls", token->line_num);
+			return false;
+		}
+	}
+
+	e->vec_len = lanes;
+	return true;
+}
+
 static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_type) {
+	DATA_TYPE elem_type;
+	uint32_t lanes, size;
 
 	if ((token->inputs == 0) || (node_type == NODE_BLOCK))
 		return true;
@@ -352,6 +608,43 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 					return false;
 				}
 				break;
+			case DT_UINT_C: // cu[]
+				if (ast_const_uints == 0) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Constant Unsigned Int array not declared", token->line_num);
+					return false;
+				}
+				else if ((node_type == NODE_VAR_CONST) && (stack_exp[stack_exp_idx]->uvalue >= ast_const_uints)) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Array index out of bounds", token->line_num);
+					return false;
+				}
+				break;
+			case DT_DOUBLE_C: // cd[]
+				if (ast_const_doubles == 0) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Constant Double array not declared", token->line_num);
+					return false;
+				}
+				else if ((node_type == NODE_VAR_CONST) && (stack_exp[stack_exp_idx]->uvalue >= ast_const_doubles)) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Array index out of bounds", token->line_num);
+					return false;
+				}
+				break;
+			case DT_INT_V4: // i4[] / i8[] / u4[] / u8[] / f4[] / f8[]
+			case DT_INT_V8:
+			case DT_UINT_V4:
+			case DT_UINT_V8:
+			case DT_FLOAT_V4:
+			case DT_FLOAT_V8:
+				lanes = get_vector_lanes(token->data_type, &elem_type);
+				size = (elem_type == DT_INT) ? ast_vm_ints : ((elem_type == DT_UINT) ? ast_vm_uints : ast_vm_floats);
+				if (size < lanes) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Array not declared or smaller than vector", token->line_num);
+					return false;
+				}
+				else if ((node_type == NODE_VAR_CONST) && (stack_exp[stack_exp_idx]->uvalue > (size - lanes))) {
+					applog(LOG_ERR, "Syntax Error: Line: %d - Array index out of bounds", token->line_num);
+					return false;
+				}
+				break;
 			}
 			return true;
 		}
@@ -401,6 +694,8 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 		if ((stack_exp_idx > 2) &&
 			(stack_exp[stack_exp_idx - 3]->type == NODE_VAR_CONST) &&
 			(stack_exp[stack_exp_idx - 3]->data_type == DT_UINT) &&
+			(!stack_exp[stack_exp_idx - 3]->is_vm_const) &&
+			(!stack_exp[stack_exp_idx - 3]->vec_len) &&
 			((stack_exp[stack_exp_idx - 2]->type == NODE_VAR_CONST) || (stack_exp[stack_exp_idx - 2]->type == NODE_VAR_EXP) || (stack_exp[stack_exp_idx - 2]->type == NODE_CONSTANT)) &&
 			(stack_exp[stack_exp_idx - 2]->data_type == DT_UINT) &&
 			(stack_exp[stack_exp_idx - 1]->type == NODE_CONSTANT) &&
@@ -435,8 +730,8 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 	// Expressions w/ 1 Variable (Left Operand)
 	case NODE_INCREMENT_R:
 	case NODE_DECREMENT_R:
-		if (stack_exp[stack_exp_idx]->is_vm_mem || stack_exp[stack_exp_idx]->is_vm_storage) {
-			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s array", token->line_num);
+		if (stack_exp[stack_exp_idx]->is_vm_mem || stack_exp[stack_exp_idx]->is_vm_storage || stack_exp[stack_exp_idx]->is_vm_const) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s/cu/cd array", token->line_num);
 			return false;
 		}
 
@@ -448,8 +743,8 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 	// Expressions w/ 1 Variable (Right Operand)
 	case NODE_INCREMENT_L:
 	case NODE_DECREMENT_L:
-		if (stack_exp[stack_exp_idx]->is_vm_mem || stack_exp[stack_exp_idx]->is_vm_storage) {
-			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s array", token->line_num);
+		if (stack_exp[stack_exp_idx]->is_vm_mem || stack_exp[stack_exp_idx]->is_vm_storage || stack_exp[stack_exp_idx]->is_vm_const) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s/cu/cd array", token->line_num);
 			return false;
 		}
 
@@ -464,8 +759,8 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 	case NODE_SUB_ASSIGN:
 	case NODE_MUL_ASSIGN:
 	case NODE_DIV_ASSIGN:
-		if (stack_exp[stack_exp_idx - 1]->is_vm_mem || stack_exp[stack_exp_idx - 1]->is_vm_storage) {
-			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s array", token->line_num);
+		if (stack_exp[stack_exp_idx - 1]->is_vm_mem || stack_exp[stack_exp_idx - 1]->is_vm_storage || stack_exp[stack_exp_idx - 1]->is_vm_const) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s/cu/cd array", token->line_num);
 			return false;
 		}
 
@@ -482,8 +777,8 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 	case NODE_AND_ASSIGN:
 	case NODE_XOR_ASSIGN:
 	case NODE_OR_ASSIGN:
-		if (stack_exp[stack_exp_idx - 1]->is_vm_mem || stack_exp[stack_exp_idx - 1]->is_vm_storage) {
-			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s array", token->line_num);
+		if (stack_exp[stack_exp_idx - 1]->is_vm_mem || stack_exp[stack_exp_idx - 1]->is_vm_storage || stack_exp[stack_exp_idx - 1]->is_vm_const) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Illegal assignment to m/s/cu/cd array", token->line_num);
 			return false;
 		}
 
@@ -576,12 +871,75 @@ static bool validate_inputs(SOURCE_TOKEN *token, int token_num, NODE_TYPE node_t
 	case NODE_POW:
 	case NODE_FMOD:
 	case NODE_GCD:
+	case NODE_MIN:
+	case NODE_MAX:
 		if (((stack_exp[stack_exp_idx - 1]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num)) &&
 			((stack_exp[stack_exp_idx - 1]->data_type != DT_NONE)) &&
 			(stack_exp[stack_exp_idx]->data_type != DT_NONE))
 			return true;
 		break;
 
+	// Built-in Functions w/ 1 Int/Uint/Long/Ulong
+	case NODE_POPCOUNT:
+	case NODE_CLZ:
+	case NODE_BSWAP32:
+		if ((stack_exp[stack_exp_idx]->token_num > token_num) &&
+			(stack_exp[stack_exp_idx]->data_type != DT_NONE) &&
+			(!stack_exp[stack_exp_idx]->is_float))
+			return true;
+		break;
+
+	// Built-in Functions w/ 2 Ints/Uints/Longs/Ulongs
+	case NODE_MULHI:
+		if (((stack_exp[stack_exp_idx - 1]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num)) &&
+			(stack_exp[stack_exp_idx - 1]->data_type != DT_NONE) &&
+			(!stack_exp[stack_exp_idx - 1]->is_float) &&
+			(stack_exp[stack_exp_idx]->data_type != DT_NONE) &&
+			(!stack_exp[stack_exp_idx]->is_float))
+			return true;
+		break;
+
+	// Crypto Block Functions w/ A State & A Message Block Variable
+	case NODE_SHA256_BLOCK:
+	case NODE_MD5_BLOCK:
+		if ((stack_exp[stack_exp_idx - 1]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num))
+			return validate_block_arg(token, node_type, stack_exp[stack_exp_idx - 1], (node_type == NODE_SHA256_BLOCK) ? 8 : 4, DT_UINT) &&
+				validate_block_arg(token, node_type, stack_exp[stack_exp_idx], 16, DT_UINT);
+		break;
+
+	case NODE_KECCAK_F1600:
+		if (stack_exp[stack_exp_idx]->token_num > token_num)
+			return validate_block_arg(token, node_type, stack_exp[stack_exp_idx], 25, DT_ULONG);
+		break;
+
+	// Array Functions w/ 2 Variables Of The Same Type & A Length
+	case NODE_COPY:
+		if ((stack_exp[stack_exp_idx - 2]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num)) {
+			if (stack_exp[stack_exp_idx - 2]->data_type != stack_exp[stack_exp_idx - 1]->data_type) {
+				applog(LOG_ERR, "Syntax Error: Line: %d - 'copy' requires two arrays of the same type", token->line_num);
+				return false;
+			}
+			return validate_array_ref(token, node_type, stack_exp[stack_exp_idx - 2], stack_exp[stack_exp_idx]) &&
+				validate_array_ref(token, node_type, stack_exp[stack_exp_idx - 1], stack_exp[stack_exp_idx]);
+		}
+		break;
+
+	// Array Functions w/ 1 Variable, A Value & A Length
+	case NODE_FILL:
+		if ((stack_exp[stack_exp_idx - 2]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num) &&
+			(stack_exp[stack_exp_idx - 1]->data_type != DT_NONE))
+			return validate_array_ref(token, node_type, stack_exp[stack_exp_idx - 2], stack_exp[stack_exp_idx]);
+		break;
+
+	// Built-in Functions w/ 3 Numbers
+	case NODE_SELECT:
+		if ((stack_exp[stack_exp_idx - 2]->token_num > token_num) && (stack_exp[stack_exp_idx]->token_num > token_num) &&
+			(stack_exp[stack_exp_idx - 2]->data_type != DT_NONE) &&
+			(stack_exp[stack_exp_idx - 1]->data_type != DT_NONE) &&
+			(stack_exp[stack_exp_idx]->data_type != DT_NONE))
+			return true;
+		break;
+
 	default:
 		break;
 	}
@@ -678,6 +1036,18 @@ static NODE_TYPE get_node_type(SOURCE_TOKEN *token, int token_num) {
 	case TOKEN_FABS:			node_type = NODE_FABS;			break;
 	case TOKEN_FMOD:			node_type = NODE_FMOD; 			break;
 	case TOKEN_GCD:				node_type = NODE_GCD; 			break;
+	case TOKEN_POPCOUNT:		node_type = NODE_POPCOUNT;		break;
+	case TOKEN_CLZ:				node_type = NODE_CLZ;			break;
+	case TOKEN_BSWAP32:			node_type = NODE_BSWAP32;		break;
+	case TOKEN_MULHI:			node_type = NODE_MULHI;			break;
+	case TOKEN_MIN:				node_type = NODE_MIN;			break;
+	case TOKEN_MAX:				node_type = NODE_MAX;			break;
+	case TOKEN_SELECT:			node_type = NODE_SELECT;		break;
+	case TOKEN_SHA256_BLOCK:	node_type = NODE_SHA256_BLOCK;	break;
+	case TOKEN_MD5_BLOCK:		node_type = NODE_MD5_BLOCK;		break;
+	case TOKEN_KECCAK_F1600:	node_type = NODE_KECCAK_F1600;	break;
+	case TOKEN_COPY:			node_type = NODE_COPY;			break;
+	case TOKEN_FILL:			node_type = NODE_FILL;			break;
 	case TOKEN_ARRAY_INT:		node_type = NODE_ARRAY_INT; 	break;
 	case TOKEN_ARRAY_UINT:		node_type = NODE_ARRAY_UINT; 	break;
 	case TOKEN_ARRAY_LONG:		node_type = NODE_ARRAY_LONG; 	break;
@@ -702,6 +1072,8 @@ static bool create_exp(SOURCE_TOKEN *token, int token_num) {
 	bool is_signed = false;
 	bool is_vm_mem = false;
 	bool is_vm_storage = false;
+	bool is_vm_const = false;
+	uint32_t vec_len = 0;
 	int64_t val_int64 = 0;
 	uint64_t val_uint64 = 0;
 	double val_double = 0.0;
@@ -864,6 +1236,16 @@ static bool create_exp(SOURCE_TOKEN *token, int token_num) {
 				data_type = DT_UINT;
 			}
 
+			// Set Indicator For cu[] / cd[] Arrays
+			if (((node_type == NODE_VAR_CONST) || (node_type == NODE_VAR_EXP)) && ((token->data_type == DT_UINT_C) || (token->data_type == DT_DOUBLE_C))) {
+				is_vm_const = true;
+				data_type = (token->data_type == DT_UINT_C) ? DT_UINT : DT_DOUBLE;
+			}
+
+			// Vector Variables Use The Element Type
+			if ((node_type == NODE_VAR_CONST) || (node_type == NODE_VAR_EXP))
+				vec_len = get_vector_lanes(data_type, &data_type);
+
 		}
 		// Binary Expressions
 		else if (token->inputs == 2) {
@@ -929,14 +1311,14 @@ static bool create_exp(SOURCE_TOKEN *token, int token_num) {
 		if (token->inputs > 0) {
 			// First Paramater
 			left = pop_exp();
-			exp = add_exp(NODE_PARAM, EXP_EXPRESSION, false, false, 0, 0, 0.0, NULL, 0, 0, DT_NONE, left, NULL);
+			exp = add_exp(NODE_PARAM, EXP_EXPRESSION, false, false, false, 0, 0, 0.0, NULL, 0, 0, DT_NONE, left, NULL);
 			push_exp(exp);
 
 			// Remaining Paramaters
 			for (i = 1; i < token->inputs; i++) {
 				right = pop_exp();
 				left = pop_exp();
-				exp = add_exp(NODE_PARAM, EXP_EXPRESSION, false, false, 0, 0, 0.0, NULL, 0, 0, DT_NONE, left, right);
+				exp = add_exp(NODE_PARAM, EXP_EXPRESSION, false, false, false, 0, 0, 0.0, NULL, 0, 0, DT_NONE, left, right);
 				push_exp(exp);
 			}
 			left = NULL;
@@ -948,11 +1330,19 @@ static bool create_exp(SOURCE_TOKEN *token, int token_num) {
 		}
 	}
 
-	exp = add_exp(node_type, token->exp, is_vm_mem, is_vm_storage, val_int64, val_uint64, val_double, svalue, token_num, token->line_num, data_type, left, right);
+	exp = add_exp(node_type, token->exp, is_vm_mem, is_vm_storage, is_vm_const, val_int64, val_uint64, val_double, svalue, token_num, token->line_num, data_type, left, right);
+
+	if (exp && (token->exp == EXP_FUNCTION))
+		set_function_type(exp);
+
+	if (exp && !validate_vector_exp(token, exp, vec_len))
+		return false;
 
 	// Update The "End Statement" Indicator For If/Else/Repeat/Block/Function/Result
 	if (exp) { // dont segfault here please
-		if ((exp->type == NODE_IF) || (exp->type == NODE_ELSE) || (exp->type == NODE_REPEAT) || (exp->type == NODE_BLOCK) || (exp->type == NODE_FUNCTION) || (exp->type == NODE_VERIFY_BTY) || (exp->type == NODE_VERIFY_POW))
+		if ((exp->type == NODE_IF) || (exp->type == NODE_ELSE) || (exp->type == NODE_REPEAT) || (exp->type == NODE_BLOCK) || (exp->type == NODE_FUNCTION) || (exp->type == NODE_VERIFY_BTY) || (exp->type == NODE_VERIFY_POW) ||
+			(exp->type == NODE_SHA256_BLOCK) || (exp->type == NODE_MD5_BLOCK) || (exp->type == NODE_KECCAK_F1600) ||
+			(exp->type == NODE_COPY) || (exp->type == NODE_FILL))
 			exp->end_stmnt = true;
 		push_exp(exp);
 	}
@@ -963,6 +1353,182 @@ static bool create_exp(SOURCE_TOKEN *token, int token_num) {
 	return true;
 }
 
+// Initializer Values:  BLOCK_BEGIN Literal [, Literal ...] [,] BLOCK_END
+//
+// The Values Are Returned As 64bit Patterns (Two's Complement For Integers, IEEE
+// Doubles For Float Arrays) So The Code Generators Can Emit Them Directly
+static int get_init_values(SOURCE_TOKEN_LIST *token_list, int token_num, int *end, bool is_float, uint64_t **values) {
+	SOURCE_TOKEN *token = &token_list->token[token_num];
+	int i, cnt;
+	ast *val;
+	double dval;
+
+	// Validate The Layout & Count The Values
+	if ((token_num >= token_list->num) || (token->type != TOKEN_BLOCK_BEGIN)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid initializer", token->line_num);
+		return -1;
+	}
+
+	cnt = 0;
+	for (*end = token_num + 1; *end < token_list->num; *end += 2) {
+		if (token_list->token[*end].type != TOKEN_LITERAL)
+			break;
+		cnt++;
+		if ((*end + 1 >= token_list->num) || (token_list->token[*end + 1].type != TOKEN_COMMA)) {
+			(*end)++;
+			break;
+		}
+	}
+
+	if (!cnt || (*end >= token_list->num) || (token_list->token[*end].type != TOKEN_BLOCK_END)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid initializer", token->line_num);
+		return -1;
+	}
+
+	*values = malloc(cnt * sizeof(uint64_t));
+	if (!*values)
+		return -1;
+
+	// Convert Each Literal The Same Way As Any Other Constant
+	for (cnt = 0, i = token_num + 1; i < *end; i += 2, cnt++) {
+		if (!create_exp(&token_list->token[i], i)) {
+			free(*values);
+			return -1;
+		}
+		val = pop_exp();
+
+		if (is_float) {
+			dval = val->is_float ? val->fvalue : (val->is_signed ? (double)val->ivalue : (double)val->uvalue);
+			memcpy(&(*values)[cnt], &dval, sizeof(double));
+		}
+		else if (val->is_float) {
+			applog(LOG_ERR, "Syntax Error: Line: %d - Decimal value in integer initializer", token->line_num);
+			clean_up_ast_internal(val, false);
+			free(*values);
+			return -1;
+		}
+		else {
+			(*values)[cnt] = val->is_signed ? (uint64_t)val->ivalue : val->uvalue;
+		}
+		clean_up_ast_internal(val, false);
+	}
+
+	return cnt;
+}
+
+// Table Initializer:  VAR_BEGIN Literal VAR_RANGE ASSIGN BLOCK_BEGIN Literal [, Literal ...] BLOCK_END
+static bool create_array_init(SOURCE_TOKEN_LIST *token_list, int *token_num) {
+	SOURCE_TOKEN *token = &token_list->token[*token_num];
+	DATA_TYPE data_type = token->data_type;
+	uint64_t *values, start;
+	uint32_t size;
+	int i, cnt, end;
+	ast *val, *exp;
+
+	i = *token_num;
+	if (((i + 5) >= token_list->num) || (token_list->token[i + 1].type != TOKEN_LITERAL) ||
+		(token_list->token[i + 3].type != TOKEN_ASSIGN) || (token_list->token[i + 4].type != TOKEN_BLOCK_BEGIN)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid table initializer", token->line_num);
+		return false;
+	}
+
+	if ((data_type == DT_UINT_M) || (data_type == DT_UINT_S) || (data_type == DT_UINT_C) || (data_type == DT_DOUBLE_C)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Table initializers are not allowed for m[] / s[] / cu[] / cd[]", token->line_num);
+		return false;
+	}
+
+	// u4[x .. y] Initializes The Same Elements As u[x .. y]
+	get_vector_lanes(data_type, &data_type);
+
+	// Get The Starting Index
+	if (!create_exp(&token_list->token[i + 1], i + 1))
+		return false;
+	val = pop_exp();
+	start = val->uvalue;
+	if (val->is_float || val->is_signed) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid table index", token->line_num);
+		clean_up_ast_internal(val, false);
+		return false;
+	}
+	clean_up_ast_internal(val, false);
+
+	cnt = get_init_values(token_list, i + 4, &end, ((data_type == DT_FLOAT) || (data_type == DT_DOUBLE)), &values);
+	if (cnt < 0)
+		return false;
+
+	exp = add_exp(NODE_ARRAY_INIT, EXP_STATEMENT, false, false, false, cnt, start, 0.0, NULL, *token_num, token->line_num, DT_NONE, NULL, NULL);
+	if (!exp) {
+		free(values);
+		return false;
+	}
+	set_data_type(exp, data_type);
+	exp->svalue = (unsigned char *)values;
+
+	size = get_array_size(exp);
+	if (!size || (cnt > size) || (start > (uint64_t)(size - cnt))) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Table initializer is out of bounds", token->line_num);
+		clean_up_ast_internal(exp, false);
+		return false;
+	}
+
+	push_exp(exp);
+	*token_num = end;
+
+	return true;
+}
+
+// Constant Data:  CONST_UINT / CONST_DOUBLE ASSIGN BLOCK_BEGIN Literal [, Literal ...] BLOCK_END END_STATEMENT
+//
+// The Values Are Read Only, So They Are Not Part Of The Per Thread VM Memory
+static bool create_const_data(SOURCE_TOKEN_LIST *token_list, int *token_num) {
+	SOURCE_TOKEN *token = &token_list->token[*token_num];
+	bool is_double = (token->type == TOKEN_CONST_DOUBLE);
+	uint64_t *values;
+	int i, cnt, end;
+
+	if ((is_double && ast_const_doubles) || (!is_double && ast_const_uints)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - %s array already declared", token->line_num, is_double ? "Constant Double" : "Constant Unsigned Int");
+		return false;
+	}
+
+	if (((*token_num + 2) >= token_list->num) || (token_list->token[*token_num + 1].type != TOKEN_ASSIGN)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Invalid constant declaration", token->line_num);
+		return false;
+	}
+
+	cnt = get_init_values(token_list, *token_num + 2, &end, is_double, &values);
+	if (cnt < 0)
+		return false;
+
+	if (((end + 1) >= token_list->num) || (token_list->token[end + 1].type != TOKEN_END_STATEMENT)) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Missing ';' after constant declaration", token->line_num);
+		free(values);
+		return false;
+	}
+
+	if ((uint64_t)cnt * (is_double ? 8 : 4) > ast_vm_MEMORY_SIZE) {
+		applog(LOG_ERR, "Syntax Error: Line: %d - Constant array exceeds allowable size (%d bytes)", token->line_num, ast_vm_MEMORY_SIZE);
+		free(values);
+		return false;
+	}
+
+	if (is_double) {
+		ast_const_double_data = (double *)values;
+		ast_const_doubles = cnt;
+	}
+	else {
+		// Integer Values Are Narrowed In Place
+		ast_const_uint_data = (uint32_t *)values;
+		for (i = 0; i < cnt; i++)
+			ast_const_uint_data[i] = (uint32_t)values[i];
+		ast_const_uints = cnt;
+	}
+
+	*token_num = end + 1;
+
+	return true;
+}
+
 extern bool parse_token_list(SOURCE_TOKEN_LIST *token_list) {
 
 	int i, j, token_id;
@@ -1028,6 +1594,20 @@ extern bool parse_token_list(SOURCE_TOKEN_LIST *token_list) {
 			}
 		}
 
+		// Constant Data (const_uint = { 1, 2, 3 };) Is Parsed Up To The ';' In One Step
+		if ((token_list->token[i].type == TOKEN_CONST_UINT) || (token_list->token[i].type == TOKEN_CONST_DOUBLE)) {
+			if (!create_const_data(token_list, &i))
+				return false;
+			continue;
+		}
+
+		// Table Initializers (u[100..] = { 1, 2, 3 };) Are Parsed Up To The '}' In One Step
+		if ((token_list->token[i].type == TOKEN_VAR_BEGIN) && ((i + 2) < token_list->num) && (token_list->token[i + 2].type == TOKEN_VAR_RANGE)) {
+			if (!create_array_init(token_list, &i))
+				return false;
+			continue;
+		}
+
 		// Process Token
 		switch (token_list->token[i].type) {
 
@@ -1035,6 +1615,10 @@ extern bool parse_token_list(SOURCE_TOKEN_LIST *token_list) {
 			continue;
 			break;
 
+		case TOKEN_VAR_RANGE:
+			applog(LOG_ERR, "Syntax Error: Line: %d - '..' is only valid in a table initializer\n", token_list->token[i].line_num);
+			return false;
+
 		case TOKEN_LITERAL:
 		case TOKEN_TRUE:
 		case TOKEN_FALSE:
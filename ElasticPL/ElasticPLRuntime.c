@@ -0,0 +1,74 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Fixed Part Of Every Job Library - Linked In Whole From libElasticPLRuntime
+
+#include <openssl/md5.h>
+#include "ElasticPLRuntime.h"
+
+EPL_TLS uint32_t *m = NULL;
+EPL_TLS int32_t *i = NULL;
+EPL_TLS uint32_t *u = NULL;
+EPL_TLS int64_t *l = NULL;
+EPL_TLS uint64_t *ul = NULL;
+EPL_TLS float *f = NULL;
+EPL_TLS double *d = NULL;
+EPL_TLS uint32_t *s = NULL;
+
+uint32_t check_pow(uint32_t msg_0, uint32_t msg_1, uint32_t msg_2, uint32_t msg_3, uint32_t *m, uint32_t *target, uint32_t *hash) {
+	int i;
+	unsigned char msg[48];
+	uint32_t *msg32 = (uint32_t *)(msg);
+	msg32[0] = msg_0;
+	msg32[1] = msg_1;
+	msg32[2] = msg_2;
+	msg32[3] = msg_3;
+
+	for (i = 0; i < 8; i++)
+		msg32[i+4] = m[i];
+
+	MD5(msg, 48, (unsigned char *)hash);
+
+	for (i = 0; i < 4; i++) {
+		if (hash[i] > target[i])
+			return 0;
+		else if (hash[i] < target[i])
+			return 1;    // POW Solution Found
+	}
+	return 0;
+}
+
+EPL_EXPORT int32_t initialize(uint32_t *vm_m, int32_t *vm_i, uint32_t *vm_u, int64_t *vm_l, uint64_t *vm_ul, float *vm_f, double *vm_d, uint32_t *vm_s) {
+	m = vm_m;
+	i = vm_i;
+	u = vm_u;
+	l = vm_l;
+	ul = vm_ul;
+	f = vm_f;
+	d = vm_d;
+	s = vm_s;
+
+	return 0;
+}
+
+EPL_EXPORT int32_t execute(uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {
+
+	// Call The Main Function For The Current Job
+	job_main(bounty_found, verify_pow, pow_found, target, hash);
+
+	return 0;
+}
+
+EPL_EXPORT int32_t verify(uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {
+
+	// Call The Verify Function For The Current Job
+	job_verify(bounty_found, verify_pow, pow_found, target, hash);
+
+	return 0;
+}
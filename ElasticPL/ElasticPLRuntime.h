@@ -0,0 +1,146 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Prelude For The Generated Job Libraries
+//
+// Every job translation unit starts by including this header.  It is built
+// into ElasticPLRuntime.h.gch at install time so the system headers are not
+// parsed again for each package, and the fixed part of the library lives in
+// libElasticPLRuntime (ElasticPLRuntime.c).
+
+#ifndef ELASTICPLRUNTIME_H_
+#define ELASTICPLRUNTIME_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#include "ElasticPLFunctions.h"
+
+#ifdef _MSC_VER
+	#define EPL_TLS __declspec(thread)
+#else
+	#define EPL_TLS __thread
+#endif
+
+#ifdef WIN32
+	#define EPL_EXPORT __declspec(dllexport)
+	#define EPL_HIDDEN
+#else
+	#define EPL_EXPORT
+	#define EPL_HIDDEN __attribute__((visibility("hidden")))
+#endif
+
+// VM Memory Of The Calling Thread (Set By initialize)
+extern EPL_TLS EPL_HIDDEN uint32_t *m;
+extern EPL_TLS EPL_HIDDEN int32_t *i;
+extern EPL_TLS EPL_HIDDEN uint32_t *u;
+extern EPL_TLS EPL_HIDDEN int64_t *l;
+extern EPL_TLS EPL_HIDDEN uint64_t *ul;
+extern EPL_TLS EPL_HIDDEN float *f;
+extern EPL_TLS EPL_HIDDEN double *d;
+extern EPL_TLS EPL_HIDDEN uint32_t *s;
+
+// Entry Points Provided By Each Job
+extern EPL_HIDDEN void job_main(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash);
+extern EPL_HIDDEN void job_verify(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash);
+
+extern EPL_HIDDEN uint32_t check_pow(uint32_t msg_0, uint32_t msg_1, uint32_t msg_2, uint32_t msg_3, uint32_t *m, uint32_t *target, uint32_t *hash);
+
+// Rotations Stay In The Header So They Are Inlined Into The Job Code
+static const uint32_t mask32 = (CHAR_BIT*sizeof(uint32_t)-1);
+static const uint64_t mask64 = (CHAR_BIT*sizeof(uint64_t)-1);
+
+static inline uint32_t rotl32 (uint32_t x, uint32_t n) {
+	n &= mask32;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers
+	return (x<<n) | (x>>( (-n)&mask32 ));
+}
+
+static inline uint32_t rotr32 (uint32_t x, uint32_t n) {
+	n &= mask32;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers
+	return (x>>n) | (x<<( (-n)&mask32 ));
+}
+
+static inline uint64_t rotl64 (uint64_t x, uint64_t n) {
+	n &= mask64;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers
+	return (x<<n) | (x>>( (-n)&mask64 ));
+}
+
+static inline uint64_t rotr64 (uint64_t x, uint64_t n) {
+	n &= mask64;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers
+	return (x>>n) | (x<<( (-n)&mask64 ));
+}
+
+// Bit Functions (popcount, clz, bswap32, mulhi, min, max) - Single Instructions On Most Targets
+#ifdef _MSC_VER
+#include <intrin.h>
+
+static inline uint32_t popcnt32(uint32_t x) { return __popcnt(x); }
+static inline uint32_t popcnt64(uint64_t x) { return (uint32_t)__popcnt64(x); }
+static inline uint32_t clz32(uint32_t x) { unsigned long n; return _BitScanReverse(&n, x) ? (31 - n) : 32; }
+static inline uint32_t clz64(uint64_t x) { unsigned long n; return _BitScanReverse64(&n, x) ? (63 - n) : 64; }
+static inline uint32_t bswap32(uint32_t x) { return _byteswap_ulong(x); }
+static inline uint64_t mulhi64(uint64_t a, uint64_t b) { return __umulh(a, b); }
+#else
+static inline uint32_t popcnt32(uint32_t x) { return __builtin_popcount(x); }
+static inline uint32_t popcnt64(uint64_t x) { return __builtin_popcountll(x); }
+static inline uint32_t clz32(uint32_t x) { return x ? __builtin_clz(x) : 32; }
+static inline uint32_t clz64(uint64_t x) { return x ? __builtin_clzll(x) : 64; }
+static inline uint32_t bswap32(uint32_t x) { return __builtin_bswap32(x); }
+#ifdef __SIZEOF_INT128__
+static inline uint64_t mulhi64(uint64_t a, uint64_t b) { return (uint64_t)(((unsigned __int128)a * b) >> 64); }
+#else
+// 32bit Targets Have No 128bit Type, So Combine Four 32x32 Products
+static inline uint64_t mulhi64(uint64_t a, uint64_t b) {
+	uint64_t lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+	uint64_t t1 = (a >> 32) * (b & 0xFFFFFFFF) + (lo >> 32);
+	uint64_t t2 = (a & 0xFFFFFFFF) * (b >> 32) + (t1 & 0xFFFFFFFF);
+	return (a >> 32) * (b >> 32) + (t1 >> 32) + (t2 >> 32);
+}
+#endif
+#endif
+
+static inline int32_t imin32(int32_t a, int32_t b) { return (a < b) ? a : b; }
+static inline uint32_t umin32(uint32_t a, uint32_t b) { return (a < b) ? a : b; }
+static inline int64_t imin64(int64_t a, int64_t b) { return (a < b) ? a : b; }
+static inline uint64_t umin64(uint64_t a, uint64_t b) { return (a < b) ? a : b; }
+static inline int32_t imax32(int32_t a, int32_t b) { return (a > b) ? a : b; }
+static inline uint32_t umax32(uint32_t a, uint32_t b) { return (a > b) ? a : b; }
+static inline int64_t imax64(int64_t a, int64_t b) { return (a > b) ? a : b; }
+static inline uint64_t umax64(uint64_t a, uint64_t b) { return (a > b) ? a : b; }
+
+// Short Vectors (i4[], u4[], f4[], i8[], u8[], f8[]) - GCC Vector Extensions Laid Over The VM
+// Arrays, Which Are Only 4 Byte Aligned.  The Helpers Are Macros So 32 Byte Vectors Are Never
+// Passed By Value (That Changes The ABI On Targets Without AVX).  Jobs Using Them Need GCC / Clang.
+#ifndef _MSC_VER
+typedef int32_t vint4 __attribute__((vector_size(16), aligned(4)));
+typedef uint32_t vuint4 __attribute__((vector_size(16), aligned(4)));
+typedef float vfloat4 __attribute__((vector_size(16), aligned(4)));
+typedef int32_t vint8 __attribute__((vector_size(32), aligned(4)));
+typedef uint32_t vuint8 __attribute__((vector_size(32), aligned(4)));
+typedef float vfloat8 __attribute__((vector_size(32), aligned(4)));
+
+// Lane Wise Rotate Of An Unsigned Vector T
+#define vrotl32(T, x, n)	({ T vx_ = (x), vn_ = (n) & 31; (vx_ << vn_) | (vx_ >> ((32 - vn_) & 31)); })
+#define vrotr32(T, x, n)	({ T vx_ = (x), vn_ = (n) & 31; (vx_ >> vn_) | (vx_ << ((32 - vn_) & 31)); })
+
+// Scalar Broadcast - Evaluates x Once (Adding To A Zero Vector Would Turn -0.0 Into 0.0)
+#define vdup4(T, E, x)	({ E vd_ = (x); (T){ vd_, vd_, vd_, vd_ }; })
+#define vdup8(T, E, x)	({ E vd_ = (x); (T){ vd_, vd_, vd_, vd_, vd_, vd_, vd_, vd_ }; })
+
+// Lane Wise 'm ? a : b' - m Is An Int Vector Mask M Of -1 / 0 Lanes
+#define vselect(T, M, m, a, b)	({ M vm_ = (m); (T)((vm_ & (M)(a)) | (~vm_ & (M)(b))); })
+#endif
+
+#endif // ELASTICPLRUNTIME_H_
@@ -41,6 +41,8 @@ struct EXP_TOKEN_LIST epl_token[] = {
 	{ "array_ulong",				11,	TOKEN_ARRAY_ULONG,	EXP_STATEMENT,	1,	0,	DT_NONE },
 	{ "array_float",				11,	TOKEN_ARRAY_FLOAT,	EXP_STATEMENT,	1,	0,	DT_NONE },
 	{ "array_double",				12,	TOKEN_ARRAY_DOUBLE,	EXP_STATEMENT,	1,	0,	DT_NONE },
+	{ "const_uint",					10,	TOKEN_CONST_UINT,	EXP_NONE,		0,	0,	DT_NONE },
+	{ "const_double",				12,	TOKEN_CONST_DOUBLE,	EXP_NONE,		0,	0,	DT_NONE },
 	{ "submit_sz",					9,	TOKEN_SUBMIT_SZ,	EXP_STATEMENT,	1,	0,	DT_NONE },
 	{ "submit_idx",					10,	TOKEN_SUBMIT_IDX,	EXP_STATEMENT,	1,	0,	DT_NONE },
 	{ "repeat",						6,	TOKEN_REPEAT,		EXP_STATEMENT,	4,	2,	DT_NONE },
@@ -60,6 +62,15 @@ struct EXP_TOKEN_LIST epl_token[] = {
 	{ "d[",							2,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_DOUBLE },
 	{ "m[",							2,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_UINT_M },
 	{ "s[",							2,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_UINT_S },
+	{ "cu[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_UINT_C },
+	{ "cd[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_DOUBLE_C },
+	{ "i4[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_INT_V4 },
+	{ "i8[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_INT_V8 },
+	{ "u4[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_UINT_V4 },
+	{ "u8[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_UINT_V8 },
+	{ "f4[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_FLOAT_V4 },
+	{ "f8[",						3,	TOKEN_VAR_BEGIN,	EXP_EXPRESSION,	1,	4,	DT_FLOAT_V8 },
+	{ "..]",						3,	TOKEN_VAR_RANGE,	EXP_NONE,		0,	4,	DT_NONE },
 	{ "]",							1,	TOKEN_VAR_END,		EXP_EXPRESSION,	1,	4,	DT_INT },
 
 	{ "++",							2,	TOKEN_INCREMENT,	EXP_EXPRESSION,	1,	5,	DT_INT },	// Increment
@@ -138,6 +149,21 @@ struct EXP_TOKEN_LIST epl_token[] = {
 	{ "abs",						3,	TOKEN_ABS,			EXP_FUNCTION,	1,	2,	DT_INT },	// Built In Math Functions
 	{ "fmod",						4,	TOKEN_FMOD,			EXP_FUNCTION,	2,	2,	DT_FLOAT },	// Built In Math Functions
 	{ "gcd",						3,	TOKEN_GCD,			EXP_FUNCTION,	2,	2,	DT_FLOAT },	// Built In Math Functions
+
+	{ "popcount",					8,	TOKEN_POPCOUNT,		EXP_FUNCTION,	1,	2,	DT_UINT },	// Built In Bit Functions
+	{ "clz",						3,	TOKEN_CLZ,			EXP_FUNCTION,	1,	2,	DT_UINT },	// Built In Bit Functions
+	{ "bswap32",					7,	TOKEN_BSWAP32,		EXP_FUNCTION,	1,	2,	DT_UINT },	// Built In Bit Functions
+	{ "mulhi",						5,	TOKEN_MULHI,		EXP_FUNCTION,	2,	2,	DT_ULONG },	// Built In Bit Functions
+	{ "min",						3,	TOKEN_MIN,			EXP_FUNCTION,	2,	2,	DT_INT },	// Built In Bit Functions
+	{ "max",						3,	TOKEN_MAX,			EXP_FUNCTION,	2,	2,	DT_INT },	// Built In Bit Functions
+	{ "select",						6,	TOKEN_SELECT,		EXP_FUNCTION,	3,	2,	DT_INT },	// Built In Bit Functions
+
+	{ "sha256_block",				12,	TOKEN_SHA256_BLOCK,	EXP_FUNCTION,	2,	2,	DT_NONE },	// Built In Crypto Functions
+	{ "md5_block",					9,	TOKEN_MD5_BLOCK,	EXP_FUNCTION,	2,	2,	DT_NONE },	// Built In Crypto Functions
+	{ "keccak_f1600",				12,	TOKEN_KECCAK_F1600,	EXP_FUNCTION,	1,	2,	DT_NONE },	// Built In Crypto Functions
+
+	{ "copy",						4,	TOKEN_COPY,			EXP_FUNCTION,	3,	2,	DT_NONE },	// Built In Array Functions
+	{ "fill",						4,	TOKEN_FILL,			EXP_FUNCTION,	3,	2,	DT_NONE },	// Built In Array Functions
 };
 
 extern bool init_token_list(SOURCE_TOKEN_LIST *token_list, size_t size) {
@@ -320,6 +346,11 @@ static bool validate_tokens(SOURCE_TOKEN_LIST *token_list) {
 	return true;
 }
 
+// Identifier Characters Used By Literals And Function Names
+static bool is_word_char(char c) {
+	return ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '_'));
+}
+
 extern void revert_token_list() {
 
 }
@@ -342,12 +373,8 @@ extern bool get_token_list(char *str, SOURCE_TOKEN_LIST *token_list) {
 		token_id = -1;
 		c = str[idx];
 
-		if (literal_idx > 0) {
-			if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c == '_'))
-				literal_str = true;
-			else
-				literal_str = false;
-		}
+		if (literal_idx > 0)
+			literal_str = is_word_char(c);
 
 		if (!literal_str) {
 
@@ -403,6 +430,11 @@ extern bool get_token_list(char *str, SOURCE_TOKEN_LIST *token_list) {
 			for (i = 0; i < token_list_sz; i++) {
 
 				if (memcmp(&str[idx], epl_token[i].str, epl_token[i].len) == 0) {
+
+					// Words Only Match Whole Words (e.g. "min" Is Not A Token In "minimal")
+					if (is_word_char(epl_token[i].str[epl_token[i].len - 1]) && is_word_char(str[idx + epl_token[i].len]))
+						continue;
+
 					token_id = i;
 					break;
 				}
@@ -0,0 +1,416 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Miner Thread Placement & Per Thread VM Memory
+//
+// The topology (sockets, NUMA nodes, SMT siblings, big / little cores) is read
+// from sysfs once at startup and turned into a fixed CPU for every miner thread.
+// Each thread pins itself before it allocates its VM arena, so the arena and the
+// thread's copy of storage are first touched, and therefore placed, on the
+// thread's own NUMA node.
+
+#define _GNU_SOURCE
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "miner.h"
+
+#ifdef WIN32
+#include <malloc.h>
+#else
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#endif
+
+#define HUGE_PAGE_SIZE	(2 * 1024 * 1024)
+
+enum affinity_policy {
+	AFFINITY_NONE,		// Let The OS Schedule Miner Threads (Default)
+	AFFINITY_CORES,		// One Thread Per Physical Core First, Then SMT Siblings
+	AFFINITY_NOSMT,		// Only The First Hardware Thread Of Each Physical Core
+	AFFINITY_LIST		// User Supplied CPU List
+};
+
+struct cpu_topo {
+	int cpu;			// Logical CPU Number
+	int package;		// Socket
+	int node;			// NUMA Node
+	int core;			// Core ID Within The Socket
+	int smt;			// Position Among The Hardware Threads Of The Core
+	int capacity;		// Relative Speed On big.LITTLE / Hybrid CPUs (0 = Unknown)
+};
+
+static enum affinity_policy policy = AFFINITY_NONE;
+static int *cpu_list = NULL;		// CPUs Given With --cpu-affinity <list>
+static int cpu_list_cnt = 0;
+static struct cpu_topo *topo = NULL;
+static int topo_cnt = 0;
+static int *plan = NULL;			// Index Into topo[] For Each Miner Thread
+static int plan_cnt = 0;
+
+// Parses A Linux Style CPU List ("0-3,8,10-11") - Returns The Number Of CPUs Or -1
+static int parse_cpu_list(const char *str, int *cpus, int max) {
+	int cnt = 0, first, last;
+	char *end;
+
+	while (*str && !isspace((unsigned char)*str)) {
+		if (!isdigit((unsigned char)*str))
+			return -1;
+		first = last = (int)strtol(str, &end, 10);
+		if (*end == '-') {
+			if (!isdigit((unsigned char)end[1]))
+				return -1;
+			last = (int)strtol(end + 1, &end, 10);
+		}
+		if (last < first)
+			return -1;
+		for (; first <= last; first++) {
+			if (cpus && (cnt < max))
+				cpus[cnt] = first;
+			cnt++;
+		}
+		if (*end == ',')
+			end++;
+		else if (*end && !isspace((unsigned char)*end))
+			return -1;
+		str = end;
+	}
+
+	return cnt;
+}
+
+extern bool affinity_set_policy(const char *str) {
+	int cnt;
+
+	if (!strcmp(str, "none"))
+		policy = AFFINITY_NONE;
+	else if (!strcmp(str, "cores"))
+		policy = AFFINITY_CORES;
+	else if (!strcmp(str, "nosmt"))
+		policy = AFFINITY_NOSMT;
+	else {
+		cnt = parse_cpu_list(str, NULL, 0);
+		if (cnt <= 0)
+			return false;
+		if (cpu_list)
+			free(cpu_list);
+		cpu_list = malloc(cnt * sizeof(int));
+		if (!cpu_list)
+			return false;
+		cpu_list_cnt = parse_cpu_list(str, cpu_list, cnt);
+		policy = AFFINITY_LIST;
+	}
+
+	return true;
+}
+
+#if defined(__linux__)
+
+static bool read_sysfs(int cpu, const char *file, char *buf, int len) {
+	char path[256];
+	FILE *fp;
+	bool ok;
+
+	sprintf(path, "/sys/devices/system/cpu/cpu%d/%s", cpu, file);
+	fp = fopen(path, "r");
+	if (!fp)
+		return false;
+	ok = (fgets(buf, len, fp) != NULL);
+	fclose(fp);
+	return ok;
+}
+
+static int read_sysfs_int(int cpu, const char *file, int def) {
+	char buf[32];
+
+	return read_sysfs(cpu, file, buf, sizeof(buf)) ? atoi(buf) : def;
+}
+
+// NUMA Node Is Only Exposed As A "nodeN" Link In The CPU Directory
+static int read_cpu_node(int cpu) {
+	char path[64];
+	struct dirent *ent;
+	DIR *dir;
+	int node = 0;
+
+	sprintf(path, "/sys/devices/system/cpu/cpu%d", cpu);
+	dir = opendir(path);
+	if (!dir)
+		return 0;
+	while ((ent = readdir(dir)) != NULL) {
+		if (!strncmp(ent->d_name, "node", 4) && isdigit((unsigned char)ent->d_name[4])) {
+			node = atoi(&ent->d_name[4]);
+			break;
+		}
+	}
+	closedir(dir);
+	return node;
+}
+
+static int read_smt_rank(int cpu) {
+	int siblings[256], cnt, i, rank = 0;
+	char buf[1024];
+
+	if (!read_sysfs(cpu, "topology/thread_siblings_list", buf, sizeof(buf)))
+		return 0;
+	cnt = parse_cpu_list(buf, siblings, 256);
+	for (i = 0; i < cnt && i < 256; i++) {
+		if (siblings[i] < cpu)
+			rank++;
+	}
+	return rank;
+}
+
+static bool read_topology() {
+	int cpu;
+
+	topo = calloc(num_cpus, sizeof(struct cpu_topo));
+	if (!topo)
+		return false;
+
+	for (cpu = 0; cpu < num_cpus; cpu++) {
+
+		// cpu0 Usually Has No 'online' File As It Can Not Be Taken Offline
+		if (!read_sysfs_int(cpu, "online", 1))
+			continue;
+
+		topo[topo_cnt].cpu = cpu;
+		topo[topo_cnt].package = read_sysfs_int(cpu, "topology/physical_package_id", 0);
+		topo[topo_cnt].core = read_sysfs_int(cpu, "topology/core_id", cpu);
+		topo[topo_cnt].smt = read_smt_rank(cpu);
+		topo[topo_cnt].node = read_cpu_node(cpu);
+
+		// ARM Exposes Capacity Directly, Otherwise Max Frequency Separates P & E Cores
+		topo[topo_cnt].capacity = read_sysfs_int(cpu, "cpu_capacity", 0);
+		if (!topo[topo_cnt].capacity)
+			topo[topo_cnt].capacity = read_sysfs_int(cpu, "cpufreq/cpuinfo_max_freq", 0) / 1000;
+
+		topo_cnt++;
+	}
+
+	return (topo_cnt > 0);
+}
+
+#else
+
+// No Topology Information - Every Logical CPU Is Treated As Its Own Core
+static bool read_topology() {
+	int cpu;
+
+	topo = calloc(num_cpus, sizeof(struct cpu_topo));
+	if (!topo)
+		return false;
+
+	for (cpu = 0; cpu < num_cpus; cpu++) {
+		topo[cpu].cpu = cpu;
+		topo[cpu].core = cpu;
+	}
+	topo_cnt = num_cpus;
+
+	return true;
+}
+
+#endif
+
+// Fastest Cores First, Then Spread Over Physical Cores Before Using SMT Siblings
+static int cmp_topo(const void *a, const void *b) {
+	const struct cpu_topo *x = (const struct cpu_topo *)a;
+	const struct cpu_topo *y = (const struct cpu_topo *)b;
+
+	if (x->capacity != y->capacity)
+		return (x->capacity > y->capacity) ? -1 : 1;
+	if (x->smt != y->smt)
+		return x->smt - y->smt;
+	if (x->package != y->package)
+		return x->package - y->package;
+	if (x->core != y->core)
+		return x->core - y->core;
+	return x->cpu - y->cpu;
+}
+
+static int find_topo(int cpu) {
+	int i;
+
+	for (i = 0; i < topo_cnt; i++) {
+		if (topo[i].cpu == cpu)
+			return i;
+	}
+	return -1;
+}
+
+extern bool affinity_init(int threads) {
+	int i, n = 0, *avail, nodes = 0, cores = 0;
+
+	if (policy == AFFINITY_NONE)
+		return true;
+
+#if !defined(__linux__) && !defined(WIN32)
+	applog(LOG_WARNING, "WARNING: --cpu-affinity is not supported on this platform");
+	policy = AFFINITY_NONE;
+	return true;
+#endif
+
+	if (!read_topology()) {
+		applog(LOG_ERR, "ERROR: Unable to read CPU topology");
+		return false;
+	}
+
+	qsort(topo, topo_cnt, sizeof(struct cpu_topo), cmp_topo);
+
+	avail = malloc(topo_cnt * sizeof(int));
+	plan = malloc(threads * sizeof(int));
+	if (!avail || !plan) {
+		if (avail) free(avail);
+		return false;
+	}
+
+	if (policy == AFFINITY_LIST) {
+		for (i = 0; i < cpu_list_cnt; i++) {
+			avail[n] = find_topo(cpu_list[i]);
+			if (avail[n] < 0) {
+				applog(LOG_ERR, "ERROR: CPU %d in --cpu-affinity is not available", cpu_list[i]);
+				free(avail);
+				return false;
+			}
+			if (++n == topo_cnt)
+				break;
+		}
+	}
+	else {
+		for (i = 0; i < topo_cnt; i++) {
+			if ((policy == AFFINITY_NOSMT) && topo[i].smt)
+				continue;
+			avail[n++] = i;
+		}
+	}
+
+	if (threads > n)
+		applog(LOG_WARNING, "WARNING: %d miner threads share %d CPUs", threads, n);
+
+	for (i = 0; i < threads; i++)
+		plan[i] = avail[i % n];
+	plan_cnt = threads;
+	free(avail);
+
+	for (i = 0; i < topo_cnt; i++) {
+		if (topo[i].node >= nodes)
+			nodes = topo[i].node + 1;
+		if (!topo[i].smt)
+			cores++;
+	}
+	applog(LOG_INFO, "CPU topology: %d NUMA nodes, %d cores, %d CPUs", nodes, cores, topo_cnt);
+
+	for (i = 0; i < plan_cnt; i++)
+		applog(LOG_DEBUG, "DEBUG: CPU%d -> cpu %d (node %d, socket %d, core %d%s)", i, topo[plan[i]].cpu, topo[plan[i]].node, topo[plan[i]].package, topo[plan[i]].core, topo[plan[i]].smt ? ", smt" : "");
+
+	return true;
+}
+
+// Pins The Calling Miner Thread - Must Run Before The Thread Allocates Its VM Memory
+extern void affinity_apply(int thr_id) {
+	int cpu;
+
+	if ((policy == AFFINITY_NONE) || (thr_id >= plan_cnt))
+		return;
+
+	cpu = topo[plan[thr_id]].cpu;
+
+#if defined(__linux__)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+		applog(LOG_WARNING, "WARNING: CPU%d: Unable to pin thread to cpu %d", thr_id, cpu);
+#elif defined(WIN32)
+	if ((cpu >= 64) || !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu))
+		applog(LOG_WARNING, "WARNING: CPU%d: Unable to pin thread to cpu %d", thr_id, cpu);
+#endif
+}
+
+extern void thread_low_priority() {
+#if defined(__linux__)
+	pid_t tid = (pid_t)syscall(SYS_gettid);
+	int rc = setpriority(PRIO_PROCESS, tid, 7);
+	if (rc) {
+		applog(LOG_ERR, "Error(%d): failed setting thread priority (you are safe to ignore this message)", rc);
+	}
+	else {
+		if (opt_debug)
+			applog(LOG_DEBUG, "setting low thread priority for thread id %ld", (long)tid);
+	}
+#elif defined(WIN32)
+	if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL))
+		applog(LOG_ERR, "Error: failed setting thread priority (you are safe to ignore this message)");
+#else
+	// TODO: BSD / OS X Only Support Lowering The Priority Of The Whole Process
+#endif
+}
+
+// The Caller Clears The Arena From The Pinned Thread, Which Places The Pages
+extern bool vm_arena_reserve(struct vm_arena *arena, size_t size) {
+	vm_arena_release(arena);
+
+#ifdef WIN32
+	arena->base = _aligned_malloc(size, 64);
+	arena->size = size;
+#else
+	long page = sysconf(_SC_PAGESIZE);
+	void *p = MAP_FAILED;
+
+	if (opt_hugepages) {
+		size = (size + HUGE_PAGE_SIZE - 1) & ~((size_t)HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+		p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		arena->huge = (p != MAP_FAILED);
+#endif
+	}
+	else {
+		size = (size + page - 1) & ~((size_t)page - 1);
+	}
+
+	// No Reserved Huge Pages - Ask For Transparent Huge Pages Instead
+	if (p == MAP_FAILED) {
+		p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+		if (opt_hugepages && (p != MAP_FAILED))
+			madvise(p, size, MADV_HUGEPAGE);
+#endif
+	}
+
+	arena->base = (p != MAP_FAILED) ? p : NULL;
+	arena->size = size;
+#endif
+
+	if (!arena->base)
+		arena->size = 0;
+
+	return (arena->base != NULL);
+}
+
+extern void vm_arena_release(struct vm_arena *arena) {
+	if (arena->base) {
+#ifdef WIN32
+		_aligned_free(arena->base);
+#else
+		munmap(arena->base, arena->size);
+#endif
+	}
+	arena->base = NULL;
+	arena->size = 0;
+	arena->huge = false;
+}
@@ -8,6 +8,12 @@
 #define MAX_CPUS 16
 
 #define MAX_POW_PER_BLOCK 50
+#define MAX_PORTFOLIO 16		// Most Work Packages Mined At Once (--portfolio)
+#define MAX_FETCH_CONNS 8		// Connections Used To Fetch Sources & Storage At Once
+#define MAX_JSON_DEPTH 32		// Deepest Nesting Accepted By The getMineableWork Stream Parser
+#define STORAGE_CACHE_SZ 32		// Decoded Storage Buffers Kept By (work_id, storage_id)
+
+#define NONCE_BLOCK 4096		// Rounds Claimed At A Time By Each CPU Miner Thread
 
 #include <curl/curl.h>
 #include <jansson.h>
@@ -36,8 +42,18 @@
 #define strncasecmp(x,y,z) _strnicmp(x,y,z)
 #define __thread __declspec(thread)
 #define _ALIGN(x) __declspec(align(x))
+#define ATOMIC_LOAD(p) (*(p))
+#define ATOMIC_STORE(p, v) (*(p) = (v))
+#define ATOMIC_XCHG_PTR(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (v))
+#define ATOMIC_INC(p) InterlockedIncrement((volatile LONG *)(p))
+#define ATOMIC_DEC(p) InterlockedDecrement((volatile LONG *)(p))
 #else
 #define _ALIGN(x) __attribute__ ((aligned(x)))
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_XCHG_PTR(p, v) __atomic_exchange_n((p), (v), __ATOMIC_ACQ_REL)
+#define ATOMIC_INC(p) __atomic_add_fetch((p), 1, __ATOMIC_ACQ_REL)
+#define ATOMIC_DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
 #endif
 
 #if JANSSON_MAJOR_VERSION >= 2
@@ -68,6 +84,9 @@ extern int opt_timeout;
 extern int opt_n_threads;
 extern bool opt_test_vm;
 extern bool opt_opencl;
+extern bool opt_autotune;
+extern bool opt_hugepages;
+extern int num_cpus;
 extern int opt_opencl_gthreads;
 extern int opt_opencl_vwidth;
 
@@ -91,6 +110,29 @@ enum submit_commands {
 	SUBMIT_COMPLETE
 };
 
+// Storage Values Of One Iteration - Never Modified Once Fetched, So Miner Threads Read It
+// In Place (The Parser Rejects Writes To s[]).  Freed When The Last Reference Is Released
+struct storage_buf {
+	volatile int refcnt;
+	uint32_t *data;
+};
+
+// Storage Cache Slot - Holds A Reference On 'buf' While Cached
+struct storage_entry {
+	uint64_t work_id;
+	uint32_t storage_id;
+	struct storage_buf *buf;
+	uint32_t last_use;
+};
+
+// Storage Fetch Queued For storage_thread
+struct storage_job {
+	uint64_t work_id;
+	char work_str[22];
+	uint32_t storage_sz;
+	int iteration_id;
+};
+
 struct work_package {
 	uint64_t block_id;
 	uint64_t work_id;
@@ -103,6 +145,8 @@ struct work_package {
 	int pending_bty_cnt;
 	bool blacklisted;
 	bool active;
+	bool building;			// Library Is Still Being Compiled (See compile_library_async)
+	bool retired;			// Library Released After Leaving getMineableWork (Rebuilt If The Package Returns)
 	int iterations;
 
 
@@ -124,7 +168,17 @@ struct work_package {
 	uint32_t storage_sz;	// Number Of Unsigned Ints In Storage
 	uint32_t storage_idx;	// Index In u[] To Extract Storage From
 	uint32_t storage_cnt;	// Number Of Storage Solutions For Iteration
-	uint32_t *storage;
+	struct storage_buf *storage;
+	int storage_iter;		// Iteration The Storage Was Fetched For (-1 = Not Fetched)
+	int node_storage_id;	// storage_id Listed By getMineableWork (-1 = Not Listed)
+	bool storage_pending;	// Storage For A New Iteration Is Being Fetched (See storage_thread)
+
+	// Portfolio Scheduling
+	double score;			// Expected Reward Rate Used To Rank & Weight Packages
+	uint32_t pow_target[4];
+	int pow_cnt;			// POW Submitted For This Package In The Current Block
+	bool pow_capped;		// No More POW Accepted For This Package Until Next Block
+	bool bty_capped;		// No More Bounties Accepted For This Package Until Next Block
 
 
 };
@@ -135,6 +189,7 @@ struct work {
 	uint64_t block_id;
 	uint64_t work_id;
 	uint32_t iteration_id;
+	uint32_t storage_id;	// Storage The Work Is Mined Against (Sent With Its Solutions)
 	unsigned char work_str[22];
 	unsigned char work_nm[50];
 	uint32_t pow_target[4];
@@ -143,6 +198,14 @@ struct work {
 	unsigned char multiplicator[32];
 };
 
+// Immutable Copy Of The Work Assigned To Miner Threads, Published By The Workio Thread.
+// Threads On The Same Package Share One Snapshot, Which Is Freed When The Last Reference Is Released
+struct work_snapshot {
+	struct work work;
+	struct work_package pkg;	// Package Details At Publish Time
+	volatile int refcnt;
+};
+
 struct thr_info {
 	int id;
 	char name[6];
@@ -151,9 +214,23 @@ struct thr_info {
 	struct thread_q	*q;
 };
 
+// Block Of Rounds Claimed From The Nonce Allocator (See util.c)
+struct nonce_range {
+	uint64_t next;
+	uint64_t end;
+};
+
+// Per Thread VM Memory (See affinity.c)
+struct vm_arena {
+	void *base;
+	size_t size;
+	bool huge;		// Backed By Reserved Huge Pages
+};
+
 struct work_restart {
+	struct work_snapshot *volatile snap;	// Mailbox For The Next Work Snapshot (Taken By The Miner Thread)
 	volatile uint8_t restart;
-	char padding[128 - sizeof(uint8_t)];
+	char padding[128 - sizeof(void *) - sizeof(uint8_t)];
 };
 
 struct submit_req {
@@ -163,9 +240,11 @@ struct submit_req {
 	time_t start_tm;	// Time Request Was Submitted
 	time_t delay_tm;	// If Populated, Time When Next Request Can Be Sent
 	int retries;
+	uint64_t reward;	// XEL Paid For This Solution, Used To Order The Submit Queue
 	char mult[65];		// Multiplicator In Hex
 	char hash[33];		// POW Hash In Hex
 	uint64_t work_id;
+	uint64_t block_id;	// Block The Solution Was Found On
 	unsigned char work_str[22];
 	uint32_t iteration_id;
 	uint32_t storage_id;
@@ -173,11 +252,66 @@ struct submit_req {
 	uint32_t *submit_data;
 };
 
+struct data_buffer {
+	void		*buf;
+	size_t		len;
+};
+
+// One Entry Of A getMineableWork Response
+struct mineable_pkg {
+	char id[22];
+	char block_id[22];
+	char target[33];
+	int iterations;
+	int iterations_left;
+	uint32_t bounty_limit;
+	uint64_t bty_reward;
+	uint64_t pow_reward;
+	int bty_rcvd;
+	int storage_id;			// -1 If The Node Doesn't List It
+};
+
+// getMineableWork Response Parsed Straight From The Curl Stream (See mineable_parse).
+// 'pkg' Is Kept Between Responses And Only Grows, So Steady State Polling Doesn't Allocate
+struct mineable_work {
+	struct mineable_pkg *pkg;
+	int num_pkg;
+	int max_pkg;
+	bool has_list;			// 'work_packages' Array Was Found
+	bool error;
+	char err_desc[64];		// 'errorDescription' Returned By The Node
+
+	// Tokenizer State - Carried Across Chunk Boundaries
+	int lex;
+	int depth;
+	int list_depth;			// Depth Inside The 'work_packages' Array (0 = Outside)
+	bool expect_key;
+	char stack[MAX_JSON_DEPTH];
+	char key[32];
+	char tok[80];
+	int key_len;
+	int tok_len;
+	bool tok_long;
+};
+
+// One Submission In Flight On The Submit Engine's Multi Handle
+struct submit_xfer {
+	CURL *curl;		// Kept Across Requests So Its Connection Stays Alive
+	bool busy;
+	struct submit_req *req;	// Owned By The Transfer Until Its Response Is Handled
+	char *url;
+	char *data;
+	struct data_buffer db;
+	char err_str[CURL_ERROR_SIZE];
+	struct timeval tv_start;
+};
+
 struct workio_cmd {
 	enum submit_commands cmd;
 	struct thr_info *thr;
 	struct work work;
 	uint32_t *submit_data;
+	uint32_t submit_sz;
 };
 
 struct header_info {
@@ -186,11 +320,6 @@ struct header_info {
 	char		*stratum_url;
 };
 
-struct data_buffer {
-	void		*buf;
-	size_t		len;
-};
-
 struct upload_buffer {
 	const void	*buf;
 	size_t		len;
@@ -206,6 +335,7 @@ struct thread_q {
 	struct list_head	q;
 
 	bool frozen;
+	bool wake;			// Set By tq_wake, Makes The Next tq_pop Return Without Waiting
 
 	pthread_mutex_t		mutex;
 	pthread_cond_t		cond;
@@ -224,11 +354,14 @@ struct instance {
 	int32_t(*execute)(uint64_t, uint32_t *, uint32_t, uint32_t *, uint32_t *, uint32_t *);
 	int32_t(*verify)(uint64_t, uint32_t *, uint32_t, uint32_t *, uint32_t *, uint32_t *);
 #endif
+	int version;	// Library Version Loaded (Changes When The Autotuner Promotes A Build)
 
 };
 
 extern bool use_colors;
 extern struct thr_info *thr_info;
+extern int work_thr_id;
+extern int submit_thr_id;
 extern struct thr_info *thr_deadswitch;
 extern pthread_mutex_t applog_lock;
 extern pthread_mutex_t response_lock;
@@ -313,12 +446,15 @@ extern bool opencl_create_kernel(struct opencl_device *gpu, char *ocl_source, ui
 extern bool opencl_create_buffers(struct opencl_device *gpu);
 extern bool opencl_calc_worksize(struct opencl_device *gpu);
 extern bool opencl_init_buffer_data(struct opencl_device *gpu, uint32_t *base_data, uint32_t *round, uint32_t *result, uint32_t *storage, uint32_t storage_sz);
+extern bool opencl_load_storage(struct opencl_device *gpu, uint32_t *storage, uint32_t storage_sz);
 extern bool opencl_run_kernel(struct opencl_device *gpu, uint32_t *rnd_num, uint32_t *result, uint32_t *output, uint32_t *submit, uint32_t submit_sz);
 static void *gpu_miner_thread(void *userdata);
 static bool opencl_err_check(int err, char *err_code);
 #endif
 
 struct thread_q;
+struct tune_job;
+struct lib_build;
 
 struct thread_q *tq_new(void);
 void tq_free(struct thread_q *tq);
@@ -327,13 +463,16 @@ void *tq_pop(struct thread_q *tq, const struct timespec *abstime);
 void *tq_pop_nowait(struct thread_q *tq);
 void tq_freeze(struct thread_q *tq);
 void tq_thaw(struct thread_q *tq);
+void tq_wake(struct thread_q *tq);
 
 static void *key_monitor_thread(void *userdata);
 static void *longpoll_thread(void *userdata);
 static void *test_vm_thread(void *userdata);
 static void *workio_thread(void *userdata);
-static void restart_threads(void);
+static void *submit_thread(void *userdata);
 static void *cpu_miner_thread(void *userdata);
+static bool update_vm_size(uint32_t *cur, uint32_t size);
+static bool layout_vm_memory(struct vm_arena *arena, uint32_t *vm_sizes);
 
 extern uint32_t swap32(uint32_t a);
 static void parse_cmdline(int argc, char *argv[]);
@@ -343,20 +482,54 @@ static void show_usage_and_exit(int status);
 static void show_version_and_exit(void);
 static bool load_test_file(char *file_name, char *buf);
 static bool get_vm_input(struct work *work);
-static int execute_vm(int thr_id, uint32_t *rnd, uint32_t iteration, struct work *work, struct instance *inst, long *hashes_done);
+static int execute_vm(int thr_id, struct nonce_range *nonce, uint32_t iteration, struct work *work, struct instance *inst, uint32_t verify_pow, long *hashes_done);
 static void dump_vm(int idx);
 
 static bool get_work(CURL *curl);
-static int decode_work(CURL *curl, const json_t *val, struct work *work);
-static bool get_work_source(CURL *curl, char *work_str, char *elastic_src);
-static int get_work_storage(CURL *curl, char *work_str, uint32_t *storage);
+static int decode_work(CURL *curl, const struct mineable_work *mw, struct work *work);
+static bool better_package(int a, int b);
+static void assign_threads(struct work *work, int cnt);
+static void update_ignore_flags(void);
+static void publish_work(void);
+static struct work_snapshot *snapshot_create(struct work *work);
+static void snapshot_release(struct work_snapshot *snap);
+static struct storage_buf *storage_create(uint32_t storage_sz);
+static void storage_release(struct storage_buf *buf);
+extern void match_storage(struct work *work, struct work_package *pkg);
+static struct work_snapshot *snapshot_take(int thr_id);
+static void reset_package_limits(void);
+static void park_thread(uint32_t gen);
+static void unpark_threads(void);
+static int find_work_package(uint64_t work_id);
+static void fetch_all(CURLM **multi, char **req, json_t **val, int cnt);
+static bool decode_work_source(json_t *val, char *work_str);
+static int decode_work_storage(json_t *val, uint64_t work_id, char *work_str, uint32_t storage_sz, struct storage_buf **buf);
+static struct storage_buf *storage_cache_get(uint64_t work_id, uint32_t storage_id);
+static void storage_cache_put(uint64_t work_id, uint32_t storage_id, struct storage_buf *buf);
+static bool queue_storage_fetch(struct work_package *wp);
+static void *storage_thread(void *userdata);
+static void clear_fetch(char **req, json_t **rsp, int cnt);
+static void library_built(char *work_str, bool rc);
+static bool rebuild_library(int idx, json_t *val);
 static bool validate_work_source(int package_id, struct instance *inst);
 static double calc_diff(uint32_t *target);
 extern bool add_work_package(struct work_package *work_package);
+extern void deliver_work(int thr_id, struct work *work, struct work_package *pkg, uint32_t *storage);
+extern void set_ignore_flags(bool pow, bool bty);
+extern void blacklist_package(uint64_t work_id);
+extern bool submit_push(struct workio_cmd *wc);
 static void update_pending_cnt(uint64_t work_id, bool add);
 
-static bool submit_work(CURL *curl, struct submit_req *req);
-static bool delete_submit_req(int idx);
+static bool submit_prepare(struct submit_req *req, char **url, char **data);
+static bool cap_package(uint64_t work_id, bool pow);
+static void submit_result(struct submit_req *req, json_t *val, char *data);
+static void submit_finish(struct submit_xfer *xfer, int rc);
+static void free_submit_req(struct submit_req *req);
+static bool submit_before(struct submit_req *a, struct submit_req *b);
+static void submit_heap_down(int i);
+static bool submit_heap_push(struct submit_req *req);
+static struct submit_req *submit_heap_pop(time_t now);
+static void submit_purge_pow(void);
 static bool add_submit_req(struct work *work, uint32_t *data, enum submit_commands req_type);
 
 static bool get_opencl_base_data(struct work *work, uint32_t *vm_input);
@@ -371,17 +544,86 @@ extern int32_t bin2int(unsigned char *str);
 extern bool ascii85dec(unsigned char *str, int strsz, const char *ascii85);
 static void databuf_free(struct data_buffer *db);
 static size_t all_data_cb(const void *ptr, size_t size, size_t nmemb, void *user_data);
+extern void json_rpc_prepare(CURL *curl, const char *url, const char *userpass, const char *req, struct data_buffer *db, char *curl_err_str);
+extern json_t* json_rpc_result(int rc, struct data_buffer *db, const char *curl_err_str, int *curl_err);
 extern json_t* json_rpc_call(CURL *curl, const char *url, const char *userpass, const char *req, int *curl_err);
+extern void mineable_reset(struct mineable_work *mw);
+extern bool mineable_parse(struct mineable_work *mw, const char *buf, size_t len);
+extern bool mineable_finish(struct mineable_work *mw);
+static size_t mineable_cb(const void *ptr, size_t size, size_t nmemb, void *user_data);
+extern bool get_mineable_work(CURL *curl, const char *url, const char *userpass, struct mineable_work *mw, int *curl_err);
+extern bool load_mineable_work(const char *filename, struct mineable_work *mw);
+extern void benchmark_decode(void);
 static void free_up();
 extern unsigned long genrand_int32(void);
 extern void init_genrand(unsigned long s);
-
-static bool create_c_source(char *work_str);
+extern uint32_t thread_rand32(void);
+extern void nonce_init(uint32_t shard, uint32_t shards);
+extern uint64_t nonce_alloc(uint32_t count);
+extern void nonce_share(volatile uint64_t *counter);
+extern uint32_t nonce_salt;
+
+static bool create_c_source(char *work_str, CODE_BUF *code);
+#ifndef WIN32
+static struct job_library *find_job_library(char *work_str, bool add);
+static bool set_library_fd(char *work_str, int fd);
+static bool set_library_tuned(char *work_str, char *path);
+static int create_library_fd(char *work_str);
+static int add_job_cflags(char **argv, char *variant);
+static int add_job_libs(char **argv, int n);
+static bool spawn_compiler(char **argv, CODE_BUF *code, pid_t *pid);
+static bool wait_compiler(pid_t pid);
+static bool run_compiler(char **argv, CODE_BUF *code);
+static int group_functions(int *group, size_t max_len);
+static bool create_unit_source(CODE_BUF *code, int *group, int unit);
+static bool prepare_units(struct lib_build *build);
+static void prune_work_cache(void);
+static bool compile_units(struct lib_build *build);
+static void free_build(struct lib_build *build);
+static struct lib_build *prepare_build(char *work_str);
+static bool run_build(struct lib_build *build);
+static void *build_thread(void *userdata);
+static void get_source_hash(CODE_BUF *code, char *hex);
+static const char *get_tuned_variant(char *hash);
+static bool compile_variant(struct tune_job *job, const char *variant, char *lib_path);
+static void *autotune_thread(void *userdata);
+static void start_autotune(struct lib_build *build);
+#endif
+static void get_library_path(char *work_str, char *path, int fd);
 extern bool compile_library(char *work_str);
+extern bool compile_library_async(char *work_str, void (*done)(char *work_str, bool rc));
+extern double run_benchmark(struct instance *inst, uint32_t *vm_sizes, int ms);
+extern bool library_updated(struct instance *inst, char *work_str);
+extern volatile int g_library_gen;
 extern void create_instance(struct instance* inst, char *work_str);
 extern void free_library(struct instance* inst);
+extern void get_library_file(char *work_str, char *path, int *version);
+extern void set_library_file(char *work_str, char *path, int version);
+extern void library_lock(bool lock);
+extern struct instance *acquire_instance(char *work_str);
+extern void release_instance(struct instance *inst);
+extern void library_pin(char *work_str, bool pin);
+extern void library_retire(char *work_str);
 extern bool create_opencl_source(char *work_str);
 
+// Function Prototypes - affinity.c
+extern bool affinity_set_policy(const char *str);
+extern bool affinity_init(int threads);
+extern void affinity_apply(int thr_id);
+
+// Function Prototypes - supervisor.c
+extern bool supervise_init(int workers, void *(*miner)(void *));
+extern bool supervise_start(struct thr_info *thr);
+extern void supervise_publish(struct work *thr_work);
+extern void supervise_set_ignore(bool pow, bool bty);
+
+// Function Prototypes - proxy.c
+extern bool proxy_run(const char *bind_addr, int port, const char *url, const char *userpass, int fail_pause);
+
+extern void thread_low_priority();
+extern bool vm_arena_reserve(struct vm_arena *arena, size_t size);
+extern void vm_arena_release(struct vm_arena *arena);
+
 extern void tohex(unsigned char * in, size_t insz, char * out, size_t outsz);
 int curve25519_donna(uint8_t *mypublic, const uint8_t *secret, const uint8_t *basepoint);
 
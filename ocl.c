@@ -317,6 +317,19 @@ extern bool opencl_init_buffer_data(struct opencl_device *gpu, uint32_t *base_da
 	return true;
 }
 
+extern bool opencl_load_storage(struct opencl_device *gpu, uint32_t *storage, uint32_t storage_sz) {
+	cl_uint err;
+
+	if (!gpu->obj_storage || !storage_sz)
+		return true;
+
+	// Blocking Write - The Host Buffer May Be Released Once The Miner Moves On
+	err = clEnqueueWriteBuffer(gpu->queue, gpu->obj_storage, CL_TRUE, 0, storage_sz * sizeof(uint32_t), storage, 0, NULL, NULL);
+	if (!opencl_err_check(err, "Unable to write to OpenCL 'storage' Buffer")) return false;
+
+	return true;
+}
+
 extern bool opencl_run_kernel(struct opencl_device *gpu, uint32_t *rnd_num, uint32_t *result, uint32_t *output, uint32_t *submit, uint32_t submit_sz) {
 	cl_uint err;
 
@@ -0,0 +1,730 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Proxy Mode (--proxy)
+//
+// One process keeps the session with the node and serves any number of miners on
+// the local network, which simply point '-o' at it.  It speaks the node's own HTTP
+// API, so miners need no changes: the package list is refreshed at most once per
+// PROXY_WORK_TTL seconds however many miners ask, sources are fetched once per job,
+// and storage once per package list (a new iteration changes the list).  Both are
+// dropped once their package leaves the list.  Each miner's
+// longpoll is held here and released the moment the single upstream longpoll reports
+// a new block.  Solutions and other getWork requests are passed straight through with
+// the proxy's credentials, so only the requests a miner makes are served and the proxy
+// listens on 127.0.0.1 unless --proxy-bind says otherwise.
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "miner.h"
+
+#ifndef WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define PROXY_HDR_MAX		8192				// Largest Request Line + Headers
+#define PROXY_BODY_MAX		(4 * 1024 * 1024)	// Largest Request Body
+#define PROXY_WORK_TTL		2					// Seconds The Package List Is Served From Cache
+#define PROXY_LONGPOLL_SEC	20					// Miners Time Out At --timeout (Default 30 Sec)
+
+// One Cached getWork Response
+struct proxy_entry {
+	char key[32];			// 'S' (Source) Or 'T' (Storage) + work_id
+	char *body;				// NULL Until The First Fetch Succeeds
+	size_t len;
+	uint32_t gen;			// Package List It Belongs To (0 = Never Expires)
+	bool fetching;			// An Upstream Fetch Is In Flight - Others Wait On fetch_cond
+};
+
+// One Downstream Miner Connection
+struct proxy_conn {
+	int fd;
+	CURL *curl;
+	uint32_t lp_gen;		// Last Upstream Event Passed To This Connection
+	char buf[PROXY_HDR_MAX];
+	size_t len;
+};
+
+static pthread_mutex_t proxy_lock = PTHREAD_MUTEX_INITIALIZER;	// Caches, Events & Stats
+static pthread_cond_t event_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t fetch_cond = PTHREAD_COND_INITIALIZER;	// Signalled When Any Fetch Completes
+
+static const char *up_url;
+static const char *up_userpass;
+static int up_fail_pause;
+
+static struct proxy_entry *entries = NULL;
+static int num_entries = 0;
+static int max_entries = 0;
+
+static char *work_body = NULL;
+static size_t work_len = 0;
+static time_t work_tm = 0;
+static uint32_t work_sig = 0;
+static uint32_t work_gen = 1;		// Bumped When The Package List Or Block Changes
+static bool work_fetching = false;	// A getMineableWork Fetch Is In Flight
+static struct mineable_work work_list;	// Last List Parsed - Only Used By The Fetch In Flight
+
+static char *event_body = NULL;
+static size_t event_len = 0;
+static uint32_t event_gen = 0;
+
+static int num_conns = 0;
+static uint64_t stat_req = 0, stat_hit = 0, stat_fwd = 0;
+
+static const char timeout_body[] = "{\"event\":\"timeout\"}";
+static const char upstream_err[] = "{\"errorDescription\":\"Proxy: upstream request failed\"}";
+static const char forbidden_err[] = "{\"errorDescription\":\"Proxy: requestType not allowed\"}";
+
+// Issues One Upstream Request, Returning The Raw Response Body (Caller Frees) Or NULL
+static char *upstream(CURL *curl, const char *url, const char *req, size_t *len) {
+	struct data_buffer db = { 0 };
+	char err_str[CURL_ERROR_SIZE] = { 0 };
+	int rc;
+
+	json_rpc_prepare(curl, url, up_userpass, req, &db, err_str);
+	rc = curl_easy_perform(curl);
+	curl_easy_reset(curl);
+
+	if (rc || !db.buf) {
+		if (rc)
+			applog(LOG_ERR, "ERROR: Proxy: Curl - '%s' (code=%d)", err_str, rc);
+		free(db.buf);
+		return NULL;
+	}
+
+	*len = db.len;
+	return (char *)db.buf;
+}
+
+static char *copy_body(const char *body, size_t len) {
+	char *copy = malloc(len + 1);
+
+	if (copy) {
+		memcpy(copy, body, len);
+		copy[len] = 0;
+	}
+
+	return copy;
+}
+
+static uint32_t fnv_str(uint32_t h, const char *str) {
+	while (*str) {
+		h ^= (unsigned char)*str++;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// Identifies The Package List By Its Packages & Iterations (Not The Whole Body, Which
+// Carries Timings).  Returns 0 If 'body' Isn't A Package List
+static uint32_t work_signature(const char *body, size_t len) {
+	char num[64];
+	uint32_t h = 2166136261u;
+	int i;
+
+	mineable_reset(&work_list);
+	if (!mineable_parse(&work_list, body, len) || !mineable_finish(&work_list))
+		return 0;
+
+	for (i = 0; i < work_list.num_pkg; i++) {
+		sprintf(num, "|%s|%d|%d|%d", work_list.pkg[i].id, work_list.pkg[i].iterations, work_list.pkg[i].iterations_left, work_list.pkg[i].storage_id);
+		h = fnv_str(h, num);
+	}
+
+	return h ? h : 1;
+}
+
+// Drops Entries For Packages No Longer In 'work_list' And Storage From Older Lists
+// (Caller Holds proxy_lock).  Entries Being Fetched Are Kept For Their Waiters
+static void prune_entries() {
+	struct proxy_entry *e;
+	bool listed;
+	int i, j;
+
+	for (i = 0; i < num_entries; ) {
+		e = &entries[i];
+
+		listed = false;
+		for (j = 0; j < work_list.num_pkg; j++) {
+			if (!strcmp(&e->key[1], work_list.pkg[j].id)) {
+				listed = true;
+				break;
+			}
+		}
+
+		if (e->fetching || (listed && (!e->gen || (e->gen == work_gen)))) {
+			i++;
+			continue;
+		}
+
+		free(e->body);
+		entries[i] = entries[--num_entries];
+	}
+}
+
+// Serves The Package List, Refreshing It From Upstream Once It Is PROXY_WORK_TTL Old
+static char *get_work_list(CURL *curl, size_t *len) {
+	char *body, *copy = NULL;
+	uint32_t sig;
+
+	pthread_mutex_lock(&proxy_lock);
+	stat_req++;
+
+	// Miners Asking During A Refresh Wait For It Instead Of Issuing Their Own
+	while (!(work_body && (time(NULL) - work_tm < PROXY_WORK_TTL)) && work_fetching)
+		pthread_cond_wait(&fetch_cond, &proxy_lock);
+
+	if (work_body && (time(NULL) - work_tm < PROXY_WORK_TTL)) {
+		stat_hit++;
+		copy = copy_body(work_body, work_len);
+		*len = work_len;
+		pthread_mutex_unlock(&proxy_lock);
+		return copy;
+	}
+	work_fetching = true;
+	pthread_mutex_unlock(&proxy_lock);
+
+	body = upstream(curl, up_url, "requestType=getMineableWork&n=1", len);
+	sig = body ? work_signature(body, *len) : 0;
+
+	// Errors Are Passed On, But Not Cached
+	copy = (body && sig) ? copy_body(body, *len) : body;
+
+	pthread_mutex_lock(&proxy_lock);
+	if (sig) {
+		if (sig != work_sig) {
+			work_sig = sig;
+			work_gen++;
+			prune_entries();
+		}
+		free(work_body);
+		work_body = body;
+		work_len = *len;
+		work_tm = time(NULL);
+	}
+	work_fetching = false;
+	pthread_cond_broadcast(&fetch_cond);
+	pthread_mutex_unlock(&proxy_lock);
+
+	return copy;
+}
+
+static struct proxy_entry *find_entry(const char *key) {
+	int i;
+
+	for (i = 0; i < num_entries; i++) {
+		if (!strcmp(entries[i].key, key))
+			return &entries[i];
+	}
+
+	return NULL;
+}
+
+// Adds An Empty Entry For 'key' (Caller Holds proxy_lock).  Entries Move When The Table
+// Grows, So They Are Looked Up Again After proxy_lock Is Released
+static struct proxy_entry *add_entry(const char *key) {
+	struct proxy_entry *e, *tmp;
+
+	if (num_entries == max_entries) {
+		tmp = realloc(entries, (max_entries ? 2 * max_entries : 64) * sizeof(struct proxy_entry));
+		if (!tmp)
+			return NULL;
+		entries = tmp;
+		max_entries = max_entries ? 2 * max_entries : 64;
+	}
+
+	e = &entries[num_entries++];
+	memset(e, 0, sizeof(struct proxy_entry));
+	strncpy(e->key, key, sizeof(e->key) - 1);
+
+	return e;
+}
+
+// Serves A getWork Response From Cache, Fetching It Once If Missing Or Stale ('keep' = Never Stale).
+// Requests For The Same Key Wait For The Fetch In Flight, Other Keys Are Fetched Alongside It
+static char *get_entry(CURL *curl, const char *key, bool keep, const char *req, size_t *len) {
+	struct proxy_entry *e;
+	json_t *val;
+	json_error_t err;
+	char *body, *copy = NULL;
+	uint32_t gen;
+	bool hit;
+
+	pthread_mutex_lock(&proxy_lock);
+	stat_req++;
+
+	while (1) {
+		e = find_entry(key);
+		hit = e && e->body && (keep || (e->gen == work_gen));
+		if (hit || !e || !e->fetching)
+			break;
+		pthread_cond_wait(&fetch_cond, &proxy_lock);
+	}
+
+	if (hit) {
+		stat_hit++;
+		copy = copy_body(e->body, e->len);
+		*len = e->len;
+		pthread_mutex_unlock(&proxy_lock);
+		return copy;
+	}
+
+	if (!e)
+		e = add_entry(key);
+	if (e)
+		e->fetching = true;
+	gen = keep ? 0 : work_gen;
+	pthread_mutex_unlock(&proxy_lock);
+
+	body = upstream(curl, up_url, req, len);
+	copy = body ? copy_body(body, *len) : NULL;
+
+	// Only Cache Responses Holding The Package
+	val = body ? JSON_LOADS(body, &err) : NULL;
+	if (!val || (json_array_size(json_object_get(val, "work_packages")) != 1)) {
+		free(body);
+		body = NULL;
+	}
+	if (val)
+		json_decref(val);
+
+	pthread_mutex_lock(&proxy_lock);
+	e = find_entry(key);
+	if (e) {
+		if (body) {
+			free(e->body);
+			e->body = body;
+			e->len = *len;
+			e->gen = gen;
+			body = NULL;
+		}
+		e->fetching = false;
+	}
+	pthread_cond_broadcast(&fetch_cond);
+	pthread_mutex_unlock(&proxy_lock);
+
+	free(body);
+
+	return copy;
+}
+
+// Holds A Miner's Longpoll Until Upstream Reports An Event Or PROXY_LONGPOLL_SEC Pass
+static char *wait_event(struct proxy_conn *conn, size_t *len) {
+	struct timespec ts;
+	char *copy;
+	int rc = 0;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += PROXY_LONGPOLL_SEC;
+
+	pthread_mutex_lock(&proxy_lock);
+	while ((conn->lp_gen == event_gen) && (rc != ETIMEDOUT))
+		rc = pthread_cond_timedwait(&event_cond, &proxy_lock, &ts);
+
+	if (conn->lp_gen != event_gen) {
+		conn->lp_gen = event_gen;
+		copy = copy_body(event_body, event_len);
+		*len = event_len;
+	}
+	else {
+		copy = copy_body(timeout_body, sizeof(timeout_body) - 1);
+		*len = sizeof(timeout_body) - 1;
+	}
+	pthread_mutex_unlock(&proxy_lock);
+
+	return copy;
+}
+
+// The Only Longpoll Held With The Node - Events Are Relayed To Every Miner
+static void *longpoll_thread(void *userdata) {
+	CURL *curl;
+	json_t *val, *obj;
+	json_error_t err;
+	char *body;
+	size_t len;
+	uint64_t req, hit, fwd;
+	int conns;
+
+	pthread_detach(pthread_self());
+
+	curl = curl_easy_init();
+	if (!curl) {
+		applog(LOG_ERR, "CURL initialization failed");
+		return NULL;
+	}
+
+	while (1) {
+		body = upstream(curl, up_url, "requestType=longpoll&randomId=1", &len);
+		val = body ? JSON_LOADS(body, &err) : NULL;
+		obj = val ? json_object_get(val, "event") : NULL;
+
+		if (!obj) {
+			applog(LOG_ERR, "ERROR: Proxy: longpoll failed...retrying in %d seconds", up_fail_pause);
+			if (val)
+				json_decref(val);
+			free(body);
+			sleep(up_fail_pause);
+			continue;
+		}
+
+		if (json_is_string(obj) && !strcmp(json_string_value(obj), "timeout")) {
+			json_decref(val);
+			free(body);
+			continue;
+		}
+		json_decref(val);
+
+		// Stale Package List & Storage Are Dropped Before Any Miner Asks Again
+		pthread_mutex_lock(&proxy_lock);
+		free(event_body);
+		event_body = body;
+		event_len = len;
+		event_gen++;
+		work_gen++;
+		work_tm = 0;
+		conns = num_conns;
+		req = stat_req;
+		hit = stat_hit;
+		fwd = stat_fwd;
+		pthread_cond_broadcast(&event_cond);
+		pthread_mutex_unlock(&proxy_lock);
+
+		applog(LOG_NOTICE, "Proxy: new block - %d open miner %s (%llu requests, %llu from cache, %llu forwarded)", conns,
+			(conns == 1) ? "connection" : "connections", (unsigned long long)req, (unsigned long long)hit, (unsigned long long)fwd);
+	}
+
+	return NULL;
+}
+
+// Returns The Value Of 'name' In An 'a=b&c=d' String
+static bool get_param(const char *params, const char *name, char *out, size_t out_sz) {
+	size_t n = strlen(name), i = 0;
+	const char *p = params;
+
+	while (p && *p) {
+		if (!strncmp(p, name, n) && (p[n] == '=')) {
+			p += n + 1;
+			while (*p && (*p != '&') && (i < out_sz - 1))
+				out[i++] = *p++;
+			out[i] = 0;
+			return true;
+		}
+		p = strchr(p, '&');
+		if (p)
+			p++;
+	}
+
+	return false;
+}
+
+static bool send_all(int fd, const char *buf, size_t len) {
+	ssize_t n;
+
+	while (len) {
+		n = send(fd, buf, len, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		buf += n;
+		len -= n;
+	}
+
+	return true;
+}
+
+static bool send_response(int fd, int status, const char *body, size_t len) {
+	char hdr[200];
+
+	sprintf(hdr, "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %lu\r\n\r\n",
+		status, (status == 200) ? "OK" : (status == 403) ? "Forbidden" : "Bad Gateway", (unsigned long)len);
+
+	return send_all(fd, hdr, strlen(hdr)) && send_all(fd, body, len);
+}
+
+// Reads The Next Request On The Connection.  'query' Points Into 'conn->buf' (After '?'),
+// 'body' Is Allocated.  Returns false Once The Miner Disconnects Or Sends Garbage
+static bool read_request(struct proxy_conn *conn, char **query, char **body, size_t *hdr_len) {
+	char *end = NULL, *line, *next, *path, *p;
+	size_t body_len = 0, have;
+	ssize_t n;
+
+	*query = NULL;
+	*body = NULL;
+
+	// Request Line & Headers
+	while (1) {
+		conn->buf[conn->len] = 0;
+		end = strstr(conn->buf, "\r\n\r\n");
+		if (end)
+			break;
+		if (conn->len >= PROXY_HDR_MAX - 1)
+			return false;
+		n = recv(conn->fd, conn->buf + conn->len, PROXY_HDR_MAX - 1 - conn->len, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		conn->len += n;
+	}
+
+	*hdr_len = (end - conn->buf) + 4;
+	end[2] = 0;
+
+	// Path & Query String
+	line = conn->buf;
+	next = strstr(line, "\r\n");
+	*next = 0;
+	path = strchr(line, ' ');
+	if (!path)
+		return false;
+	path++;
+	p = strchr(path, ' ');
+	if (p)
+		*p = 0;
+	p = strchr(path, '?');
+	if (p) {
+		*p = 0;
+		*query = p + 1;
+	}
+
+	// Headers (Each Still Ends With CRLF)
+	for (line = next + 2; (next = strstr(line, "\r\n")); line = next + 2) {
+		*next = 0;
+		if (!strncasecmp(line, "Content-Length:", 15))
+			body_len = strtoul(line + 15, NULL, 10);
+		else if (!strncasecmp(line, "Expect:", 7) && strstr(line, "100-continue"))
+			send_all(conn->fd, "HTTP/1.1 100 Continue\r\n\r\n", 25);
+	}
+
+	if (body_len > PROXY_BODY_MAX)
+		return false;
+
+	*body = malloc(body_len + 1);
+	if (!*body)
+		return false;
+
+	// Body Bytes Already Read With The Headers, Then The Rest
+	have = conn->len - *hdr_len;
+	if (have > body_len)
+		have = body_len;
+	memcpy(*body, conn->buf + *hdr_len, have);
+
+	while (have < body_len) {
+		n = recv(conn->fd, *body + have, body_len - have, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0) {
+			free(*body);
+			*body = NULL;
+			return false;
+		}
+		have += n;
+	}
+	(*body)[body_len] = 0;
+
+	*hdr_len += (conn->len - *hdr_len < body_len) ? (conn->len - *hdr_len) : body_len;
+
+	return true;
+}
+
+static void handle_request(struct proxy_conn *conn, const char *query, const char *body) {
+	char *params, *rsp = NULL, *url;
+	char type[32], work_id[24], val[16], key[32], req[250];
+	size_t len = 0;
+
+	params = malloc(strlen(query ? query : "") + strlen(body) + 2);
+	if (!params)
+		return;
+	sprintf(params, "%s&%s", query ? query : "", body);
+
+	if (!get_param(params, "requestType", type, sizeof(type)))
+		type[0] = 0;
+
+	if (!strcmp(type, "getMineableWork")) {
+		rsp = get_work_list(conn->curl, &len);
+	}
+	else if (!strcmp(type, "longpoll")) {
+		rsp = wait_event(conn, &len);
+	}
+	else if (!strcmp(type, "getWork") && get_param(params, "work_id", work_id, sizeof(work_id)) && get_param(params, "with_storage", val, sizeof(val)) && !strcmp(val, "true")) {
+		sprintf(key, "T%s", work_id);
+		sprintf(req, "requestType=getWork&work_id=%s&with_source=false&with_finished=false&with_storage=true", work_id);
+		rsp = get_entry(conn->curl, key, false, req, &len);
+	}
+	else if (!strcmp(type, "getWork") && get_param(params, "work_id", work_id, sizeof(work_id)) && get_param(params, "with_source", val, sizeof(val)) && (!strcmp(val, "1") || !strcmp(val, "true"))) {
+		sprintf(key, "S%s", work_id);
+		sprintf(req, "requestType=getWork&work_id=%s&with_source=1&with_finished=0", work_id);
+		rsp = get_entry(conn->curl, key, true, req, &len);
+	}
+	else if (strcmp(type, "getWork") && strcmp(type, "submitSolution")) {
+		// Nothing Else Is Relayed Under The Proxy's Credentials
+		applog(LOG_DEBUG, "DEBUG: Proxy: refused requestType '%s'", type);
+		send_response(conn->fd, 403, forbidden_err, sizeof(forbidden_err) - 1);
+		free(params);
+		return;
+	}
+	else {
+		// Solutions & Other getWork Requests Go Straight Through
+		url = malloc(strlen(up_url) + strlen(query ? query : "") + 2);
+		if (url) {
+			if (query && *query)
+				sprintf(url, "%s%c%s", up_url, strchr(up_url, '?') ? '&' : '?', query);
+			else
+				strcpy(url, up_url);
+			rsp = upstream(conn->curl, url, body, &len);
+			free(url);
+		}
+		pthread_mutex_lock(&proxy_lock);
+		stat_fwd++;
+		pthread_mutex_unlock(&proxy_lock);
+	}
+
+	if (rsp)
+		send_response(conn->fd, 200, rsp, len);
+	else
+		send_response(conn->fd, 502, upstream_err, sizeof(upstream_err) - 1);
+
+	free(rsp);
+	free(params);
+}
+
+static void *conn_thread(void *userdata) {
+	struct proxy_conn *conn = (struct proxy_conn *)userdata;
+	char *query, *body;
+	size_t used;
+
+	pthread_detach(pthread_self());
+
+	conn->curl = curl_easy_init();
+
+	while (conn->curl && read_request(conn, &query, &body, &used)) {
+		handle_request(conn, query, body);
+		free(body);
+
+		// Keep Anything Sent After This Request
+		memmove(conn->buf, conn->buf + used, conn->len - used);
+		conn->len -= used;
+	}
+
+	close(conn->fd);
+	if (conn->curl)
+		curl_easy_cleanup(conn->curl);
+
+	pthread_mutex_lock(&proxy_lock);
+	num_conns--;
+	pthread_mutex_unlock(&proxy_lock);
+
+	applog(LOG_DEBUG, "DEBUG: Proxy: miner disconnected");
+	free(conn);
+
+	return NULL;
+}
+
+// Serves Miners On 'bind_addr':'port' Until The Process Exits.  Returns false If It Can't Start
+extern bool proxy_run(const char *bind_addr, int port, const char *url, const char *userpass, int fail_pause) {
+	struct sockaddr_in addr;
+	struct proxy_conn *conn;
+	pthread_t thr;
+	int fd, cfd, one = 1;
+
+	up_url = url;
+	up_userpass = userpass;
+	up_fail_pause = fail_pause;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)port);
+	if (inet_pton(AF_INET, bind_addr, &addr.sin_addr) != 1) {
+		applog(LOG_ERR, "ERROR: Proxy: Invalid bind address '%s'", bind_addr);
+		return false;
+	}
+
+	// Miners That Drop Mid-Response Must Not Take The Proxy Down
+	signal(SIGPIPE, SIG_IGN);
+
+	fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd < 0) {
+		applog(LOG_ERR, "ERROR: Proxy: Unable to create socket");
+		return false;
+	}
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) || listen(fd, 128)) {
+		applog(LOG_ERR, "ERROR: Proxy: Unable to listen on %s:%d (%s)", bind_addr, port, strerror(errno));
+		close(fd);
+		return false;
+	}
+
+	if (pthread_create(&thr, NULL, longpoll_thread, NULL)) {
+		applog(LOG_ERR, "Proxy longpoll thread create failed");
+		close(fd);
+		return false;
+	}
+
+	applog(LOG_INFO, "Proxy: serving work from %s on %s:%d", up_url, bind_addr, port);
+
+	while (1) {
+		cfd = accept(fd, NULL, NULL);
+		if (cfd < 0) {
+			if (errno != EINTR)
+				applog(LOG_ERR, "ERROR: Proxy: accept failed (%s)", strerror(errno));
+			continue;
+		}
+		setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		conn = calloc(1, sizeof(struct proxy_conn));
+		if (!conn) {
+			close(cfd);
+			continue;
+		}
+		conn->fd = cfd;
+
+		pthread_mutex_lock(&proxy_lock);
+		conn->lp_gen = event_gen;
+		num_conns++;
+		pthread_mutex_unlock(&proxy_lock);
+
+		if (pthread_create(&thr, NULL, conn_thread, conn)) {
+			applog(LOG_ERR, "Proxy connection thread create failed");
+			pthread_mutex_lock(&proxy_lock);
+			num_conns--;
+			pthread_mutex_unlock(&proxy_lock);
+			close(cfd);
+			free(conn);
+			continue;
+		}
+
+		applog(LOG_DEBUG, "DEBUG: Proxy: miner connected");
+	}
+
+	return true;
+}
+
+#else
+
+extern bool proxy_run(const char *bind_addr, int port, const char *url, const char *userpass, int fail_pause) {
+	applog(LOG_ERR, "ERROR: --proxy is not supported on Windows");
+	return false;
+}
+
+#endif
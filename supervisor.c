@@ -0,0 +1,513 @@
+/*
+* Copyright 2016 sprocket
+*
+* This program is free software; you can redistribute it and/or modify it
+* under the terms of the GNU General Public License as published by the Free
+* Software Foundation; either version 2 of the License, or (at your option)
+* any later version.
+*/
+
+// Supervisor Mode (--supervise)
+//
+// The coordinator process keeps networking, compiling and the submit queue, and
+// every CPU miner thread runs in a worker process of its own.  The two sides only
+// talk through a shared memory board: a slot per package being mined (work, package
+// details, storage & the path of the job library), the shared round counter, and
+// per worker its assignment and a ring of solutions.  A job that crashes only takes
+// its worker down; the worker is forked again right away, and a package that keeps
+// crashing workers is blacklisted while the others keep mining.
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "miner.h"
+
+#ifndef WIN32
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define BOARD_DATA_MAX	65536	// Largest Storage / Submit Data (Unsigned Ints) Passed Through The Board
+#define BOARD_RING_SIZE	8		// Solutions A Worker Can Have Waiting For The Coordinator
+#define MAX_CRASHES		3		// Worker Crashes Before A Package Is Blacklisted
+
+struct board_slot {
+	volatile uint32_t seq;		// Odd While The Coordinator Rewrites The Slot
+	struct work work;
+	struct work_package pkg;	// Pointers Are Only Valid In The Coordinator
+	char lib_path[100];
+	int lib_version;
+	uint32_t storage[BOARD_DATA_MAX];
+};
+
+struct board_solution {
+	enum submit_commands cmd;
+	struct work work;
+	uint32_t data_sz;
+	uint32_t data[BOARD_DATA_MAX];
+};
+
+struct board_worker {
+	volatile pid_t pid;
+	volatile uint32_t gen;		// Bumped Each Time Work Is Published For The Worker
+	volatile int slot;			// Slot Holding Its Work (-1 = None)
+	volatile uint64_t work_id;	// Package The Worker Is Running, Blamed If It Dies
+	volatile uint32_t head;		// Solutions Written (Worker)
+	volatile uint32_t tail;		// Solutions Taken (Coordinator)
+	struct board_solution ring[BOARD_RING_SIZE];
+};
+
+// Waits Are Plain Futexes On The Counters Below - Unlike A Shared Mutex Or Condition
+// Variable They Hold No State A Worker Could Take Down With It
+struct work_board {
+	volatile uint32_t gen;		// Bumped On New Work Or Ignore Flags
+	volatile uint32_t sol_gen;	// Bumped When A Worker Queues A Solution
+	volatile bool pow_ignore;
+	volatile bool bty_ignore;
+	volatile uint64_t nonce_next;
+	struct board_slot slot[MAX_PORTFOLIO];
+	struct board_worker worker[];
+};
+
+struct crash_count {
+	uint64_t work_id;
+	int cnt;
+};
+
+static struct work_board *board = NULL;
+static size_t board_sz = 0;
+static int board_workers = 0;
+static void *(*board_miner)(void *) = NULL;
+static pid_t coordinator_pid = 0;
+static time_t *spawn_tm = NULL;
+static struct crash_count *crashes = NULL;
+static int crash_cnt = 0;
+static int worker_id = -1;		// Set In Worker Processes Only
+
+// Sleep Until '*gen' Moves Away From 'val' Or 'ms' Pass
+static void board_wait(volatile uint32_t *gen, uint32_t val, int ms) {
+	struct timespec ts;
+
+	ts.tv_sec = ms / 1000;
+	ts.tv_nsec = (ms % 1000) * 1000000L;
+	syscall(SYS_futex, gen, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static void board_bump(volatile uint32_t *gen) {
+	ATOMIC_INC(gen);
+	syscall(SYS_futex, gen, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+extern bool supervise_init(int workers, void *(*miner)(void *)) {
+	int i;
+
+	board_sz = sizeof(struct work_board) + workers * sizeof(struct board_worker);
+
+	// Anonymous Shared Pages Are Inherited By Every Worker & Only Backed Once Touched
+	board = mmap(NULL, board_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (board == MAP_FAILED) {
+		board = NULL;
+		applog(LOG_ERR, "ERROR: Unable to map work board (%s)", strerror(errno));
+		return false;
+	}
+
+	spawn_tm = calloc(workers, sizeof(time_t));
+	if (!spawn_tm) {
+		munmap(board, board_sz);
+		board = NULL;
+		return false;
+	}
+
+	for (i = 0; i < workers; i++)
+		board->worker[i].slot = -1;
+
+	// Rounds Must Stay Unique Across All Workers
+	nonce_share(&board->nonce_next);
+
+	board_workers = workers;
+	board_miner = miner;
+	coordinator_pid = getpid();
+
+	return true;
+}
+
+// Coordinator - Post The Work Of Each Miner Thread (Called With work_lock Held)
+extern void supervise_publish(struct work *thr_work) {
+	static uint64_t oversize_id = 0;
+	static char pinned[MAX_PORTFOLIO][22];
+	static int num_pinned = 0;
+	struct board_slot *s;
+	struct work_package *wp;
+	uint64_t slot_id[MAX_PORTFOLIO];
+	int i, j, cnt = 0;
+
+	if (!board)
+		return;
+
+	for (i = 0; i < board_workers; i++) {
+		j = -1;
+
+		if (thr_work[i].work_id) {
+			wp = &g_work_package[thr_work[i].package_id];
+
+			for (j = 0; j < cnt; j++) {
+				if (slot_id[j] == thr_work[i].work_id)
+					break;
+			}
+
+			if ((wp->storage_sz > BOARD_DATA_MAX) || (wp->submit_sz > BOARD_DATA_MAX)) {
+				if (oversize_id != wp->work_id)
+					applog(LOG_ERR, "ERROR: Storage of work_id %s is too large for --supervise", wp->work_str);
+				oversize_id = wp->work_id;
+				j = -1;
+			}
+			else if ((j == cnt) && (cnt < MAX_PORTFOLIO)) {
+				s = &board->slot[cnt];
+
+				ATOMIC_INC(&s->seq);
+				memcpy(&s->work, &thr_work[i], sizeof(struct work));
+				memcpy(&s->pkg, wp, sizeof(struct work_package));
+				match_storage(&s->work, &s->pkg);
+				s->pkg.storage = NULL;
+				if (wp->storage)
+					memcpy(s->storage, wp->storage->data, wp->storage_sz * sizeof(uint32_t));
+				else
+					memset(s->storage, 0, wp->storage_sz * sizeof(uint32_t));
+				get_library_file((char *)wp->work_str, s->lib_path, &s->lib_version);
+				ATOMIC_INC(&s->seq);
+
+				slot_id[cnt++] = thr_work[i].work_id;
+			}
+			else if (j == cnt) {
+				j = -1;
+			}
+		}
+
+		board->worker[i].slot = j;
+		ATOMIC_INC(&board->worker[i].gen);
+	}
+
+	// Libraries On The Board Stay Loadable Until The Slots Move On
+	for (j = 0; j < cnt; j++)
+		library_pin((char *)board->slot[j].pkg.work_str, true);
+	for (j = 0; j < num_pinned; j++)
+		library_pin(pinned[j], false);
+	for (j = 0; j < cnt; j++)
+		snprintf(pinned[j], sizeof(pinned[j]), "%s", board->slot[j].pkg.work_str);
+	num_pinned = cnt;
+
+	board_bump(&board->gen);
+}
+
+// Coordinator - Mirror The Global Ignore Flags Into The Workers
+extern void supervise_set_ignore(bool pow, bool bty) {
+	if (!board)
+		return;
+
+	ATOMIC_STORE(&board->pow_ignore, pow);
+	ATOMIC_STORE(&board->bty_ignore, bty);
+	board_bump(&board->gen);
+}
+
+// Worker - Copy The Current Assignment Out Of The Board, Retrying While It Changes
+static bool read_assignment(struct board_worker *w, struct work *work, struct work_package *pkg, uint32_t **storage, char *lib_path, int *lib_version) {
+	struct board_slot *s;
+	uint32_t gen, seq;
+	int slot;
+
+	while (1) {
+		gen = ATOMIC_LOAD(&w->gen);
+		slot = w->slot;
+
+		if (slot < 0) {
+			memset(work, 0, sizeof(struct work));
+			memset(pkg, 0, sizeof(struct work_package));
+		}
+		else {
+			s = &board->slot[slot];
+			seq = ATOMIC_LOAD(&s->seq);
+			if (seq & 1) {
+				sched_yield();
+				continue;
+			}
+
+			memcpy(work, &s->work, sizeof(struct work));
+			memcpy(pkg, &s->pkg, sizeof(struct work_package));
+			strcpy(lib_path, s->lib_path);
+			*lib_version = s->lib_version;
+
+			*storage = realloc(*storage, (pkg->storage_sz ? pkg->storage_sz : 1) * sizeof(uint32_t));
+			if (!*storage)
+				return false;
+			memcpy(*storage, s->storage, pkg->storage_sz * sizeof(uint32_t));
+
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (ATOMIC_LOAD(&s->seq) != seq)
+				continue;
+		}
+
+		if (ATOMIC_LOAD(&w->gen) == gen)
+			return true;
+	}
+}
+
+// Worker - Hand New Work From The Board To The Miner Thread
+static void *board_watch_thread(void *userdata) {
+	struct board_worker *w = &board->worker[worker_id];
+	struct work work;
+	struct work_package pkg;
+	uint32_t *storage = NULL, gen = 0, thr_gen = 0;
+	char lib_path[100];
+	int lib_version;
+
+	while (1) {
+		board_wait(&board->gen, gen, 1000);
+		if (ATOMIC_LOAD(&board->gen) == gen)
+			continue;
+		gen = ATOMIC_LOAD(&board->gen);
+
+		if (ATOMIC_LOAD(&w->gen) != thr_gen) {
+			thr_gen = ATOMIC_LOAD(&w->gen);
+
+			if (!read_assignment(w, &work, &pkg, &storage, lib_path, &lib_version)) {
+				applog(LOG_ERR, "CPU%d: Unable to allocate storage", worker_id);
+				_exit(EXIT_FAILURE);
+			}
+
+			if (work.work_id)
+				set_library_file((char *)work.work_str, lib_path, lib_version);
+			w->work_id = work.work_id;
+
+			deliver_work(worker_id, &work, &pkg, storage);
+		}
+
+		set_ignore_flags(ATOMIC_LOAD(&board->pow_ignore), ATOMIC_LOAD(&board->bty_ignore));
+	}
+
+	return NULL;
+}
+
+// Worker - Pass Solutions From The Miner Thread To The Coordinator
+static void *board_relay_thread(void *userdata) {
+	struct thr_info *mythr = (struct thr_info *) userdata;
+	struct board_worker *w = &board->worker[worker_id];
+	struct board_solution *sol;
+	struct workio_cmd *wc;
+
+	while (1) {
+		wc = (struct workio_cmd *) tq_pop(mythr->q, NULL);
+		if (!wc)
+			continue;
+
+		// Coordinator Is Behind
+		while ((w->head - ATOMIC_LOAD(&w->tail)) >= BOARD_RING_SIZE)
+			usleep(10000);
+
+		sol = &w->ring[w->head % BOARD_RING_SIZE];
+		sol->cmd = wc->cmd;
+		memcpy(&sol->work, &wc->work, sizeof(struct work));
+		sol->data_sz = wc->submit_data ? wc->submit_sz : 0;
+		if (sol->data_sz)
+			memcpy(sol->data, wc->submit_data, sol->data_sz * sizeof(uint32_t));
+
+		// Only Published Once Complete, So A Crash Never Leaves Half A Solution
+		ATOMIC_STORE(&w->head, w->head + 1);
+		board_bump(&board->sol_gen);
+
+		if (wc->submit_data)
+			free(wc->submit_data);
+		free(wc);
+	}
+
+	return NULL;
+}
+
+static void run_worker(int thr_id) {
+	struct thr_info *thr;
+
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+	if (getppid() != coordinator_pid)
+		_exit(0);
+
+	// Ctrl+C Reaches The Whole Process Group, Only The Coordinator Handles It
+	signal(SIGINT, SIG_IGN);
+
+	worker_id = thr_id;
+
+	// Solutions Go To The Relay Thread Instead Of The Coordinator's Submit Queue
+	thr = &thr_info[submit_thr_id];
+	thr->q = tq_new();
+	if (!thr->q || pthread_create(&thr->pth, NULL, board_relay_thread, thr)) {
+		applog(LOG_ERR, "CPU%d: Unable to start worker relay", thr_id);
+		_exit(EXIT_FAILURE);
+	}
+
+	thr = &thr_info[opt_n_threads + 1];
+	if (pthread_create(&thr->pth, NULL, board_watch_thread, thr)) {
+		applog(LOG_ERR, "CPU%d: Unable to start worker", thr_id);
+		_exit(EXIT_FAILURE);
+	}
+
+	board_miner(&thr_info[thr_id]);
+
+	_exit(EXIT_FAILURE);
+}
+
+static bool spawn_worker(int thr_id) {
+	pid_t pid;
+
+	pid = fork();
+	if (pid < 0) {
+		applog(LOG_ERR, "ERROR: Unable to fork worker for CPU%d (%s)", thr_id, strerror(errno));
+		return false;
+	}
+
+	if (pid == 0)
+		run_worker(thr_id);
+
+	board->worker[thr_id].pid = pid;
+	spawn_tm[thr_id] = time(NULL);
+
+	// Let The New Process Pick Up The Current Work
+	ATOMIC_INC(&board->worker[thr_id].gen);
+	board_bump(&board->gen);
+
+	return true;
+}
+
+// Coordinator - Blacklist A Package Once It Has Crashed Too Many Workers
+static void count_crash(uint64_t work_id) {
+	struct crash_count *list;
+	int i;
+
+	for (i = 0; i < crash_cnt; i++) {
+		if (crashes[i].work_id == work_id)
+			break;
+	}
+
+	if (i == crash_cnt) {
+		list = realloc(crashes, (crash_cnt + 1) * sizeof(struct crash_count));
+		if (!list)
+			return;
+		crashes = list;
+		crashes[crash_cnt].work_id = work_id;
+		crashes[crash_cnt++].cnt = 0;
+	}
+
+	if (++crashes[i].cnt == MAX_CRASHES) {
+		applog(LOG_ERR, "ERROR: work_id %llu crashed %d workers...blacklisting it", (unsigned long long)work_id, MAX_CRASHES);
+		blacklist_package(work_id);
+	}
+}
+
+static void relay_solutions(int thr_id) {
+	struct board_worker *w = &board->worker[thr_id];
+	struct board_solution *sol;
+	struct workio_cmd *wc;
+
+	while (ATOMIC_LOAD(&w->tail) != ATOMIC_LOAD(&w->head)) {
+		sol = &w->ring[w->tail % BOARD_RING_SIZE];
+
+		wc = (struct workio_cmd *) calloc(1, sizeof(*wc));
+		if (wc) {
+			wc->cmd = sol->cmd;
+			wc->thr = &thr_info[thr_id];
+			memcpy(&wc->work, &sol->work, sizeof(struct work));
+			if (sol->data_sz) {
+				wc->submit_sz = sol->data_sz;
+				wc->submit_data = malloc(sol->data_sz * sizeof(uint32_t));
+				if (wc->submit_data)
+					memcpy(wc->submit_data, sol->data, sol->data_sz * sizeof(uint32_t));
+			}
+
+			if (!submit_push(wc)) {
+				if (wc->submit_data)
+					free(wc->submit_data);
+				free(wc);
+			}
+		}
+
+		ATOMIC_STORE(&w->tail, w->tail + 1);
+	}
+}
+
+static void *supervise_thread(void *userdata) {
+	struct board_worker *w;
+	uint32_t sol_gen = 0;
+	int i, status;
+	pid_t pid;
+
+	while (1) {
+		board_wait(&board->sol_gen, sol_gen, 50);
+		sol_gen = ATOMIC_LOAD(&board->sol_gen);
+
+		for (i = 0; i < board_workers; i++) {
+			w = &board->worker[i];
+
+			relay_solutions(i);
+
+			// Only Reap Workers - The Compiler Waits For Its Own Children
+			if (w->pid > 0) {
+				pid = waitpid(w->pid, &status, WNOHANG);
+				if (pid != w->pid)
+					continue;
+
+				if (WIFSIGNALED(status))
+					applog(LOG_ERR, "CPU%d: Worker killed by signal %d (work_id %llu)...restarting", i, WTERMSIG(status), (unsigned long long)w->work_id);
+				else
+					applog(LOG_ERR, "CPU%d: Worker exited with status %d (work_id %llu)...restarting", i, WEXITSTATUS(status), (unsigned long long)w->work_id);
+
+				if (w->work_id)
+					count_crash(w->work_id);
+				w->pid = 0;
+				w->work_id = 0;
+			}
+
+			// Workers That Die Right After Starting Are Restarted At Most Once A Second
+			if ((w->pid == 0) && (time(NULL) - spawn_tm[i] >= 1))
+				spawn_worker(i);
+		}
+	}
+
+	return NULL;
+}
+
+extern bool supervise_start(struct thr_info *thr) {
+	int i;
+
+	for (i = 0; i < board_workers; i++) {
+		if (!spawn_worker(i))
+			return false;
+	}
+
+	if (pthread_create(&thr->pth, NULL, supervise_thread, thr)) {
+		applog(LOG_ERR, "Supervisor thread create failed");
+		return false;
+	}
+
+	return true;
+}
+
+#else
+
+extern bool supervise_init(int workers, void *(*miner)(void *)) {
+	applog(LOG_ERR, "ERROR: --supervise is not supported on Windows");
+	return false;
+}
+
+extern void supervise_publish(struct work *thr_work) {}
+extern void supervise_set_ignore(bool pow, bool bty) {}
+extern bool supervise_start(struct thr_info *thr) { return false; }
+
+#endif
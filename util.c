@@ -88,6 +88,17 @@ void tq_thaw(struct thread_q *tq)
 	tq_freezethaw(tq, false);
 }
 
+// Wakes The Thread Blocked In tq_pop (Or Its Next Call) Without Queuing Anything
+void tq_wake(struct thread_q *tq)
+{
+	pthread_mutex_lock(&tq->mutex);
+
+	tq->wake = true;
+
+	pthread_cond_signal(&tq->cond);
+	pthread_mutex_unlock(&tq->mutex);
+}
+
 bool tq_push(struct thread_q *tq, void *data) {
 	struct tq_ent *ent;
 	bool rc = true;
@@ -125,6 +136,9 @@ void *tq_pop(struct thread_q *tq, const struct timespec *abstime) {
 	if (!list_empty(&tq->q))
 		goto pop;
 
+	if (tq->wake)
+		goto out;
+
 	if (abstime)
 		rc = pthread_cond_timedwait(&tq->cond, &tq->mutex, abstime);
 	else
@@ -142,6 +156,7 @@ pop:
 	free(ent);
 
 out:
+	tq->wake = false;
 	pthread_mutex_unlock(&tq->mutex);
 	return rval;
 }
@@ -403,15 +418,8 @@ static size_t all_data_cb(const void *ptr, size_t size, size_t nmemb, void *user
 	return len;
 }
 
-json_t* json_rpc_call(CURL *curl, const char *url, const char *userpass, const char *req, int *curl_err) {
-	json_t *val = NULL;
-	int rc;
-	struct data_buffer all_data = { 0 };
-	json_error_t err;
-	char curl_err_str[CURL_ERROR_SIZE] = { 0 };
-
-	*curl_err = 0;
-
+// Sets Up 'curl' For A JSON RPC Request Whose Response Is Collected In 'db'
+extern void json_rpc_prepare(CURL *curl, const char *url, const char *userpass, const char *req, struct data_buffer *db, char *curl_err_str) {
 	curl_easy_setopt(curl, CURLOPT_URL, url);
 	curl_easy_setopt(curl, CURLOPT_POST, 1);
 	curl_easy_setopt(curl, CURLOPT_POSTFIELDS, req);
@@ -421,7 +429,7 @@ json_t* json_rpc_call(CURL *curl, const char *url, const char *userpass, const c
 	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
 	curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1);
 	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, all_data_cb);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &all_data);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, db);
 	curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, curl_err_str);
 	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
 	curl_easy_setopt(curl, CURLOPT_TIMEOUT, opt_timeout);
@@ -432,36 +440,439 @@ json_t* json_rpc_call(CURL *curl, const char *url, const char *userpass, const c
 
 	if (opt_protocol)
 		applog(LOG_DEBUG, "DEBUG: RPC Request - %s", req);
+}
+
+// Decodes The Response Of A Finished Request ('rc' Is The Curl Result) & Frees 'db'
+extern json_t* json_rpc_result(int rc, struct data_buffer *db, const char *curl_err_str, int *curl_err) {
+	json_t *val = NULL;
+	json_error_t err;
+
+	*curl_err = 0;
 
-	rc = curl_easy_perform(curl);
 	if (rc) {
 		applog(LOG_ERR, "ERROR: Curl - '%s' (code=%d)", curl_err_str, rc);
 		*curl_err = rc;
 		goto err_out;
 	}
 
-	if (!all_data.buf) {
+	if (!db->buf) {
 		applog(LOG_ERR, "ERROR: Curl did not return any data in 'json_rpc_call'");
 		*curl_err = -1;
 		goto err_out;
 	}
 
-	val = JSON_LOADS(all_data.buf, &err);
+	val = JSON_LOADS(db->buf, &err);
 	if (!val) {
 		applog(LOG_ERR, "ERROR: JSON decode failed (code=%d): %s", err.line, err.text);
 		*curl_err = -2;
 		goto err_out;
 	}
 
-	databuf_free(&all_data);
+err_out:
+	databuf_free(db);
+	return val;
+}
+
+json_t* json_rpc_call(CURL *curl, const char *url, const char *userpass, const char *req, int *curl_err) {
+	json_t *val;
+	int rc;
+	struct data_buffer all_data = { 0 };
+	char curl_err_str[CURL_ERROR_SIZE] = { 0 };
+
+	json_rpc_prepare(curl, url, userpass, req, &all_data, curl_err_str);
+	rc = curl_easy_perform(curl);
+	val = json_rpc_result(rc, &all_data, curl_err_str, curl_err);
+
 	curl_easy_reset(curl);
 	return val;
+}
 
-err_out:
-	databuf_free(&all_data);
-	if (val) json_decref(val);
+// Tokenizer States Of The getMineableWork Stream Parser
+#define MW_LEX_NONE	0
+#define MW_LEX_STR	1
+#define MW_LEX_ESC	2
+#define MW_LEX_LIT	3
+
+// Clears The Parser For A New Response, Keeping The Package Buffer
+extern void mineable_reset(struct mineable_work *mw) {
+	struct mineable_pkg *pkg = mw->pkg;
+	int max_pkg = mw->max_pkg;
+
+	memset(mw, 0, sizeof(struct mineable_work));
+	mw->pkg = pkg;
+	mw->max_pkg = max_pkg;
+}
+
+static bool mineable_str(char *dst, size_t dst_sz, const char *tok, int tok_len) {
+	if (tok_len >= (int)dst_sz)
+		return false;
+	memcpy(dst, tok, tok_len + 1);
+	return true;
+}
+
+static uint64_t mineable_num(const char *tok) {
+	// The Node May Send Rewards As Decimals
+	if (strpbrk(tok, ".eE"))
+		return (uint64_t)strtod(tok, NULL);
+	return strtoull(tok, NULL, 10);
+}
+
+// Stores A Completed String / Literal If It Is A Field Of Interest
+static void mineable_value(struct mineable_work *mw, bool is_str) {
+	struct mineable_pkg *pkg;
+
+	if (mw->tok_long || (!is_str && !strcmp(mw->tok, "null")))
+		return;
+
+	if (mw->depth == 1) {
+		if (!strcmp(mw->key, "errorDescription"))
+			mineable_str(mw->err_desc, sizeof(mw->err_desc), mw->tok, mw->tok_len);
+		return;
+	}
+
+	// Only Scalars Directly Inside A Package Object Are Used
+	if (!mw->list_depth || !mw->num_pkg || (mw->depth != mw->list_depth + 1) || (mw->stack[mw->depth - 1] != '{'))
+		return;
+
+	pkg = &mw->pkg[mw->num_pkg - 1];
+
+	if (!strcmp(mw->key, "id"))
+		mineable_str(pkg->id, sizeof(pkg->id), mw->tok, mw->tok_len);
+	else if (!strcmp(mw->key, "block_id"))
+		mineable_str(pkg->block_id, sizeof(pkg->block_id), mw->tok, mw->tok_len);
+	else if (!strcmp(mw->key, "target"))
+		mineable_str(pkg->target, sizeof(pkg->target), mw->tok, mw->tok_len);
+	else if (!strcmp(mw->key, "iterations"))
+		pkg->iterations = (int)mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "iterations_left"))
+		pkg->iterations_left = (int)mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "bounty_limit_per_iteration"))
+		pkg->bounty_limit = (uint32_t)mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "xel_per_bounty"))
+		pkg->bty_reward = mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "xel_per_pow"))
+		pkg->pow_reward = mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "received_bounties"))
+		pkg->bty_rcvd = (int)mineable_num(mw->tok);
+	else if (!strcmp(mw->key, "storage_id"))
+		pkg->storage_id = (int)mineable_num(mw->tok);
+}
+
+// Ends The Current String / Literal Token
+static void mineable_token(struct mineable_work *mw, bool is_str) {
+	mw->tok[mw->tok_len] = 0;
+
+	// Strings In Key Position Name The Next Value
+	if (is_str && mw->expect_key && mw->depth && (mw->stack[mw->depth - 1] == '{')) {
+		if (mw->tok_long || (mw->tok_len >= (int)sizeof(mw->key)))
+			mw->key[0] = 0;
+		else
+			memcpy(mw->key, mw->tok, mw->tok_len + 1);
+		mw->expect_key = false;
+	}
+	else {
+		mineable_value(mw, is_str);
+	}
+
+	mw->tok_len = 0;
+	mw->tok_long = false;
+}
+
+static void mineable_char(struct mineable_work *mw, char c) {
+	if (mw->tok_len < (int)sizeof(mw->tok) - 1)
+		mw->tok[mw->tok_len++] = c;
+	else
+		mw->tok_long = true;
+}
+
+// Feeds The Next Chunk Of A getMineableWork Response.  Packages Are Decoded Into 'mw->pkg'
+// As They Stream In, Without Buffering The Body Or Building A JSON Tree
+extern bool mineable_parse(struct mineable_work *mw, const char *buf, size_t len) {
+	struct mineable_pkg *pkg;
+	size_t i;
+	char c;
+
+	if (mw->error)
+		return false;
+
+	for (i = 0; i < len; i++) {
+		c = buf[i];
+
+		switch (mw->lex) {
+		case MW_LEX_STR:
+			if (c == '"') {
+				mw->lex = MW_LEX_NONE;
+				mineable_token(mw, true);
+			}
+			else if (c == '\\')
+				mw->lex = MW_LEX_ESC;
+			else
+				mineable_char(mw, c);
+			continue;
+
+		case MW_LEX_ESC:
+			mineable_char(mw, c);
+			mw->lex = MW_LEX_STR;
+			continue;
+
+		case MW_LEX_LIT:
+			if (isalnum((unsigned char)c) || c == '-' || c == '+' || c == '.') {
+				mineable_char(mw, c);
+				continue;
+			}
+			mw->lex = MW_LEX_NONE;
+			mineable_token(mw, false);
+			break;
+		}
+
+		switch (c) {
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+		case ':':
+			break;
+
+		case '{':
+		case '[':
+			if (mw->depth >= MAX_JSON_DEPTH)
+				goto err;
+
+			// The Array Holding The Packages
+			if ((c == '[') && (mw->depth == 1) && !mw->has_list && !strcmp(mw->key, "work_packages")) {
+				mw->has_list = true;
+				mw->list_depth = 2;
+			}
+
+			// Start Of The Next Package
+			if ((c == '{') && mw->list_depth && (mw->depth == mw->list_depth)) {
+				if (mw->num_pkg >= mw->max_pkg) {
+					int max_pkg = mw->max_pkg ? (2 * mw->max_pkg) : 64;
+
+					pkg = realloc(mw->pkg, max_pkg * sizeof(struct mineable_pkg));
+					if (!pkg)
+						goto err;
+					mw->pkg = pkg;
+					mw->max_pkg = max_pkg;
+				}
+				memset(&mw->pkg[mw->num_pkg], 0, sizeof(struct mineable_pkg));
+				mw->pkg[mw->num_pkg++].storage_id = -1;
+			}
+
+			mw->stack[mw->depth++] = c;
+			mw->expect_key = (c == '{');
+			break;
+
+		case '}':
+		case ']':
+			if (!mw->depth || (mw->stack[mw->depth - 1] != ((c == '}') ? '{' : '[')))
+				goto err;
+			mw->depth--;
+			if (mw->list_depth && (mw->depth < mw->list_depth))
+				mw->list_depth = 0;
+			mw->expect_key = false;
+			break;
+
+		case ',':
+			mw->expect_key = (mw->depth && (mw->stack[mw->depth - 1] == '{'));
+			break;
+
+		case '"':
+			mw->lex = MW_LEX_STR;
+			break;
+
+		default:
+			mw->lex = MW_LEX_LIT;
+			mineable_char(mw, c);
+			break;
+		}
+	}
+
+	return true;
+
+err:
+	mw->error = true;
+	return false;
+}
+
+// Returns True If The Whole Response Was A Well Formed getMineableWork Object
+extern bool mineable_finish(struct mineable_work *mw) {
+	if (mw->lex == MW_LEX_LIT) {
+		mw->lex = MW_LEX_NONE;
+		mineable_token(mw, false);
+	}
+
+	return (!mw->error && !mw->depth && (mw->lex == MW_LEX_NONE) && mw->has_list);
+}
+
+static size_t mineable_cb(const void *ptr, size_t size, size_t nmemb, void *user_data)
+{
+	size_t len = size * nmemb;
+
+	// Returning Short Aborts The Transfer
+	if (!mineable_parse((struct mineable_work *)user_data, (const char *)ptr, len))
+		return 0;
+
+	return len;
+}
+
+// Requests getMineableWork And Decodes The Packages Into 'mw' While The Response Arrives
+extern bool get_mineable_work(CURL *curl, const char *url, const char *userpass, struct mineable_work *mw, int *curl_err) {
+	int rc;
+	struct data_buffer unused = { 0 };
+	char curl_err_str[CURL_ERROR_SIZE] = { 0 };
+
+	mineable_reset(mw);
+
+	json_rpc_prepare(curl, url, userpass, "requestType=getMineableWork&n=1", &unused, curl_err_str);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, mineable_cb);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, mw);
+	rc = curl_easy_perform(curl);
 	curl_easy_reset(curl);
-	return NULL;
+
+	*curl_err = 0;
+
+	if (rc && !mw->error) {
+		applog(LOG_ERR, "ERROR: Curl - '%s' (code=%d)", curl_err_str, rc);
+		*curl_err = rc;
+		return false;
+	}
+
+	if (!mineable_finish(mw)) {
+		if (mw->err_desc[0])
+			applog(LOG_ERR, "ERROR: getMineableWork failed: %s", mw->err_desc);
+		else
+			applog(LOG_ERR, "ERROR: Invalid JSON response to getMineableWork request");
+		*curl_err = -2;
+		return false;
+	}
+
+	return true;
+}
+
+// Decodes A getMineableWork Response Saved In A File (--test-miner)
+extern bool load_mineable_work(const char *filename, struct mineable_work *mw) {
+	FILE *f;
+	char buf[4096];
+	size_t len;
+
+	mineable_reset(mw);
+
+	f = fopen(filename, "rb");
+	if (!f) {
+		applog(LOG_ERR, "ERROR: Unable to open '%s'", filename);
+		return false;
+	}
+
+	while ((len = fread(buf, 1, sizeof(buf), f)) > 0) {
+		if (!mineable_parse(mw, buf, len))
+			break;
+	}
+	fclose(f);
+
+	if (!mineable_finish(mw)) {
+		applog(LOG_ERR, "ERROR: Invalid getMineableWork JSON in '%s'", filename);
+		return false;
+	}
+
+	return true;
+}
+
+// Compare Buffering + Jansson Decoding Of getMineableWork Against The Stream Parser
+extern void benchmark_decode(void) {
+	static const int sizes[] = { 100, 500, 2000 };
+	struct mineable_work mw;
+	struct data_buffer db;
+	struct timeval tv_start, tv_end, diff;
+	json_t *val, *wrk, *pkg;
+	json_error_t err;
+	char *rsp, *p;
+	size_t rsp_len, off, chunk = 16384;
+	double dom_us, stream_us;
+	uint64_t check_dom, check_stream;
+	int i, j, k, n, reps;
+
+	memset(&mw, 0, sizeof(struct mineable_work));
+
+	for (k = 0; k < (int)(sizeof(sizes) / sizeof(sizes[0])); k++) {
+		n = sizes[k];
+		reps = 200000 / n;
+
+		// Synthetic Response Shaped Like The Node's, Including Fields The Miner Ignores
+		rsp = malloc(((size_t)n * 400) + 64);
+		if (!rsp) {
+			applog(LOG_ERR, "ERROR: Unable to allocate memory for decode benchmark");
+			break;
+		}
+		p = rsp + sprintf(rsp, "{\"work_packages\":[");
+		for (i = 0; i < n; i++) {
+			p += sprintf(p, "%s{\"id\":\"%d\",\"block_id\":\"%d\",\"title\":\"Synthetic Job \\\"%d\\\"\",\"account\":\"XEL-%04X-%04X\","
+				"\"target\":\"%08X%024X\",\"iterations\":%d,\"iterations_left\":%d,\"bounty_limit_per_iteration\":%d,"
+				"\"xel_per_bounty\":%d,\"xel_per_pow\":%d.5,\"received_bounties\":%d,\"percent_done\":0.%d,\"cancelled\":false}",
+				i ? "," : "", 1000000 + i, 55555, i, i, n - i, 0x0000FFFF - i, 0, 1 + (i % 5), 1 + (i % 3), 10 + (i % 7), 100 + i, 10 + i, i % 4, i);
+		}
+		p += sprintf(p, "],\"requestProcessingTime\":1}");
+		rsp_len = p - rsp;
+
+		// Buffer Chunks Like all_data_cb, Then Load & Walk The Tree Like decode_work Did
+		check_dom = 0;
+		gettimeofday(&tv_start, NULL);
+		for (j = 0; j < reps; j++) {
+			memset(&db, 0, sizeof(db));
+			for (off = 0; off < rsp_len; off += chunk)
+				all_data_cb(rsp + off, 1, ((rsp_len - off) < chunk) ? (rsp_len - off) : chunk, &db);
+
+			val = JSON_LOADS(db.buf, &err);
+			databuf_free(&db);
+			wrk = json_object_get(val, "work_packages");
+			for (i = 0; i < (int)json_array_size(wrk); i++) {
+				pkg = json_array_get(wrk, i);
+				check_dom += strtoull(json_string_value(json_object_get(pkg, "id")), NULL, 10);
+				check_dom += strtoull(json_string_value(json_object_get(pkg, "block_id")), NULL, 10);
+				check_dom += strlen(json_string_value(json_object_get(pkg, "target")));
+				check_dom += json_integer_value(json_object_get(pkg, "iterations"));
+				check_dom += json_integer_value(json_object_get(pkg, "iterations_left"));
+				check_dom += json_integer_value(json_object_get(pkg, "bounty_limit_per_iteration"));
+				check_dom += (uint64_t)json_number_value(json_object_get(pkg, "xel_per_bounty"));
+				check_dom += (uint64_t)json_number_value(json_object_get(pkg, "xel_per_pow"));
+				check_dom += json_integer_value(json_object_get(pkg, "received_bounties"));
+			}
+			json_decref(val);
+		}
+		gettimeofday(&tv_end, NULL);
+		timeval_subtract(&diff, &tv_end, &tv_start);
+		dom_us = ((1000000.0 * diff.tv_sec) + diff.tv_usec) / reps;
+
+		check_stream = 0;
+		gettimeofday(&tv_start, NULL);
+		for (j = 0; j < reps; j++) {
+			mineable_reset(&mw);
+			for (off = 0; off < rsp_len; off += chunk)
+				mineable_parse(&mw, rsp + off, ((rsp_len - off) < chunk) ? (rsp_len - off) : chunk);
+			if (!mineable_finish(&mw))
+				break;
+			for (i = 0; i < mw.num_pkg; i++) {
+				check_stream += strtoull(mw.pkg[i].id, NULL, 10);
+				check_stream += strtoull(mw.pkg[i].block_id, NULL, 10);
+				check_stream += strlen(mw.pkg[i].target);
+				check_stream += mw.pkg[i].iterations + mw.pkg[i].iterations_left + mw.pkg[i].bounty_limit;
+				check_stream += mw.pkg[i].bty_reward + mw.pkg[i].pow_reward + mw.pkg[i].bty_rcvd;
+			}
+		}
+		gettimeofday(&tv_end, NULL);
+		timeval_subtract(&diff, &tv_end, &tv_start);
+		stream_us = ((1000000.0 * diff.tv_sec) + diff.tv_usec) / reps;
+
+		if (check_stream != check_dom)
+			applog(LOG_ERR, "ERROR: Benchmark decoders disagree for %d packages", n);
+
+		applog(LOG_NOTICE, "Benchmark: %5d packages (%7lu bytes)  Jansson: %9.1f us  Stream: %9.1f us  (%.1fx)",
+			n, (unsigned long)rsp_len, dom_us, stream_us, stream_us > 0 ? dom_us / stream_us : 0.0);
+
+		free(rsp);
+	}
+
+	free(mw.pkg);
 }
 
 extern void applog(int prio, const char *fmt, ...) {
@@ -707,3 +1118,82 @@ double genrand_res53(void)
 	return(a*67108864.0 + b)*(1.0 / 9007199254740992.0);
 }
 /* These real versions are due to Isaku Wada, 2002/01/09 added */
+
+// Miner Thread Random Numbers
+//
+// MT19937 above keeps one unlocked state for the whole process, so miner threads use
+// their own xorshift128+ state instead.  Each state is seeded on first use from the
+// time, the address of the (thread local) state and a per process counter.
+
+static __thread uint64_t rand_state[2];
+static volatile uint32_t rand_seeds = 0;
+
+static uint64_t splitmix64(uint64_t *x) {
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+extern uint32_t thread_rand32(void) {
+	uint64_t s0, s1, seed;
+
+	if (!rand_state[0] && !rand_state[1]) {
+#ifdef _MSC_VER
+		seed = (uint64_t)InterlockedIncrement((volatile LONG *)&rand_seeds);
+#else
+		seed = (uint64_t)__atomic_add_fetch(&rand_seeds, 1, __ATOMIC_RELAXED);
+#endif
+		seed = (seed << 40) ^ (uint64_t)time(NULL) ^ ((uint64_t)(uintptr_t)rand_state << 8);
+		rand_state[0] = splitmix64(&seed);
+		rand_state[1] = splitmix64(&seed) | 1;
+	}
+
+	s1 = rand_state[0];
+	s0 = rand_state[1];
+	rand_state[0] = s0;
+	s1 ^= s1 << 23;
+	rand_state[1] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+	return (uint32_t)((rand_state[1] + s0) >> 32);
+}
+
+// Nonce Allocator
+//
+// Every round a miner runs is identified by a 64bit round number (multiplicator words 1
+// and 4).  Threads claim disjoint blocks of rounds from one process wide counter, and
+// with --shard k/n the round space is split into n equal slices of which this process
+// only uses slice k, so processes or hosts mining for the same account never repeat a
+// round.  Word 7 holds a random value per process for miners that are not sharded.
+
+static volatile uint64_t nonce_local = 0;
+static volatile uint64_t *nonce_next = &nonce_local;
+uint32_t nonce_salt = 0;
+
+extern void nonce_init(uint32_t shard, uint32_t shards) {
+	*nonce_next = (shards > 1) ? ((UINT64_MAX / shards) + 1) * shard : 0;
+	nonce_salt = thread_rand32();
+}
+
+// Move The Counter Into Memory Shared With Worker Processes (--supervise)
+extern void nonce_share(volatile uint64_t *counter) {
+	*counter = *nonce_next;
+	nonce_next = counter;
+}
+
+// A Block Never Crosses A Multiple Of 2^32, So All Its Rounds Share Multiplicator Word 4
+extern uint64_t nonce_alloc(uint32_t count) {
+	uint64_t cur, start;
+
+	do {
+		cur = *nonce_next;
+		start = cur;
+		if (((start & 0xFFFFFFFFULL) + count) > 0x100000000ULL)
+			start = (start | 0xFFFFFFFFULL) + 1;
+#ifdef _MSC_VER
+	} while ((uint64_t)InterlockedCompareExchange64((volatile LONG64 *)nonce_next, (LONG64)(start + count), (LONG64)cur) != cur);
+#else
+	} while (!__atomic_compare_exchange_n(nonce_next, &cur, start + count, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#endif
+
+	return start;
+}
@@ -7,193 +7,1235 @@
 #include "miner.h"
 
 #ifndef WIN32
+#include <dirent.h>
 #include <dlfcn.h>
+#include <errno.h>
+#include <limits.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <utime.h>
+
+extern char **environ;
 #endif
 
 #ifndef LM_ID_BASE
 #define LM_ID_BASE              0x00
 #endif
 
-bool create_c_source(char *work_str) {
-	FILE* f = fopen("./work/work_lib.c", "w");
-	if (!f)
-		return false;
+#ifdef WIN32
+// Generated Source For The Job Library Being Built
+static CODE_BUF lib_code;
+#endif
 
-	fprintf(f, "#include <stdbool.h>\n");
-	fprintf(f, "#include <stdio.h>\n");
-	fprintf(f, "#include <stdint.h>\n");
-	fprintf(f, "#include <stdlib.h>\n");
-	fprintf(f, "#include <limits.h>\n");
-	fprintf(f, "#include <time.h>\n");
-	fprintf(f, "#include <openssl/md5.h>\n");
+#ifndef WIN32
+// Jobs With More Generated C Than This Are Split Into Units Compiled In Parallel
+#define SPLIT_CODE_SIZE 131072
 
-	if (use_elasticpl_math) {
-		fprintf(f, "#include <math.h>\n");
-		fprintf(f, "#include \"../ElasticPL/ElasticPLFunctions.h\"\n");
-	}
-	fprintf(f, "\n");
+// Unit Objects & Autotune Results Cached In ./work Are Pruned Least Recently Used First
+// Beyond This Size, But Never Within WORK_CACHE_MIN_AGE Seconds Of Their Last Use
+#define WORK_CACHE_MB 256
+#define WORK_CACHE_MIN_AGE 600
 
-#ifdef _MSC_VER
-	fprintf(f, "__declspec(thread) uint32_t *m = NULL;\n");
-	fprintf(f, "__declspec(thread) int32_t *i = NULL;\n");
-	fprintf(f, "__declspec(thread) uint32_t *u = NULL;\n");
-	fprintf(f, "__declspec(thread) int64_t *l = NULL;\n");
-	fprintf(f, "__declspec(thread) uint64_t *ul = NULL;\n");
-	fprintf(f, "__declspec(thread) float *f = NULL;\n");
-	fprintf(f, "__declspec(thread) double *d = NULL;\n");
-	fprintf(f, "__declspec(thread) uint32_t *s = NULL;\n\n");
+// Compiler & Flags Used For Job Libraries - The First Entry Is The Default And Must
+// Match ElasticPLRuntime.h.gch (See ElasticPL/CMakeLists.txt), The Others Are Only
+// Tried By The Autotuner (--autotune)
+static const char *job_variants[] = {
+#ifdef __arm__
+	"gcc -std=c99 -Ofast -fPIC",
+	"gcc -std=c99 -O2 -fPIC",
+	"gcc -std=c99 -O3 -funroll-loops -fPIC",
+	"gcc -std=c99 -Ofast -funroll-loops -fno-semantic-interposition -fPIC",
+	"clang -std=c99 -O3 -fPIC",
 #else
-	fprintf(f, "__thread uint32_t *m = NULL;\n");
-	fprintf(f, "__thread int32_t *i = NULL;\n");
-	fprintf(f, "__thread uint32_t *u = NULL;\n");
-	fprintf(f, "__thread int64_t *l = NULL;\n");
-	fprintf(f, "__thread uint64_t *ul = NULL;\n");
-	fprintf(f, "__thread float *f = NULL;\n");
-	fprintf(f, "__thread double *d = NULL;\n");
-	fprintf(f, "__thread uint32_t *s = NULL;\n\n");
+	"gcc -g -march=native -Ofast -fPIC",
+	"gcc -march=native -O2 -fPIC",
+	"gcc -march=native -O3 -funroll-loops -fPIC",
+	"gcc -march=native -Ofast -funroll-loops -fno-semantic-interposition -fPIC",
+	"gcc -march=native -O3 -fno-tree-vectorize -fPIC",
+	"clang -march=native -O3 -fPIC",
 #endif
+	NULL
+};
 
-	fprintf(f, "static uint32_t rotl32(uint32_t x, uint32_t n);\n");
-	fprintf(f, "static uint32_t rotr32(uint32_t x, uint32_t n);\n");
-	fprintf(f, "static uint64_t rotl64(uint64_t x, uint64_t n);\n");
-	fprintf(f, "static uint64_t rotr64(uint64_t x, uint64_t n);\n\n");
-	fprintf(f, "static uint32_t check_pow(uint32_t, uint32_t, uint32_t, uint32_t, uint32_t *, uint32_t *, uint32_t *);\n\n");
+#define TUNE_WINDOW_MS 250		// Time Each Autotuner Variant Is Benchmarked For
+#define MAX_TUNE_WAITERS 8		// Packages With The Same Source Sharing One Autotuning Run
+#endif
 
-	// Include C Source Code For ElasticPL Jobs
-	fprintf(f, "#include \"job_%s.h\"\n\n", work_str);
+#define MAX_IDLE_INSTANCES 8	// Job Libraries Kept Loaded After Their Last Miner Thread Moves On
 
-	fprintf(f, "static const uint32_t mask32 = (CHAR_BIT*sizeof(uint32_t)-1);\n");
-	fprintf(f, "static const uint64_t mask64 = (CHAR_BIT*sizeof(uint64_t)-1);\n\n");
+// Loaded Job Library Shared By All Miner Threads On The Same Package
+struct job_instance {
+	char work_str[22];
+	struct instance inst;
+	int refcnt;
+	uint64_t last_used;		// Release Tick, Used To Unload The Least Recently Used Idle Library
+};
 
-	fprintf(f, "static uint32_t rotl32 (uint32_t x, uint32_t n) {\n");
-	fprintf(f, "\tn &= mask32;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers\n");
-	fprintf(f, "\treturn (x<<n) | (x>>( (-n)&mask32 ));\n");
-	fprintf(f, "}\n\n");
+static struct job_instance **g_job_inst = NULL;
+static int g_job_inst_cnt = 0;
+static uint64_t g_job_inst_tick = 0;
+static pthread_mutex_t job_inst_lock = PTHREAD_MUTEX_INITIALIZER;
 
-	fprintf(f, "static uint32_t rotr32 (uint32_t x, uint32_t n) {\n");
-	fprintf(f, "\tn &= mask32;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers\n");
-	fprintf(f, "\treturn (x>>n) | (x<<( (-n)&mask32 ));\n");
-	fprintf(f, "}\n\n");
+#ifndef WIN32
+// Autotuning Request Handed To The Background Thread
+struct tune_job {
+	char work_str[22];
+	char hash[33];
+	CODE_BUF code;
+	uint32_t vm_sizes[7];
+	char waiters[MAX_TUNE_WAITERS][22];	// Other Packages With The Same Source, Promoted Along With work_str
+	int num_waiters;
+	struct tune_job *next;
+};
 
-	fprintf(f, "static uint64_t rotl64 (uint64_t x, uint64_t n) {\n");
-	fprintf(f, "\tn &= mask64;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers\n");
-	fprintf(f, "\treturn (x<<n) | (x>>( (-n)&mask64 ));\n");
-	fprintf(f, "}\n\n");
+// One Translation Unit Of A Split Job
+struct build_unit {
+	CODE_BUF code;		// Empty When The Object Is Reused From ./work
+	pid_t pid;
+	char tmp[100];
+	char obj[100];
+};
 
-	fprintf(f, "static uint64_t rotr64 (uint64_t x, uint64_t n) {\n");
-	fprintf(f, "\tn &= mask64;  // avoid undef behaviour with NDEBUG.  0 overhead for most types / compilers\n");
-	fprintf(f, "\treturn (x>>n) | (x<<( (-n)&mask64 ));\n");
-	fprintf(f, "}\n\n");
+// Library Build Prepared While The AST Is Available, So It Can Finish On A Build Thread
+struct lib_build {
+	char work_str[22];
+	char lib_path[100];
+	int fd;
+	char variant[256];
+	bool tuned;
+	char hash[33];
+	CODE_BUF code;			// Whole Library Source
+	uint32_t vm_sizes[7];		// Passed On To The Autotuner
+	int num_units;			// Set When A Large Job Is Split Into Units
+	struct build_unit *units;
+	struct timeval tv_start, tv_gen;
+	void (*done)(char *work_str, bool rc);
+};
 
-	fprintf(f, "static uint32_t check_pow(uint32_t msg_0, uint32_t msg_1, uint32_t msg_2, uint32_t msg_3, uint32_t *m, uint32_t *target, uint32_t *hash) {\n");
-	fprintf(f, "\tint i;\n");
-	fprintf(f, "\tunsigned char msg[48];\n");
-	fprintf(f, "\tuint32_t *msg32 = (uint32_t *)(msg);\n");
-	fprintf(f, "\tmsg32[0] = msg_0;\n");
-	fprintf(f, "\tmsg32[1] = msg_1;\n");
-	fprintf(f, "\tmsg32[2] = msg_2;\n");
-	fprintf(f, "\tmsg32[3] = msg_3;\n\n");
-	fprintf(f, "\tfor (i = 0; i < 8; i++)\n");
-	fprintf(f, "\t\tmsg32[i+4] = m[i];\n\n");
-	fprintf(f, "\tMD5(msg, 48, (unsigned char *)hash);\n\n");
-	fprintf(f, "\tfor (i = 0; i < 4; i++) {\n");
-	fprintf(f, "\t\tif (hash[i] > target[i])\n");
-	fprintf(f, "\t\t\treturn 0;\n");
-	fprintf(f, "\t\telse if (hash[i] < target[i])\n");
-	fprintf(f, "\t\t\treturn 1;    // POW Solution Found\n");
-	fprintf(f, "\t}\n");
-	fprintf(f, "\treturn 0;\n");
-	fprintf(f, "}\n\n");
+// Builds Queued By compile_library_async()
+static struct thread_q *g_build_q = NULL;
+static int g_build_threads = 0;
+static pthread_mutex_t build_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile int g_unit_seq = 0;
 
-#ifdef WIN32
-	fprintf(f, "__declspec(dllexport) int32_t initialize(uint32_t *vm_m, int32_t *vm_i, uint32_t *vm_u, int64_t *vm_l, uint64_t *vm_ul, float *vm_f, double *vm_d, uint32_t *vm_s) {\n");
-#else
-	fprintf(f, "int32_t initialize(uint32_t *vm_m, int32_t *vm_i, uint32_t *vm_u, int64_t *vm_l, uint64_t *vm_ul, float *vm_f, double *vm_d, uint32_t *vm_s) {\n");
+// Autotuning Runs In Progress - One Per Source Hash
+static struct tune_job *g_tune_jobs = NULL;
+static pthread_mutex_t tune_lock = PTHREAD_MUTEX_INITIALIZER;
 #endif
-	fprintf(f, "\tm = vm_m;\n");
-	fprintf(f, "\ti = vm_i;\n");
-	fprintf(f, "\tu = vm_u;\n");
-	fprintf(f, "\tl = vm_l;\n");
-	fprintf(f, "\tul = vm_ul;\n");
-	fprintf(f, "\tf = vm_f;\n");
-	fprintf(f, "\td = vm_d;\n");
-	fprintf(f, "\ts = vm_s;\n\n");
-	fprintf(f, "\treturn 0;\n");
 
-	fprintf(f, "}\n\n");
+#ifndef WIN32
+// Job Libraries Compiled Into Anonymous Memory (memfd) Rather Than ./work
+struct job_library {
+	char work_str[22];
+	int fd;
+	char tuned[100];	// Library Built With The Autotuner's Winning Flags
+	char file[100];		// Library Published By The Coordinator (Worker Processes Only)
+	int version;		// Incremented When A Better Library Replaces The Current One
+	int pins;			// Snapshots, Board Slots & Loaded Instances That May Still Load It
+	bool retired;		// Package Left getMineableWork - Dropped Once The Last Pin Goes
+};
 
-#ifdef WIN32
-	fprintf(f, "__declspec(dllexport) int32_t execute( uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash ) {\n\n");
-#else
-	fprintf(f, "int32_t execute( uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash ) {\n\n");
+static struct job_library *g_job_lib = NULL;
+static int g_job_lib_cnt = 0;
+static pthread_mutex_t job_lib_lock = PTHREAD_MUTEX_INITIALIZER;
+volatile int g_library_gen = 0;		// Bumped Whenever The Autotuner Promotes A Library
 #endif
 
-	// Call The Main Function For The Current Job
-	fprintf(f, "\tmain_%s(bounty_found, verify_pow, pow_found, target, hash);\n\n", work_str);
-	fprintf(f, "\treturn 0;\n");
-	fprintf(f, "}\n\n");
+bool create_c_source(char *work_str, CODE_BUF *code) {
+	code_buf_reset(code);
+
+	// Headers, VM Memory, Rotations & check_pow Come From The Prebuilt Runtime
+	code_buf_printf(code, "#include \"ElasticPLRuntime.h\"\n\n");
+
+	// Append C Source Code For ElasticPL Jobs
+	code_buf_append(code, job_code.buf, job_code.len);
+	code_buf_printf(code, "\n");
+
+	// Entry Points Called By execute() / verify() In The Runtime
+	code_buf_printf(code, "void job_main(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {\n");
+	code_buf_printf(code, "\tmain_job(bounty_found, verify_pow, pow_found, target, hash);\n");
+	code_buf_printf(code, "}\n\n");
+
+	code_buf_printf(code, "void job_verify(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {\n");
+	code_buf_printf(code, "\tverify_job(bounty_found, verify_pow, pow_found, target, hash);\n");
+	code_buf_printf(code, "}\n");
+
+	return !code->error;
+}
+
+#ifndef WIN32
+// Caller Must Hold job_lib_lock
+static struct job_library *find_job_library(char *work_str, bool add) {
+	struct job_library *lib;
+	int i;
+
+	for (i = 0; i < g_job_lib_cnt; i++) {
+		if (!strcmp(g_job_lib[i].work_str, work_str))
+			return &g_job_lib[i];
+	}
+
+	if (!add)
+		return NULL;
+
+	lib = realloc(g_job_lib, (g_job_lib_cnt + 1) * sizeof(struct job_library));
+	if (!lib) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for job library list");
+		return NULL;
+	}
+	g_job_lib = lib;
+	lib = &g_job_lib[g_job_lib_cnt++];
+	snprintf(lib->work_str, sizeof(lib->work_str), "%s", work_str);
+	lib->fd = -1;
+	lib->tuned[0] = 0;
+	lib->file[0] = 0;
+	lib->version = 0;
+	lib->pins = 0;
+	lib->retired = false;
+
+	return lib;
+}
+
+// Deletes The Autotuned Library Unless Packages With The Same Source Still Use It (Caller Must Hold job_lib_lock)
+static void release_tuned(struct job_library *lib) {
+	int i;
+
+	if (!lib->tuned[0])
+		return;
+
+	for (i = 0; i < g_job_lib_cnt; i++) {
+		if ((&g_job_lib[i] != lib) && !strcmp(g_job_lib[i].tuned, lib->tuned))
+			break;
+	}
+	if (i == g_job_lib_cnt)
+		remove(lib->tuned);
 
+	lib->tuned[0] = 0;
+}
+
+// Closes The memfd Of A Retired Library (Caller Must Hold job_lib_lock)
+static void drop_job_library(struct job_library *lib) {
+	applog(LOG_DEBUG, "DEBUG: Releasing library 'job_%s'", lib->work_str);
+
+	if (lib->fd >= 0)
+		close(lib->fd);
+	release_tuned(lib);
+
+	*lib = g_job_lib[--g_job_lib_cnt];
+}
+
+static bool set_library_fd(char *work_str, int fd) {
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, true);
+	if (lib) {
+		// Replace The Library From A Previous Build (Mappings Of The Old One Stay Valid)
+		if (lib->fd >= 0)
+			close(lib->fd);
+		lib->fd = fd;
+		lib->retired = false;
+	}
+	pthread_mutex_unlock(&job_lib_lock);
+
+	return (lib != NULL);
+}
+
+// Point New Instances At A Library Built By The Autotuner (NULL Clears It)
+static bool set_library_tuned(char *work_str, char *path) {
+	struct job_library *lib;
+
+	// A Package That Was Retired Meanwhile Keeps Its Library Dropped
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib && lib->retired)
+		lib = NULL;
+	if (lib) {
+		if (strcmp(lib->tuned, path ? path : ""))
+			release_tuned(lib);
+		if (path) {
+			snprintf(lib->tuned, sizeof(lib->tuned), "%s", path);
+			lib->version++;
+			ATOMIC_INC(&g_library_gen);
+		}
+	}
+	pthread_mutex_unlock(&job_lib_lock);
+
+	return (!path || lib != NULL);
+}
+
+// Path Of The Library New Instances Should Load, Preferring An Autotuned Build
+extern void get_library_file(char *work_str, char *path, int *version) {
+	struct job_library *lib;
+	int fd = -1;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib && (lib->file[0] || lib->tuned[0])) {
+		strcpy(path, lib->file[0] ? lib->file : lib->tuned);
+		*version = lib->version;
+		pthread_mutex_unlock(&job_lib_lock);
+		return;
+	}
+	if (lib) {
+		fd = lib->fd;
+		*version = lib->version;
+	}
+	else {
+		*version = 0;
+	}
+	pthread_mutex_unlock(&job_lib_lock);
+
+	get_library_path(work_str, path, fd);
+}
+
+// Worker Processes Load The Library The Coordinator Built, Which They May Not Have Seen Yet
+extern void set_library_file(char *work_str, char *path, int version) {
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, true);
+	if (lib && (strcmp(lib->file, path) || (lib->version != version))) {
+		snprintf(lib->file, sizeof(lib->file), "%s", path);
+		lib->version = version;
+		ATOMIC_INC(&g_library_gen);
+	}
+	pthread_mutex_unlock(&job_lib_lock);
+}
+
+// Held Across fork() So Worker Processes Never Inherit A Registry Mid Update
+extern void library_lock(bool lock) {
+	if (lock) {
+		pthread_mutex_lock(&job_inst_lock);
+		pthread_mutex_lock(&job_lib_lock);
+	}
+	else {
+		pthread_mutex_unlock(&job_lib_lock);
+		pthread_mutex_unlock(&job_inst_lock);
+	}
+}
+
+static int create_library_fd(char *work_str) {
+#ifdef MFD_CLOEXEC
+	char name[50];
+
+	// Test VM Reuses Libraries Cached In ./work Between Runs
+	if (opt_test_vm)
+		return -1;
+
+	sprintf(name, "job_%s", work_str);
+	return memfd_create(name, MFD_CLOEXEC);
+#else
+	return -1;
+#endif
+}
+#endif
+
+static void get_library_path(char *work_str, char *path, int fd) {
 #ifdef WIN32
-	fprintf(f, "__declspec(dllexport) int32_t verify( uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash ) {\n\n");
+	sprintf(path, "./work/job_%s.dll", work_str);
 #else
-	fprintf(f, "int32_t verify( uint64_t work_id, uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash ) {\n\n");
+	// Descendants Of gcc Can Reach The memfd Through The Miner's /proc Entry
+	if (fd >= 0)
+		sprintf(path, "/proc/%d/fd/%d", (int)getpid(), fd);
+	else
+		sprintf(path, "./work/job_%s.so", work_str);
 #endif
+}
 
-	// Call The Verify Function For The Current Job
-	fprintf(f, "\tverify_%s(bounty_found, verify_pow, pow_found, target, hash);\n\n", work_str);
-	fprintf(f, "\treturn 0;\n");
-	fprintf(f, "}\n\n");
+// Check If The Autotuner Has Promoted A Faster Library Since 'inst' Was Loaded
+extern bool library_updated(struct instance *inst, char *work_str) {
+	bool updated = false;
+#ifndef WIN32
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib && (lib->tuned[0] || lib->file[0]) && lib->version != inst->version)
+		updated = true;
+	pthread_mutex_unlock(&job_lib_lock);
+#endif
+
+	return updated;
+}
+
+#ifndef WIN32
+// Start Of A Job Compile Command - 'variant' Is A Writable Copy Of A job_variants Entry
+static int add_job_cflags(char **argv, char *variant) {
+	char *tok, *save = NULL;
+	int n = 0;
+
+	argv[n++] = strtok_r(variant, " ", &save);
+	argv[n++] = "-x";
+	argv[n++] = "c";
+	argv[n++] = "-";
+	argv[n++] = "-I./ElasticPL";
+	argv[n++] = "-I./crypto";
+	argv[n++] = "-I./work";
+
+	while ((tok = strtok_r(NULL, " ", &save)))
+		argv[n++] = tok;
+
+	return n;
+}
+
+static int add_job_libs(char **argv, int n) {
+	argv[n++] = "-L./ElasticPL";
+	argv[n++] = "-L./crypto";
+	argv[n++] = "-Wl,--whole-archive";
+	argv[n++] = "-lElasticPLRuntime";
+	argv[n++] = "-Wl,--no-whole-archive";
+	argv[n++] = "-lElasticPLFunctions";
+	argv[n++] = "-lcrypto";
+	argv[n] = NULL;
+
+	return n;
+}
+
+// Starts gcc With 'code' (If Any) Fed Through stdin
+static bool spawn_compiler(char **argv, CODE_BUF *code, pid_t *pid) {
+	posix_spawn_file_actions_t actions;
+	sigset_t sigpipe, old_mask;
+	struct timespec no_wait = { 0, 0 };
+	ssize_t n;
+	size_t written = 0;
+	int pipe_fd[2], err;
+
+	if (!code) {
+		err = posix_spawnp(pid, argv[0], NULL, NULL, argv, environ);
+		if (err)
+			applog(LOG_ERR, "ERROR: Unable to start compiler '%s' (%s)", argv[0], strerror(err));
+		return !err;
+	}
+
+	if (pipe2(pipe_fd, O_CLOEXEC)) {
+		applog(LOG_ERR, "ERROR: Unable to create pipe for compiler (%s)", strerror(errno));
+		return false;
+	}
+
+	// Compiler Reads The Source From stdin
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, pipe_fd[0], STDIN_FILENO);
+
+	err = posix_spawnp(pid, argv[0], &actions, NULL, argv, environ);
+	posix_spawn_file_actions_destroy(&actions);
+	close(pipe_fd[0]);
+
+	if (err) {
+		close(pipe_fd[1]);
+		applog(LOG_ERR, "ERROR: Unable to start compiler '%s' (%s)", argv[0], strerror(err));
+		return false;
+	}
+
+	// Don't Let An Early Compiler Exit Kill The Miner With SIGPIPE
+	sigemptyset(&sigpipe);
+	sigaddset(&sigpipe, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &sigpipe, &old_mask);
+
+	while (written < code->len) {
+		n = write(pipe_fd[1], &code->buf[written], code->len - written);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		written += n;
+	}
+	close(pipe_fd[1]);
+
+	if (!sigismember(&old_mask, SIGPIPE)) {
+		while (sigtimedwait(&sigpipe, NULL, &no_wait) > 0);
+		pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+	}
+
+	// A Short Write Shows Up As A Compiler Error
+	return true;
+}
+
+static bool wait_compiler(pid_t pid) {
+	int status;
+
+	while (waitpid(pid, &status, 0) < 0) {
+		if (errno != EINTR) {
+			applog(LOG_ERR, "ERROR: Unable to wait for compiler (%s)", strerror(errno));
+			return false;
+		}
+	}
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+		applog(LOG_ERR, "ERROR: Compiler failed with status %d", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+		return false;
+	}
 
-	fflush(f);
-	fclose(f);
 	return true;
 }
 
+static bool run_compiler(char **argv, CODE_BUF *code) {
+	pid_t pid;
+
+	if (!spawn_compiler(argv, code, &pid))
+		return false;
+
+	return wait_compiler(pid);
+}
+
+// Assigns Each Function To A Translation Unit - A Function With A Single Caller
+// Joins Its Caller's Unit (So It Can Still Be Inlined) Unless The Unit Is Full
+static int group_functions(int *group, size_t max_len) {
+	size_t *unit_len;
+	int *caller;
+	int i, j, num_units = 0;
+	bool changed = true;
+
+	caller = malloc(job_func_cnt * sizeof(int));
+	unit_len = calloc(job_func_cnt, sizeof(size_t));
+	if (!caller || !unit_len) {
+		free(caller);
+		free(unit_len);
+		return 0;
+	}
+
+	for (i = 0; i < job_func_cnt; i++) {
+		group[i] = -1;
+		caller[i] = -1;
+		for (j = 0; j < job_func_cnt; j++) {
+			if (job_func_calls[(j * job_func_cnt) + i])
+				caller[i] = (caller[i] == -1) ? j : -2;
+		}
+	}
+
+	while (changed) {
+		changed = false;
+		for (i = 0; i < job_func_cnt; i++) {
+			if (group[i] >= 0)
+				continue;
+
+			// Wait Until The Caller Has Been Placed
+			if ((caller[i] >= 0) && (group[caller[i]] < 0))
+				continue;
+
+			if ((caller[i] >= 0) && (unit_len[group[caller[i]]] + job_funcs[i].code_len <= max_len))
+				group[i] = group[caller[i]];
+			else
+				group[i] = num_units++;
+
+			unit_len[group[i]] += job_funcs[i].code_len;
+			changed = true;
+		}
+	}
+
+	// Functions Left Over Are Only Called From Unreachable Cycles
+	for (i = 0; i < job_func_cnt; i++) {
+		if (group[i] < 0)
+			group[i] = num_units++;
+	}
+
+	free(caller);
+	free(unit_len);
+	return num_units;
+}
+
+static bool create_unit_source(CODE_BUF *code, int *group, int unit) {
+	int i, j;
+	bool needed;
+
+	code_buf_reset(code);
+	code_buf_printf(code, "#include \"ElasticPLRuntime.h\"\n\n");
+
+	// Constant Arrays Are Declared In Every Unit & Defined In The One With main
+	code_buf_append(code, &job_code.buf[job_consts.decl_start], job_consts.decl_len);
+	if (group[ast_main_idx - ast_func_idx] == unit)
+		code_buf_append(code, &job_code.buf[job_consts.code_start], job_consts.code_len);
+
+	// Declare Only The Functions This Unit Defines Or Calls
+	for (i = 0; i < job_func_cnt; i++) {
+		needed = (group[i] == unit);
+		for (j = 0; !needed && (j < job_func_cnt); j++)
+			needed = (group[j] == unit) && job_func_calls[(j * job_func_cnt) + i];
+		if (needed)
+			code_buf_append(code, &job_code.buf[job_funcs[i].decl_start], job_funcs[i].decl_len);
+	}
+	code_buf_printf(code, "\n");
+
+	for (i = 0; i < job_func_cnt; i++) {
+		if (group[i] == unit)
+			code_buf_append(code, &job_code.buf[job_funcs[i].code_start], job_funcs[i].code_len);
+	}
+
+	if (group[ast_main_idx - ast_func_idx] == unit) {
+		code_buf_printf(code, "void job_main(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {\n");
+		code_buf_printf(code, "\tmain_job(bounty_found, verify_pow, pow_found, target, hash);\n");
+		code_buf_printf(code, "}\n\n");
+	}
+
+	if (group[ast_verify_idx - ast_func_idx] == unit) {
+		code_buf_printf(code, "void job_verify(uint32_t *bounty_found, uint32_t verify_pow, uint32_t *pow_found, uint32_t *target, uint32_t *hash) {\n");
+		code_buf_printf(code, "\tverify_job(bounty_found, verify_pow, pow_found, target, hash);\n");
+		code_buf_printf(code, "}\n");
+	}
+
+	return !code->error;
+}
+
+// Generate The Source Of Each Unit While The AST Is Available - Units Already Built For
+// Identical Code (e.g. Packages From The Same Template) Are Reused From ./work
+static bool prepare_units(struct lib_build *build) {
+	struct build_unit *unit;
+	unsigned char hash[32];
+	char hex[33];
+	int *group = NULL;
+	int i, cached = 0;
+	size_t total = 0;
+	bool rc = true;
+
+	for (i = 0; i < job_func_cnt; i++)
+		total += job_funcs[i].code_len;
+
+	group = malloc(job_func_cnt * sizeof(int));
+	if (!group)
+		return false;
+
+	build->num_units = group_functions(group, total / num_cpus + 1);
+	build->units = calloc(build->num_units, sizeof(struct build_unit));
+	if (!build->num_units || !build->units) {
+		rc = false;
+		goto out;
+	}
+
+	for (i = 0; i < build->num_units; i++) {
+		unit = &build->units[i];
+
+		if (!create_unit_source(&unit->code, group, i)) {
+			rc = false;
+			break;
+		}
+
+		// Object Name Depends On The Source And The Flags It Was Built With
+		code_buf_append(&unit->code, build->variant, strlen(build->variant));
+		sha256((unsigned char *)unit->code.buf, unit->code.len, hash);
+		unit->code.len -= strlen(build->variant);
+		tohex(hash, 16, hex, sizeof(hex));
+
+		// Reused Objects Are Touched, So Pruning Sees When They Were Last Used
+		sprintf(unit->obj, "./work/unit_%s.o", hex);
+		if (!utime(unit->obj, NULL)) {
+			code_buf_free(&unit->code);
+			cached++;
+			continue;
+		}
+
+		// Builds Of Packages From The Same Template May Compile The Same Unit At Once
+		sprintf(unit->tmp, "./work/unit_%s.o.%d.%d", hex, (int)getpid(), ATOMIC_INC(&g_unit_seq));
+	}
+
+	applog(LOG_DEBUG, "DEBUG: Compiling %d functions as %d units", job_func_cnt, build->num_units);
+	if (cached)
+		applog(LOG_DEBUG, "DEBUG: Reused %d of %d compiled units", cached, build->num_units);
+
+out:
+	free(group);
+	return rc;
+}
+
+// Keep The Unit Objects & Autotune Results In ./work Under WORK_CACHE_MB.  Files In Use By
+// A Build Were Touched Within WORK_CACHE_MIN_AGE, So They Are Never Removed From Under It
+static void prune_work_cache(void) {
+	struct cache_file {
+		char name[NAME_MAX + 1];
+		time_t mtime;
+		off_t size;
+	} *files = NULL, *tmp;
+	struct dirent *de;
+	struct stat st;
+	char path[NAME_MAX + 8], hash[33];	// "./work/" + Name
+	time_t now = time(NULL);
+	uint64_t total = 0;
+	int i, n = 0, max = 0, oldest, removed = 0, pid, k;
+	DIR *dir;
+
+	dir = opendir("./work");
+	if (!dir)
+		return;
+
+	while ((de = readdir(dir)) != NULL) {
+		// Autotuned Libraries Left By A Miner That Has Exited (Its Own Are Removed When Retired)
+		if ((sscanf(de->d_name, "tune_%32[0-9A-F]_%d_%d.so", hash, &pid, &k) == 3) && (pid != (int)getpid()) && (kill(pid, 0) < 0) && (errno == ESRCH)) {
+			snprintf(path, sizeof(path), "./work/%s", de->d_name);
+			if (!remove(path))
+				removed++;
+			continue;
+		}
+
+		// Unit Objects (And Temporaries Left By A Crash) & Autotune Results - Never Libraries
+		if (!(!strncmp(de->d_name, "unit_", 5) && strstr(de->d_name, ".o")) && !(!strncmp(de->d_name, "tune_", 5) && strstr(de->d_name, ".txt")))
+			continue;
+
+		snprintf(path, sizeof(path), "./work/%s", de->d_name);
+		if (stat(path, &st) || !S_ISREG(st.st_mode))
+			continue;
+
+		if (n == max) {
+			max = max ? 2 * max : 256;
+			tmp = realloc(files, max * sizeof(struct cache_file));
+			if (!tmp)
+				break;
+			files = tmp;
+		}
+
+		snprintf(files[n].name, sizeof(files[n].name), "%s", de->d_name);
+		files[n].mtime = st.st_mtime;
+		files[n].size = st.st_size;
+		total += st.st_size;
+		n++;
+	}
+	closedir(dir);
+
+	while (total > (uint64_t)WORK_CACHE_MB * 1024 * 1024) {
+		oldest = -1;
+		for (i = 0; i < n; i++) {
+			if ((files[i].size >= 0) && (now - files[i].mtime >= WORK_CACHE_MIN_AGE) && ((oldest < 0) || (files[i].mtime < files[oldest].mtime)))
+				oldest = i;
+		}
+		if (oldest < 0)
+			break;
+
+		snprintf(path, sizeof(path), "./work/%s", files[oldest].name);
+		remove(path);
+		total -= files[oldest].size;
+		files[oldest].size = -1;
+		removed++;
+	}
+
+	if (removed)
+		applog(LOG_DEBUG, "DEBUG: Pruned %d cached files from ./work", removed);
+
+	free(files);
+}
+
+// Compile The Prepared Units In Parallel & Link Them With The Runtime
+static bool compile_units(struct lib_build *build) {
+	struct build_unit *units = build->units;
+	char cflags[256];
+	char **argv = NULL;
+	int i, n, running = 0;
+	bool rc = true;
+
+	argv = calloc(build->num_units + 20, sizeof(char *));
+	if (!argv)
+		return false;
+
+	for (i = 0; rc && (i < build->num_units); i++) {
+		if (!units[i].tmp[0])
+			continue;
+
+		// Keep At Most One Compiler Per CPU Running
+		if (running == num_cpus) {
+			for (n = 0; n < i; n++) {
+				if (units[n].pid) {
+					rc = wait_compiler(units[n].pid) && !rename(units[n].tmp, units[n].obj);
+					units[n].pid = 0;
+					running--;
+					break;
+				}
+			}
+		}
+
+		snprintf(cflags, sizeof(cflags), "%s", build->variant);
+		n = add_job_cflags(argv, cflags);
+		argv[n++] = "-c";
+		argv[n++] = "-o";
+		argv[n++] = units[i].tmp;
+		argv[n] = NULL;
+
+		if (rc && spawn_compiler(argv, &units[i].code, &units[i].pid))
+			running++;
+		else
+			rc = false;
+	}
+
+	for (i = 0; i < build->num_units; i++) {
+		if (units[i].pid) {
+			if (!wait_compiler(units[i].pid) || rename(units[i].tmp, units[i].obj))
+				rc = false;
+			units[i].pid = 0;
+		}
+	}
+
+	// Link The Units With The Runtime
+	if (rc) {
+		n = 0;
+		argv[n++] = "gcc";
+		argv[n++] = "-shared";
+		argv[n++] = "-o";
+		argv[n++] = build->lib_path;
+		for (i = 0; i < build->num_units; i++)
+			argv[n++] = units[i].obj;
+		add_job_libs(argv, n);
+		rc = run_compiler(argv, NULL);
+	}
+
+	free(argv);
+	return rc;
+}
+#endif
+
+#ifndef WIN32
+static void get_source_hash(CODE_BUF *code, char *hex) {
+	unsigned char hash[32];
+
+	sha256((unsigned char *)code->buf, code->len, hash);
+	tohex(hash, 16, hex, 33);
+}
+
+// Flags Chosen By A Previous Autotuning Run For This Source (Kept In ./work)
+static const char *get_tuned_variant(char *hash) {
+	char path[100], line[256];
+	FILE *f;
+	int k;
+
+	sprintf(path, "./work/tune_%s.txt", hash);
+	f = fopen(path, "r");
+	if (!f)
+		return NULL;
+	utime(path, NULL);
+
+	if (!fgets(line, sizeof(line), f)) {
+		fclose(f);
+		return NULL;
+	}
+	fclose(f);
+	line[strcspn(line, "\r\n")] = 0;
+
+	// Only Accept Flags This Build Still Knows About
+	for (k = 0; job_variants[k]; k++) {
+		if (!strcmp(line, job_variants[k]))
+			return job_variants[k];
+	}
+
+	return NULL;
+}
+
+static bool compile_variant(struct tune_job *job, const char *variant, char *lib_path) {
+	char *argv[30];
+	char cflags[256];
+	int n;
+
+	snprintf(cflags, sizeof(cflags), "%s", variant);
+	n = add_job_cflags(argv, cflags);
+	argv[n++] = "-w";
+	argv[n++] = "-shared";
+	argv[n++] = "-o";
+	argv[n++] = lib_path;
+	add_job_libs(argv, n);
+
+	return run_compiler(argv, &job->code);
+}
+
+static void *autotune_thread(void *userdata) {
+	struct tune_job *job = (struct tune_job *)userdata;
+	struct tune_job **p;
+	struct instance inst;
+	char lib_path[100], best_path[100];
+	double speed, best_speed = 0.0;
+	int i, k, best = -1;
+	bool promoted;
+	FILE *f;
+
+	pthread_detach(pthread_self());
+
+	applog(LOG_INFO, "Autotune: Searching compiler flags for job_%s", job->work_str);
+
+	for (k = 0; job_variants[k]; k++) {
+		// The pid Keeps Other Miners Sharing ./work From Replacing Our Variants
+		sprintf(lib_path, "./work/tune_%s_%d_%d.so", job->hash, (int)getpid(), k);
+
+		// Variants Whose Compiler Is Missing Or Rejects The Flags Are Skipped
+		if (!compile_variant(job, job_variants[k], lib_path)) {
+			applog(LOG_DEBUG, "DEBUG: Autotune: Unable to build '%s'", job_variants[k]);
+			continue;
+		}
+
+		memset(&inst, 0, sizeof(struct instance));
+		inst.hndl = dlopen(lib_path, RTLD_LOCAL | RTLD_NOW);
+		if (inst.hndl) {
+			inst.initialize = dlsym(inst.hndl, "initialize");
+			inst.execute = dlsym(inst.hndl, "execute");
+			inst.verify = dlsym(inst.hndl, "verify");
+		}
+		if (!inst.initialize || !inst.execute || !inst.verify) {
+			applog(LOG_DEBUG, "DEBUG: Autotune: Unable to load '%s'", lib_path);
+			if (inst.hndl)
+				dlclose(inst.hndl);
+			remove(lib_path);
+			continue;
+		}
+
+		speed = run_benchmark(&inst, job->vm_sizes, TUNE_WINDOW_MS);
+		free_library(&inst);
+
+		applog(LOG_INFO, "Autotune: %s: %.2f kEval/s", job_variants[k], speed);
+
+		if (speed > best_speed) {
+			if (best >= 0)
+				remove(best_path);
+			best_speed = speed;
+			best = k;
+			strcpy(best_path, lib_path);
+		}
+		else {
+			remove(lib_path);
+		}
+	}
+
+	// Packages Joining From Here On Start A New Run, Which Picks Up The Saved Flags
+	pthread_mutex_lock(&tune_lock);
+	for (p = &g_tune_jobs; *p; p = &(*p)->next) {
+		if (*p == job) {
+			*p = job->next;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&tune_lock);
+
+	if (best < 0) {
+		applog(LOG_ERR, "ERROR: Autotune unable to build any variant for job_%s", job->work_str);
+		goto out;
+	}
+
+	// Remember The Winner So Later Builds Of This Source Skip The Search
+	sprintf(lib_path, "./work/tune_%s.txt", job->hash);
+	f = fopen(lib_path, "w");
+	if (f) {
+		fprintf(f, "%s\n", job_variants[best]);
+		fclose(f);
+	}
+
+	applog(LOG_NOTICE, "Autotune: Selected '%s' for job_%s", job_variants[best], job->work_str);
+
+	// The Default Build Is Already Loaded By The Miners
+	promoted = false;
+	if (best > 0) {
+		promoted = set_library_tuned(job->work_str, best_path);
+		for (i = 0; i < job->num_waiters; i++)
+			promoted |= set_library_tuned(job->waiters[i], best_path);
+	}
+	if (!promoted)
+		remove(best_path);
+
+out:
+	free(job->code.buf);
+	free(job);
+
+	return NULL;
+}
+
+// Snapshot Everything The Tuner Needs As The Caller Moves On To Other Packages
+static void start_autotune(struct lib_build *build) {
+	struct tune_job *job;
+	pthread_t thr;
+
+	// Packages With The Same Source Share The Run Already Searching It
+	pthread_mutex_lock(&tune_lock);
+	for (job = g_tune_jobs; job; job = job->next) {
+		if (strcmp(job->hash, build->hash))
+			continue;
+		if (strcmp(job->work_str, build->work_str) && (job->num_waiters < MAX_TUNE_WAITERS))
+			snprintf(job->waiters[job->num_waiters++], sizeof(job->waiters[0]), "%s", build->work_str);
+		pthread_mutex_unlock(&tune_lock);
+		applog(LOG_DEBUG, "DEBUG: Autotune: job_%s joins the run for job_%s", build->work_str, job->work_str);
+		return;
+	}
+	pthread_mutex_unlock(&tune_lock);
+
+	job = calloc(1, sizeof(struct tune_job));
+	if (!job)
+		return;
+
+	snprintf(job->work_str, sizeof(job->work_str), "%s", build->work_str);
+	strcpy(job->hash, build->hash);
+	memcpy(job->vm_sizes, build->vm_sizes, sizeof(job->vm_sizes));
+
+	if (!code_buf_append(&job->code, build->code.buf, build->code.len)) {
+		free(job->code.buf);
+		free(job);
+		return;
+	}
+
+	// Registered Before The Thread Starts So Builds Finishing Meanwhile Join It
+	pthread_mutex_lock(&tune_lock);
+	job->next = g_tune_jobs;
+	g_tune_jobs = job;
+	if (pthread_create(&thr, NULL, autotune_thread, job)) {
+		g_tune_jobs = job->next;
+		pthread_mutex_unlock(&tune_lock);
+		applog(LOG_ERR, "ERROR: Unable to start autotune thread");
+		free(job->code.buf);
+		free(job);
+		return;
+	}
+	pthread_mutex_unlock(&tune_lock);
+}
+#endif
+
+#ifndef WIN32
+static void free_build(struct lib_build *build) {
+	int i;
+
+	if (build->fd >= 0)
+		close(build->fd);
+
+	for (i = 0; build->units && (i < build->num_units); i++) {
+		code_buf_free(&build->units[i].code);
+		if (build->units[i].tmp[0])
+			unlink(build->units[i].tmp);
+	}
+
+	code_buf_free(&build->code);
+	free(build->units);
+	free(build);
+}
+
+// Everything That Needs The AST - The Rest Of The Build Can Run On Another Thread
+static struct lib_build *prepare_build(char *work_str) {
+	struct lib_build *build;
+	const char *tuned = NULL;
+	FILE *f;
+
+	build = calloc(1, sizeof(struct lib_build));
+	if (!build)
+		return NULL;
+
+	build->fd = -1;
+	snprintf(build->work_str, sizeof(build->work_str), "%s", work_str);
+
+	applog(LOG_DEBUG, "DEBUG: Converting ElasticPL to C");
+
+	gettimeofday(&build->tv_start, NULL);
+
+	if (!create_c_source(work_str, &build->code)) {
+		applog(LOG_ERR, "Unable to convert ElasticPL to %s code", opt_opencl ? "OpenCL" : "C");
+		free_build(build);
+		return NULL;
+	}
+
+	// Keep A Copy Of The Generated Source For Debugging
+	if (opt_debug_epl) {
+		f = fopen("./work/work_lib.c", "w");
+		if (f) {
+			fwrite(build->code.buf, 1, build->code.len, f);
+			fclose(f);
+		}
+	}
+
+	// Write The Library To Anonymous Memory When Possible, Otherwise To ./work
+	build->fd = create_library_fd(work_str);
+	get_library_path(work_str, build->lib_path, build->fd);
+
+	// Use Flags Found By An Earlier Autotuning Run Of The Same Source
+	snprintf(build->variant, sizeof(build->variant), "%s", job_variants[0]);
+	if (opt_autotune) {
+		get_source_hash(&build->code, build->hash);
+		tuned = get_tuned_variant(build->hash);
+		if (tuned) {
+			snprintf(build->variant, sizeof(build->variant), "%s", tuned);
+			build->tuned = true;
+		}
+		applog(LOG_DEBUG, "DEBUG: Compiler flags: %s%s", build->variant, tuned ? " (autotuned)" : "");
+	}
+
+	build->vm_sizes[0] = ast_vm_ints;
+	build->vm_sizes[1] = ast_vm_uints;
+	build->vm_sizes[2] = ast_vm_longs;
+	build->vm_sizes[3] = ast_vm_ulongs;
+	build->vm_sizes[4] = ast_vm_floats;
+	build->vm_sizes[5] = ast_vm_doubles;
+	build->vm_sizes[6] = ast_submit_sz;
+
+	// Large Jobs Are Split Into Several Units And Compiled In Parallel
+	if ((job_code.len > SPLIT_CODE_SIZE) && !prepare_units(build)) {
+		free_build(build);
+		return NULL;
+	}
+
+	gettimeofday(&build->tv_gen, NULL);
+
+	return build;
+}
+
+static bool run_build(struct lib_build *build) {
+	struct timeval tv_end, diff;
+	bool rc;
+
+	applog(LOG_DEBUG, "DEBUG: Compiling C Library: job_%s", build->work_str);
+
+	if (build->num_units) {
+		rc = compile_units(build);
+		prune_work_cache();
+	}
+	else {
+		char *argv[30];
+		char cflags[256];
+		int n;
+
+		snprintf(cflags, sizeof(cflags), "%s", build->variant);
+		n = add_job_cflags(argv, cflags);
+		argv[n++] = "-shared";
+		argv[n++] = "-o";
+		argv[n++] = build->lib_path;
+		add_job_libs(argv, n);
+
+		rc = run_compiler(argv, &build->code);
+	}
+
+	// The Library List Owns The memfd From Here On (Builds In ./work Are Listed Too, So They Can Be Retired)
+	if (rc) {
+		rc = set_library_fd(build->work_str, build->fd);
+		if (rc)
+			build->fd = -1;
+	}
+
+	// A Fresh Build Replaces Any Library Promoted For The Previous Source
+	if (rc && opt_autotune)
+		set_library_tuned(build->work_str, NULL);
+
+	// Search For Better Flags In The Background While Mining Uses The Default Build
+	if (rc && opt_autotune && !build->tuned && !opt_test_vm)
+		start_autotune(build);
+
+	gettimeofday(&tv_end, NULL);
+
+	timeval_subtract(&diff, &build->tv_gen, &build->tv_start);
+	applog(LOG_DEBUG, "DEBUG: Time to generate C source: %.2f ms (%lu bytes)", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec), (unsigned long)build->code.len);
+	timeval_subtract(&diff, &tv_end, &build->tv_gen);
+	applog(LOG_DEBUG, "DEBUG: Time to compile library: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+
+	return rc;
+}
+
+static void *build_thread(void *userdata) {
+	struct lib_build *build;
+	bool rc;
+
+	pthread_detach(pthread_self());
+
+	while (1) {
+		build = (struct lib_build *)tq_pop(g_build_q, NULL);
+		if (!build)
+			continue;
+
+		rc = run_build(build);
+		build->done(build->work_str, rc);
+		free_build(build);
+	}
+
+	return NULL;
+}
+#endif
+
 bool compile_library(char *work_str) {
-	char lib_name[50], str[256];
-	int ret = 0;
+#ifdef WIN32
+	char lib_name[50], lib_path[100];
+	struct timeval tv_start, tv_gen, tv_end, diff;
+	FILE *f;
 
 	applog(LOG_DEBUG, "DEBUG: Converting ElasticPL to C");
 
-	if (!create_c_source(work_str)) {
+	gettimeofday(&tv_start, NULL);
+
+	if (!create_c_source(work_str, &lib_code)) {
 		applog(LOG_ERR, "Unable to convert ElasticPL to %s code", opt_opencl ? "OpenCL" : "C");
 		return false;
 	}
 
+	gettimeofday(&tv_gen, NULL);
+
 	sprintf(lib_name, "job_%s", work_str);
 	applog(LOG_DEBUG, "DEBUG: Compiling C Library: %s", lib_name);
 
+	// Windows Toolchains Still Build From A Source File In ./work
+	f = fopen("./work/work_lib.c", "w");
+	if (!f)
+		return false;
+	fwrite(lib_code.buf, 1, lib_code.len, f);
+	fclose(f);
+
 #ifdef _MSC_VER
-	sprintf(str, "compile_dll.bat ./work/%s.dll", lib_name);
-	system(str);
-#else
-#ifdef __MINGW32__
-	ret = system("gcc -I./crypto -c -march=native -Ofast -msse -msse2 -msse3 -mmmx -m3dnow -DBUILDING_EXAMPLE_DLL ./work/work_lib.c -o ./work/work_lib.o");
-	sprintf(str, "gcc -shared -o ./work/%s.dll ./work/work_lib.o -L./ElasticPL -L./crypto -lElasticPLFunctions -lcrypto", lib_name);
-	ret = system(str);
-#else
-#ifdef __arm__
-	ret = system("gcc -I./crypto -c -std=c99 -Ofast -fPIC ./work/work_lib.c -o ./work/work_lib.o");
-	sprintf(str, "gcc -std=c99 -shared -Wl,-soname,./work/%s.so.1 -o ./work/%s.so ./work/work_lib.o -L./ElasticPL -L./crypto -lElasticPLFunctions -lcrypto", lib_name, lib_name);
-	ret = system(str);
+	sprintf(lib_path, "compile_dll.bat ./work/%s.dll", lib_name);
+	system(lib_path);
 #else
-	ret = system("gcc -I./crypto -c -g -march=native -Ofast -fPIC ./work/work_lib.c -o ./work/work_lib.o");
-	sprintf(str, "gcc -shared -g -W -o ./work/%s.so ./work/work_lib.o -L./ElasticPL -L./crypto -lElasticPLFunctions -lcrypto", lib_name);
-	ret = system(str);
-#endif
+	system("gcc -I./crypto -I./ElasticPL -c -march=native -Ofast -msse -msse2 -msse3 -mmmx -m3dnow -DBUILDING_EXAMPLE_DLL ./work/work_lib.c -o ./work/work_lib.o");
+	sprintf(lib_path, "gcc -shared -o ./work/%s.dll ./work/work_lib.o -L./ElasticPL -L./crypto -Wl,--whole-archive -lElasticPLRuntime -Wl,--no-whole-archive -lElasticPLFunctions -lcrypto", lib_name);
+	system(lib_path);
 #endif
+
+	gettimeofday(&tv_end, NULL);
+
+	timeval_subtract(&diff, &tv_gen, &tv_start);
+	applog(LOG_DEBUG, "DEBUG: Time to generate C source: %.2f ms (%lu bytes)", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec), (unsigned long)lib_code.len);
+	timeval_subtract(&diff, &tv_end, &tv_gen);
+	applog(LOG_DEBUG, "DEBUG: Time to compile library: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+
+	return true;
+#else
+	struct lib_build *build;
+	bool rc;
+
+	build = prepare_build(work_str);
+	if (!build)
+		return false;
+
+	rc = run_build(build);
+	free_build(build);
+
+	return rc;
 #endif
+}
+
+// Generates The Job's C Source Now (The AST Only Lasts Until The Next Parse) And Compiles
+// It On A Build Thread, Calling 'done' There Once The Library Is Ready.  Returns false If
+// The Build Could Not Be Queued, In Which Case 'done' Is Never Called
+extern bool compile_library_async(char *work_str, void (*done)(char *work_str, bool rc)) {
+#ifdef WIN32
+	done(work_str, compile_library(work_str));
+	return true;
+#else
+	struct lib_build *build;
+	pthread_t thr;
+
+	build = prepare_build(work_str);
+	if (!build)
+		return false;
+	build->done = done;
+
+	// One More Build Thread Per Queued Build, Up To One Per CPU
+	pthread_mutex_lock(&build_lock);
+	if (!g_build_q)
+		g_build_q = tq_new();
+	if (g_build_q && (g_build_threads < num_cpus) && !pthread_create(&thr, NULL, build_thread, NULL))
+		g_build_threads++;
+	pthread_mutex_unlock(&build_lock);
+
+	if (!g_build_threads || !tq_push(g_build_q, build)) {
+		applog(LOG_ERR, "ERROR: Unable to queue build of job_%s", work_str);
+		free_build(build);
+		return false;
+	}
 
 	return true;
+#endif
 }
 
 void create_instance(struct instance* inst, char *work_str) {
 	char lib_name[50], file_name[100];
+	struct timeval tv_start, tv_end, diff;
 
 	sprintf(lib_name, "job_%s", work_str);
 
+	gettimeofday(&tv_start, NULL);
+
 #ifdef WIN32
-	sprintf(file_name, "./work/%s.dll", lib_name);
+	get_library_path(work_str, file_name, -1);
 	inst->hndl = LoadLibrary(file_name);
 	if (!inst->hndl) {
 		fprintf(stderr, "Unable to load library: '%s' (Error - %d)", file_name, GetLastError());
@@ -208,7 +1250,7 @@ void create_instance(struct instance* inst, char *work_str) {
 		exit(EXIT_FAILURE);
 	}
 #else
-	sprintf(file_name, "./work/%s.so", lib_name);
+	get_library_file(work_str, file_name, &inst->version);
 	inst->hndl = dlopen(file_name, RTLD_GLOBAL | RTLD_NOW);
 	if (!inst->hndl) {
 		fprintf(stderr, "%sn", dlerror());
@@ -223,7 +1265,10 @@ void create_instance(struct instance* inst, char *work_str) {
 		exit(EXIT_FAILURE);
 	}
 #endif
-	applog(LOG_DEBUG, "DEBUG: Library '%s' Loaded", lib_name);
+
+	gettimeofday(&tv_end, NULL);
+	timeval_subtract(&diff, &tv_end, &tv_start);
+	applog(LOG_DEBUG, "DEBUG: Library '%s' Loaded (%.2f ms)", lib_name, (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
 }
 
 void free_library(struct instance* inst) {
@@ -239,6 +1284,244 @@ void free_library(struct instance* inst) {
 	}
 }
 
+// Library Version New Instances Of The Job Would Load
+static int current_library_version(char *work_str) {
+	int version = 0;
+#ifndef WIN32
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib)
+		version = lib->version;
+	pthread_mutex_unlock(&job_lib_lock);
+#endif
+
+	return version;
+}
+
+// Package Of The Library Has Left getMineableWork
+static bool library_retired(char *work_str) {
+	bool retired = false;
+#ifndef WIN32
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib)
+		retired = lib->retired;
+	pthread_mutex_unlock(&job_lib_lock);
+#endif
+
+	return retired;
+}
+
+// Keeps A Library Loadable While Something May Still Load It ('pin' = false Releases It)
+extern void library_pin(char *work_str, bool pin) {
+#ifndef WIN32
+	struct job_library *lib;
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, pin);
+	if (lib && pin) {
+		lib->pins++;
+	}
+	else if (lib && (lib->pins > 0)) {
+		lib->pins--;
+		if (!lib->pins && lib->retired)
+			drop_job_library(lib);
+	}
+	pthread_mutex_unlock(&job_lib_lock);
+#endif
+}
+
+// Returns A Shared Instance Of The Job Library, Loading It Only If It Is Not Already Resident.
+// Every Call Must Be Paired With release_instance(); initialize() Is Still Per Thread (TLS)
+extern struct instance *acquire_instance(char *work_str) {
+	struct job_instance *ji = NULL, **list;
+	int i, version;
+
+	version = current_library_version(work_str);
+
+	pthread_mutex_lock(&job_inst_lock);
+
+	for (i = 0; i < g_job_inst_cnt; i++) {
+		if (!strcmp(g_job_inst[i]->work_str, work_str) && (g_job_inst[i]->inst.version == version)) {
+			ji = g_job_inst[i];
+			break;
+		}
+	}
+
+	if (!ji) {
+		list = realloc(g_job_inst, (g_job_inst_cnt + 1) * sizeof(struct job_instance *));
+		ji = calloc(1, sizeof(struct job_instance));
+		if (!list || !ji) {
+			if (list)
+				g_job_inst = list;
+			free(ji);
+			pthread_mutex_unlock(&job_inst_lock);
+			applog(LOG_ERR, "ERROR: Unable to allocate memory for job instance");
+			return NULL;
+		}
+		g_job_inst = list;
+		g_job_inst[g_job_inst_cnt++] = ji;
+		snprintf(ji->work_str, sizeof(ji->work_str), "%s", work_str);
+
+		// Loading Under The Lock Keeps Two Threads From Loading The Same Job
+		create_instance(&ji->inst, work_str);
+		library_pin(work_str, true);
+	}
+
+	ji->refcnt++;
+
+	pthread_mutex_unlock(&job_inst_lock);
+
+	return &ji->inst;
+}
+
+// Caller Must Hold job_inst_lock
+static void unload_instance(int idx) {
+	struct job_instance *ji = g_job_inst[idx];
+
+	applog(LOG_DEBUG, "DEBUG: Unloading library 'job_%s'", ji->work_str);
+	free_library(&ji->inst);
+	library_pin(ji->work_str, false);
+	free(ji);
+	g_job_inst[idx] = g_job_inst[--g_job_inst_cnt];
+}
+
+// Drops A Reference From acquire_instance().  Idle Libraries Stay Loaded For A Quick Switch
+// Back, Up To MAX_IDLE_INSTANCES; Beyond That, Once Superseded Or Once Retired They Are Unloaded
+extern void release_instance(struct instance *inst) {
+	struct job_instance *ji;
+	int i, idle, lru;
+
+	if (!inst)
+		return;
+
+	pthread_mutex_lock(&job_inst_lock);
+
+	for (i = 0; i < g_job_inst_cnt; i++) {
+		ji = g_job_inst[i];
+		if (&ji->inst == inst) {
+			ji->refcnt--;
+			ji->last_used = ++g_job_inst_tick;
+			break;
+		}
+	}
+
+	while (1) {
+		idle = 0;
+		lru = -1;
+		for (i = 0; i < g_job_inst_cnt; i++) {
+			if (g_job_inst[i]->refcnt)
+				continue;
+
+			// An Autotuned Build Has Replaced This One, Or The Package Is Gone
+			if ((g_job_inst[i]->inst.version != current_library_version(g_job_inst[i]->work_str)) || library_retired(g_job_inst[i]->work_str)) {
+				lru = i;
+				idle = MAX_IDLE_INSTANCES + 1;
+				break;
+			}
+
+			idle++;
+			if ((lru < 0) || (g_job_inst[i]->last_used < g_job_inst[lru]->last_used))
+				lru = i;
+		}
+
+		if (idle <= MAX_IDLE_INSTANCES)
+			break;
+
+		unload_instance(lru);
+	}
+
+	pthread_mutex_unlock(&job_inst_lock);
+}
+
+// Package Left getMineableWork - Idle Instances Are Unloaded Now, The Others When Released,
+// And The Library (With Its memfd) Is Dropped Once Nothing Pins It
+extern void library_retire(char *work_str) {
+#ifndef WIN32
+	struct job_library *lib;
+	int i;
+
+	pthread_mutex_lock(&job_inst_lock);
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib)
+		lib->retired = true;
+	pthread_mutex_unlock(&job_lib_lock);
+
+	for (i = g_job_inst_cnt - 1; i >= 0; i--) {
+		if (!g_job_inst[i]->refcnt && !strcmp(g_job_inst[i]->work_str, work_str))
+			unload_instance(i);
+	}
+
+	pthread_mutex_lock(&job_lib_lock);
+	lib = find_job_library(work_str, false);
+	if (lib && lib->retired && !lib->pins)
+		drop_job_library(lib);
+	pthread_mutex_unlock(&job_lib_lock);
+
+	pthread_mutex_unlock(&job_inst_lock);
+#endif
+}
+
+// Run 'main' For About 'ms' Milliseconds With A New Input Each Pass And Return kEval/s
+// vm_sizes Holds The Number Of ints, uints, longs, ulongs, floats, doubles & submit Values
+double run_benchmark(struct instance *inst, uint32_t *vm_sizes, int ms) {
+	struct timeval tv_start, tv_end, diff;
+	uint32_t bounty_found, pow_found, target[4] = { 0 }, hash[4];
+	uint32_t *m, *u, *s;
+	int32_t *i;
+	int64_t *l;
+	uint64_t *ul;
+	float *f;
+	double *d;
+	uint64_t evals = 0;
+	double run_ms = 0.0;
+	int n;
+
+	m = calloc(VM_M_ARRAY_SIZE, sizeof(uint32_t));
+	i = calloc(vm_sizes[0] + 1, sizeof(int32_t));
+	u = calloc(vm_sizes[1] + 1, sizeof(uint32_t));
+	l = calloc(vm_sizes[2] + 1, sizeof(int64_t));
+	ul = calloc(vm_sizes[3] + 1, sizeof(uint64_t));
+	f = calloc(vm_sizes[4] + 1, sizeof(float));
+	d = calloc(vm_sizes[5] + 1, sizeof(double));
+	s = calloc(vm_sizes[6] + 1, sizeof(uint32_t));
+
+	if (!m || !i || !u || !l || !ul || !f || !d || !s) {
+		applog(LOG_ERR, "ERROR: Unable to allocate VM memory for benchmark");
+		goto out;
+	}
+
+	inst->initialize(m, i, u, l, ul, f, d, s);
+
+	gettimeofday(&tv_start, NULL);
+	do {
+		for (n = 0; n < 100; n++) {
+			m[0] = (uint32_t)evals++;
+			inst->execute(0, &bounty_found, 1, &pow_found, target, hash);
+		}
+		gettimeofday(&tv_end, NULL);
+		timeval_subtract(&diff, &tv_end, &tv_start);
+		run_ms = (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec);
+	} while (run_ms < ms);
+
+out:
+	free(m);
+	free(i);
+	free(u);
+	free(l);
+	free(ul);
+	free(f);
+	free(d);
+	free(s);
+
+	return (run_ms > 0.0) ? (double)evals / run_ms : 0.0;
+}
+
 /*
 * The md5 kernel was heavily inspired by the md5 kernel in john the ripper
 * community enhanced version. See https://github.com/magnumripper/JohnTheRipper
@@ -432,6 +1715,132 @@ extern bool create_opencl_source(char *work_str) {
 	fprintf(f, "\treturn (x>>n) | (x<<( (-n) & 0x0000001f ));\n");
 	fprintf(f, "}\n\n");
 
+	// Crypto Block Functions - Same Semantics As ElasticPLCrypto.c (Out Of Range Calls Are Ignored)
+	fprintf(f, "__constant uint sha256_k[64] = {\n");
+	fprintf(f, "\t0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,\n");
+	fprintf(f, "\t0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,\n");
+	fprintf(f, "\t0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,\n");
+	fprintf(f, "\t0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,\n");
+	fprintf(f, "\t0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,\n");
+	fprintf(f, "\t0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,\n");
+	fprintf(f, "\t0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,\n");
+	fprintf(f, "\t0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2\n");
+	fprintf(f, "};\n\n");
+
+	fprintf(f, "static void sha256_block(uint *u, uint size, ulong dst, ulong src) {\n");
+	fprintf(f, "\tuint w[64], s[8], t1, t2;\n");
+	fprintf(f, "\tint i;\n\n");
+	fprintf(f, "\tif ((size < 16) || (dst > (ulong)(size - 8)) || (src > (ulong)(size - 16)))\n");
+	fprintf(f, "\t\treturn;\n\n");
+	fprintf(f, "\tfor (i = 0; i < 16; i++)\n");
+	fprintf(f, "\t\tw[i] = u[src + i];\n");
+	fprintf(f, "\tfor (i = 16; i < 64; i++)\n");
+	fprintf(f, "\t\tw[i] = (rotate(w[i - 2], 15U) ^ rotate(w[i - 2], 13U) ^ (w[i - 2] >> 10)) + w[i - 7] + (rotate(w[i - 15], 25U) ^ rotate(w[i - 15], 14U) ^ (w[i - 15] >> 3)) + w[i - 16];\n");
+	fprintf(f, "\tfor (i = 0; i < 8; i++)\n");
+	fprintf(f, "\t\ts[i] = u[dst + i];\n\n");
+	fprintf(f, "\tfor (i = 0; i < 64; i++) {\n");
+	fprintf(f, "\t\tt1 = s[7] + (rotate(s[4], 26U) ^ rotate(s[4], 21U) ^ rotate(s[4], 7U)) + bitselect(s[6], s[5], s[4]) + sha256_k[i] + w[i];\n");
+	fprintf(f, "\t\tt2 = (rotate(s[0], 30U) ^ rotate(s[0], 19U) ^ rotate(s[0], 10U)) + bitselect(s[1], s[0], s[1] ^ s[2]);\n");
+	fprintf(f, "\t\ts[7] = s[6]; s[6] = s[5]; s[5] = s[4]; s[4] = s[3] + t1;\n");
+	fprintf(f, "\t\ts[3] = s[2]; s[2] = s[1]; s[1] = s[0]; s[0] = t1 + t2;\n");
+	fprintf(f, "\t}\n\n");
+	fprintf(f, "\tfor (i = 0; i < 8; i++)\n");
+	fprintf(f, "\t\tu[dst + i] += s[i];\n");
+	fprintf(f, "}\n\n");
+
+	// md5_round Reads The Whole Block Before Writing The State, So Overlaps Are Safe
+	fprintf(f, "static void md5_block(uint *u, uint size, ulong dst, ulong src) {\n");
+	fprintf(f, "\tif ((size < 16) || (dst > (ulong)(size - 4)) || (src > (ulong)(size - 16)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tmd5_round(&u[dst], (const uint*)&u[src]);\n");
+	fprintf(f, "}\n\n");
+
+	fprintf(f, "__constant ulong keccak_rc[24] = {\n");
+	fprintf(f, "\t0x0000000000000001UL, 0x0000000000008082UL, 0x800000000000808aUL, 0x8000000080008000UL,\n");
+	fprintf(f, "\t0x000000000000808bUL, 0x0000000080000001UL, 0x8000000080008081UL, 0x8000000000008009UL,\n");
+	fprintf(f, "\t0x000000000000008aUL, 0x0000000000000088UL, 0x0000000080008009UL, 0x000000008000000aUL,\n");
+	fprintf(f, "\t0x000000008000808bUL, 0x800000000000008bUL, 0x8000000000008089UL, 0x8000000000008003UL,\n");
+	fprintf(f, "\t0x8000000000008002UL, 0x8000000000000080UL, 0x000000000000800aUL, 0x800000008000000aUL,\n");
+	fprintf(f, "\t0x8000000080008081UL, 0x8000000000008080UL, 0x0000000080000001UL, 0x8000000080008008UL\n");
+	fprintf(f, "};\n\n");
+	fprintf(f, "__constant uint keccak_rotc[24] = { 1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44 };\n");
+	fprintf(f, "__constant uint keccak_piln[24] = { 10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1 };\n\n");
+
+	fprintf(f, "static void keccak_f1600(ulong *ul, uint size, ulong dst) {\n");
+	fprintf(f, "\tulong *st, bc[5], t;\n");
+	fprintf(f, "\tint i, j, r;\n\n");
+	fprintf(f, "\tif ((size < 25) || (dst > (ulong)(size - 25)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tst = &ul[dst];\n\n");
+	fprintf(f, "\tfor (r = 0; r < 24; r++) {\n");
+	fprintf(f, "\t\tfor (i = 0; i < 5; i++)\n");
+	fprintf(f, "\t\t\tbc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];\n");
+	fprintf(f, "\t\tfor (i = 0; i < 5; i++) {\n");
+	fprintf(f, "\t\t\tt = bc[(i + 4) %% 5] ^ rotate(bc[(i + 1) %% 5], 1UL);\n");
+	fprintf(f, "\t\t\tfor (j = 0; j < 25; j += 5)\n");
+	fprintf(f, "\t\t\t\tst[j + i] ^= t;\n");
+	fprintf(f, "\t\t}\n");
+	fprintf(f, "\t\tt = st[1];\n");
+	fprintf(f, "\t\tfor (i = 0; i < 24; i++) {\n");
+	fprintf(f, "\t\t\tj = keccak_piln[i];\n");
+	fprintf(f, "\t\t\tbc[0] = st[j];\n");
+	fprintf(f, "\t\t\tst[j] = rotate(t, (ulong)keccak_rotc[i]);\n");
+	fprintf(f, "\t\t\tt = bc[0];\n");
+	fprintf(f, "\t\t}\n");
+	fprintf(f, "\t\tfor (j = 0; j < 25; j += 5) {\n");
+	fprintf(f, "\t\t\tfor (i = 0; i < 5; i++)\n");
+	fprintf(f, "\t\t\t\tbc[i] = st[j + i];\n");
+	fprintf(f, "\t\t\tfor (i = 0; i < 5; i++)\n");
+	fprintf(f, "\t\t\t\tst[j + i] ^= (~bc[(i + 1) %% 5]) & bc[(i + 2) %% 5];\n");
+	fprintf(f, "\t\t}\n");
+	fprintf(f, "\t\tst[0] ^= keccak_rc[r];\n");
+	fprintf(f, "\t}\n");
+	fprintf(f, "}\n\n");
+
+	fprintf(f, "static void array_copy32(uint *dst_arr, uint dst_size, uint *src_arr, uint src_size, ulong dst, ulong src, ulong n) {\n");
+	fprintf(f, "\tulong k;\n\n");
+	fprintf(f, "\tif (!n || (n > dst_size) || (n > src_size) || (dst > (ulong)(dst_size - n)) || (src > (ulong)(src_size - n)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tif ((dst_arr != src_arr) || (dst < src)) {\n");
+	fprintf(f, "\t\tfor (k = 0; k < n; k++)\n");
+	fprintf(f, "\t\t\tdst_arr[dst + k] = src_arr[src + k];\n");
+	fprintf(f, "\t}\n");
+	fprintf(f, "\telse {\n");
+	fprintf(f, "\t\tfor (k = n; k > 0; k--)\n");
+	fprintf(f, "\t\t\tdst_arr[dst + k - 1] = src_arr[src + k - 1];\n");
+	fprintf(f, "\t}\n");
+	fprintf(f, "}\n\n");
+
+	fprintf(f, "static void array_fill32(uint *arr, uint size, ulong dst, uint value, ulong n) {\n");
+	fprintf(f, "\tulong k;\n\n");
+	fprintf(f, "\tif (!n || (n > size) || (dst > (ulong)(size - n)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tfor (k = 0; k < n; k++)\n");
+	fprintf(f, "\t\tarr[dst + k] = value;\n");
+	fprintf(f, "}\n\n");
+
+	fprintf(f, "static void array_copy64(ulong *dst_arr, uint dst_size, ulong *src_arr, uint src_size, ulong dst, ulong src, ulong n) {\n");
+	fprintf(f, "\tulong k;\n\n");
+	fprintf(f, "\tif (!n || (n > dst_size) || (n > src_size) || (dst > (ulong)(dst_size - n)) || (src > (ulong)(src_size - n)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tif ((dst_arr != src_arr) || (dst < src)) {\n");
+	fprintf(f, "\t\tfor (k = 0; k < n; k++)\n");
+	fprintf(f, "\t\t\tdst_arr[dst + k] = src_arr[src + k];\n");
+	fprintf(f, "\t}\n");
+	fprintf(f, "\telse {\n");
+	fprintf(f, "\t\tfor (k = n; k > 0; k--)\n");
+	fprintf(f, "\t\t\tdst_arr[dst + k - 1] = src_arr[src + k - 1];\n");
+	fprintf(f, "\t}\n");
+	fprintf(f, "}\n\n");
+
+	fprintf(f, "static void array_fill64(ulong *arr, uint size, ulong dst, ulong value, ulong n) {\n");
+	fprintf(f, "\tulong k;\n\n");
+	fprintf(f, "\tif (!n || (n > size) || (dst > (ulong)(size - n)))\n");
+	fprintf(f, "\t\treturn;\n");
+	fprintf(f, "\tfor (k = 0; k < n; k++)\n");
+	fprintf(f, "\t\tarr[dst + k] = value;\n");
+	fprintf(f, "}\n\n");
+
 	fprintf(f, "static uint check_pow(uint msg_0, uint msg_1, uint msg_2, uint msg_3, uint *m, uint *target, uint *hash) {\n");
 	fprintf(f, "\tint i;\n");
 	fprintf(f, "\tchar msg[48];\n");
@@ -81,6 +81,15 @@ uint64_t opt_wcet_main = 0;
 uint64_t opt_wcet_verify = 0;
 int opt_deadswitch = 0;
 bool opt_opencl = false;
+bool opt_autotune = false;
+bool opt_hugepages = false;
+static uint32_t opt_shard = 0;		// This Process Mines Slice opt_shard Of opt_shards (--shard k/n)
+static uint32_t opt_shards = 1;
+static int opt_portfolio = 1;		// Number Of Work Packages Mined Concurrently
+static bool opt_supervise = false;	// Run Each CPU Miner Thread In A Worker Process (See supervisor.c)
+static int opt_proxy_port = 0;		// Serve Other Miners Instead Of Mining (See proxy.c)
+static char opt_proxy_bind[64] = "127.0.0.1";	// Address The Proxy Listens On
+static int opt_submit_conc = 4;		// Max Solutions Being Submitted At Once
 int opt_opencl_gthreads = 0;
 int opt_opencl_vwidth = 0;
 int opt_timeout = 30;
@@ -88,8 +97,8 @@ int opt_n_threads = 0;
 static enum prefs opt_pref = PREF_PROFIT;
 char pref_workid[32];
 bool opt_validate_work = false;
-volatile bool* g_pow_ignore = NULL;
-volatile bool* g_bounty_ignore = NULL;
+volatile bool g_pow_ignore = false;		// Every Package Being Mined Has Reached Its POW Limit
+volatile bool g_bounty_ignore = false;		// Every Package Being Mined Has Reached Its Bounty Limit
 
 int delay_sleep = 0;
 int ignore_mask = 0;
@@ -118,6 +127,10 @@ pthread_mutex_t work_lock = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t submit_lock = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t longpoll_lock = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t went_through_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t park_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t storage_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t park_cond = PTHREAD_COND_INITIALIZER;
+volatile uint32_t g_park_gen = 0;		// Bumped Each Time Idle Miner Threads Should Re-Check Their Work
 
 
 uint8_t *rpc_url = NULL;
@@ -130,13 +143,16 @@ uint8_t *test_filename = NULL;
 
 struct timeval g_miner_start_time;
 struct work g_work = { 0 };
+struct work *g_thr_work = NULL;		// Work Assigned To Each Miner Thread By The Portfolio Scheduler
 volatile time_t g_work_time = 0;
+volatile bool g_rebalance = false;
 struct work_package *g_work_package;
 volatile int g_work_package_cnt = 0;
 volatile int g_work_package_idx = 0;
 const uint8_t basepoint[32] = { 9 };
 
-struct submit_req *g_submit_req;
+struct submit_req **g_submit_heap = NULL;	// Pending Solutions, Binary Heap Ordered By submit_before()
+static int g_submit_heap_sz = 0;
 volatile int g_submit_req_cnt = 0;
 volatile int g_new_block = false;
 
@@ -149,7 +165,15 @@ uint32_t g_pow_accepted_cnt = 0;
 uint32_t g_pow_rejected_cnt = 0;
 uint32_t g_pow_discarded_cnt = 0;
 bool g_opt_avoidcache = false;
+bool opt_test_decode_bench = false;
 int work_thr_id;
+int submit_thr_id;
+static CURLM *g_submit_multi = NULL;	// Submit Engine, Woken By submit_push()
+static CURLM *g_fetch_multi = NULL;		// Source & Storage Requests Of The workio Thread
+static CURLM *g_storage_multi = NULL;	// Storage Requests Of storage_thread
+static struct thread_q *g_storage_q = NULL;
+static struct storage_entry g_storage_cache[STORAGE_CACHE_SZ];
+static uint32_t g_storage_tick = 0;
 struct thr_info *thr_info;
 struct thr_info *thr_deadswitch = NULL;
 
@@ -221,13 +245,20 @@ void *deadswitch(void *arg)
 static char const usage[] = "\
 Usage: " PACKAGE_NAME " [OPTIONS]\n\
 Options:\n\
+      --autotune              Benchmark compiler flag variants in the background and switch to the fastest\n\
   -c, --config <file>         Use JSON-formated configuration file\n\
+      --cpu-affinity <policy> Pin miner threads to CPUs\n\
+                                none         (Default) Let the OS place threads\n\
+                                cores        Physical cores first, then SMT siblings\n\
+                                nosmt        Physical cores only\n\
+                                <list>       CPU list, e.g. 0-7,16-23\n\
       --deadswitch <seconds>  Hardkill the instance after x seconds\n\
   -D, --debug                 Display debug output\n\
       --debug-epl             Display EPL source code\n\
   -d, --delaysleep	     	  Sleep x seconds after submitting POW: useful for burstless debugging\n \
   -i, --ignoremask			  Debug only: ignore 0=nothing, 1=PoW, 2=Bty, 3=Both\n \
   -h, --help                  Display this help text and exit\n\
+      --hugepages             Back the VM memory of each miner thread with huge pages\n\
   -m, --mining PREF[:ID]      Mining preference for choosing work\n\
                                 profit       (Default) Estimate most profitable based on POW Reward / WCET\n\
                                 wcet         Fewest cycles required by work item \n\
@@ -239,15 +270,22 @@ Options:\n\
   -o, --url=URL               URL of mining server\n\
   -p, --pass <password>       Password for mining server\n\
   -P, --phrase <passphrase>   Secret Passphrase for Elastic account\n\
+      --portfolio <n>         Split threads across the n best work packages (1 - 16, default: 1)\n\
       --protocol              Display dump of protocol-level activities\n\
+      --proxy <port>          Don't mine - serve work from one node session to other miners on <port>\n\
+      --proxy-bind <addr>     Address the proxy listens on (default: 127.0.0.1, 0.0.0.0 for all)\n\
   -q, --quiet                 Display minimal output\n\
   -r, --retries <n>           Number of times to retry if a network call fails\n\
                               (Default: Retry indefinitely)\n\
   -R, --retry-pause <n>       Time to pause between retries (Default: 10 sec)\n\
   -s, --scan-time <n>         Max time to scan work before requesting new work (Default: 60 sec)\n\
+      --shard <k/n>           Only mine slice k (0 - n-1) of n, so n miners on one account never repeat a round\n\
+      --submit-conc <n>       Max solutions submitted concurrently (1 - 32, default: 4)\n\
+      --supervise             Run each miner thread in a worker process that is restarted if a job crashes\n\
   	  --test-miner <file>     Run the Miner using JSON formatted work in <file>\n\
       --test-vm <file>        Run the Parser / Compiler using the ElasticPL source code in <file>\n\
 	  --test-avoidcache   	  Do not save metadata\n\
+	  --test-decode-bench     Compare getMineableWork decoding with jansson and the stream parser\n\
       --test-block <block>	  Block-id for test run\n\
 	  --test-cont-bounty      Search for bounties within test-vm environment\n\
 	  --test-cont-pow         Search for proof-of-work within test-vm environment\n\
@@ -275,12 +313,15 @@ Options while mining ----------------------------------------------------------\
 static char const short_options[] = "c:Dd:i:k:hm:o:p:P:qr:R:s:St:T:u:vVX";
 
 static struct option const options[] = {
+	{ "autotune",		0, NULL, 1024 },
 	{ "config",			1, NULL, 'c' },
+	{ "cpu-affinity",	1, NULL, 1025 },
 	{ "deadswitch",		1, NULL, 1019 },
 	{ "debug",			0, NULL, 'D' },
 	{ "delaysleep",		1, NULL, 'd' },
 	{ "debug-epl",		0, NULL, 1007 },
 	{ "help",			0, NULL, 'h' },
+	{ "hugepages",		0, NULL, 1026 },
 	{ "ignoremask",		1, NULL, 'i' },
 	{ "mining",			1, NULL, 'm' },
 	{ "no-color",		0, NULL, 1001 },
@@ -290,15 +331,22 @@ static struct option const options[] = {
 	{ "opencl-vwidth",	1, NULL, 1009 },
 	{ "pass",			1, NULL, 'p' },
 	{ "phrase",			1, NULL, 'P' },
+	{ "portfolio",		1, NULL, 1028 },
+	{ "proxy",			1, NULL, 1031 },
+	{ "proxy-bind",		1, NULL, 1032 },
 	{ "protocol",	    0, NULL, 1003 },
 	{ "public",			1, NULL, 'k' },
 	{ "quiet",			0, NULL, 'q' },
 	{ "retries",		1, NULL, 'r' },
 	{ "retry-pause",	1, NULL, 'R' },
 	{ "scan-time",		1, NULL, 's' },
+	{ "shard",			1, NULL, 1027 },
+	{ "supervise",		0, NULL, 1029 },
+	{ "submit-conc",	1, NULL, 1030 },
 	{ "test-miner",		1, NULL, 1004 },
 	{ "test-vm",		1, NULL, 1005 },
 	{ "test-avoidcache",	0, NULL, 1022 },
+	{ "test-decode-bench",	0, NULL, 2003 },
 	{ "test-block",	1, NULL, 1011 },
 	{ "test-cont-pow",	0, NULL, 2000 },
 	{ "test-cont-bounty",	0, NULL, 2001 },
@@ -545,6 +593,61 @@ void parse_arg(int key, char *arg)
 	case 1006:
 		opt_opencl = true;
 		break;
+	case 1024:
+		opt_autotune = true;
+		break;
+	case 1025:
+		if (!affinity_set_policy(arg)) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		break;
+	case 1026:
+		opt_hugepages = true;
+		break;
+	case 1027:
+		if ((sscanf(arg, "%u/%u", &opt_shard, &opt_shards) != 2) || (opt_shards < 1) || (opt_shard >= opt_shards)) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		break;
+	case 1028:
+		v = atoi(arg);
+		if (v < 1 || v > MAX_PORTFOLIO) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		opt_portfolio = v;
+		break;
+	case 1029:
+		opt_supervise = true;
+		break;
+	case 1031:
+		v = atoi(arg);
+		if (v < 1 || v > 65535) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		opt_proxy_port = v;
+		break;
+	case 1032:
+		if (strlen(arg) >= sizeof(opt_proxy_bind)) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		strcpy(opt_proxy_bind, arg);
+		break;
+	case 1030:
+		v = atoi(arg);
+		if (v < 1 || v > 32) {
+			free_up();
+			show_usage_and_exit(1);
+		}
+		opt_submit_conc = v;
+		break;
+	case 2003:
+		opt_test_decode_bench = true;
+		break;
 	case 2000:
 		opt_continuous_test_pow = true;
 		break;
@@ -709,23 +812,6 @@ static void show_version_and_exit(void)
 	exit(0);
 }
 
-static void thread_low_priority() {
-#if defined (__unix__)  && defined (__MACH__)
-	uint64_t tid = syscall(__NR_gettid);
-	int rc = setpriority(PRIO_PROCESS, tid, 7);
-	if (rc) {
-		applog(LOG_ERR, "Error(%d): failed setting thread priority (you are safe to ignore this message)", rc);
-	}
-	else {
-		if (opt_debug)
-			applog(LOG_DEBUG, "setting low thread priority for thread id %ld", tid);
-	}
-#else
-	// TODO: implement for non posix platforms
-	// Possibly: Use SetThreadPriority() on windows
-#endif// Create Test Work
-}
-
 static bool load_test_file(char *file_name, char *buf) {
 	int i, fsize, len, bytes;
 	char *ptr;
@@ -1154,8 +1240,8 @@ static void *test_vm_thread(void *userdata) {
 		for (i = 0; i < 2; i++) {
 //		for (i = 1250; i < 1300; i++) {
 
-			// Update Round Number
-			rnd_num[0] = i;
+			// Update First Round Number Of The Pass
+			rnd_num[0] = i * gpu[0].threads;
 
 			// Execute The Code On The GPU
 			if (!opencl_run_kernel(&gpu[0], rnd_num, result, output, submit, g_work_package[0].storage_sz))
@@ -1406,10 +1492,10 @@ static bool get_opencl_base_data(struct work *work, uint32_t *vm_input) {
 	vm_input[19] = swap32(vm_input[19]);
 
 	// Target
-	vm_input[20] = g_pow_target[0];
-	vm_input[21] = g_pow_target[1];
-	vm_input[22] = g_pow_target[2];
-	vm_input[23] = g_pow_target[3];
+	vm_input[20] = work->pow_target[0];
+	vm_input[21] = work->pow_target[1];
+	vm_input[22] = work->pow_target[2];
+	vm_input[23] = work->pow_target[3];
 	//vm_input[20] = work->pow_target[0];
 	//vm_input[21] = work->pow_target[1];
 	//vm_input[22] = work->pow_target[2];
@@ -1418,7 +1504,7 @@ static bool get_opencl_base_data(struct work *work, uint32_t *vm_input) {
 	return true;
 }
 
-static int execute_vm(int thr_id, uint32_t *rnd, uint32_t iteration, struct work *work, struct instance *inst, long *hashes_done) {
+static int execute_vm(int thr_id, struct nonce_range *nonce, uint32_t iteration, struct work *work, struct instance *inst, uint32_t verify_pow, long *hashes_done) {
 	int rc;
 	time_t t_start = time(NULL);
 	char msg[64];
@@ -1427,19 +1513,26 @@ static int execute_vm(int thr_id, uint32_t *rnd, uint32_t iteration, struct work
 	uint32_t *msg32 = (uint32_t *)msg;
 	uint32_t *mult32 = (uint32_t *)work->multiplicator;
 
-	mult32[0] = thr_id;												// Ensures Each Thread Is Unique
-//	mult32[1] = *rnd;												// Round - Value Will Be Incremented On Each Pass
+	mult32[0] = 0;													// N/A - Rounds Are Unique Across Threads
 	mult32[2] = iteration;											// Iteration - Not Implemented Yet
 	mult32[3] = 0;													// N/A - GPU OpenCL Thread ID
-	mult32[7] = genrand_int32();									// Random Number
+	mult32[7] = nonce_salt;											// Random Number (Per Process)
 
 	while (1) {
 		// Check If New Work Is Available
 		if (work_restart[thr_id].restart)
 			return 0;
 
+		// Claim The Next Block Of Rounds Once This One Is Used Up
+		if (nonce->next == nonce->end) {
+			nonce->next = nonce_alloc(NONCE_BLOCK);
+			nonce->end = nonce->next + NONCE_BLOCK;
+		}
+
 		// Get Values For VM Inputs
-		mult32[1] = (*rnd)++;												// Round - Value Will Be Incremented On Each Pass
+		mult32[1] = (uint32_t)nonce->next;								// Round (Lower 32 Bits)
+		mult32[4] = (uint32_t)(nonce->next >> 32);						// Round (Upper 32 Bits)
+		nonce->next++;
 		get_vm_input(work);
 
 		// Reset VM Memory
@@ -1447,7 +1540,7 @@ static int execute_vm(int thr_id, uint32_t *rnd, uint32_t iteration, struct work
 
 		// Execute The VM Logic
 //		rc = inst->execute(work->work_id, &bounty_found, 1, &pow_found, work->pow_target, work->pow_hash);
-		rc = inst->execute(work->work_id, &bounty_found, 1, &pow_found, g_pow_target, work->pow_hash);
+		rc = inst->execute(work->work_id, &bounty_found, verify_pow, &pow_found, work->pow_target, work->pow_hash);
 
 		if (opt_test_miner) {
 			dump_vm(work->package_id);
@@ -1455,8 +1548,15 @@ static int execute_vm(int thr_id, uint32_t *rnd, uint32_t iteration, struct work
 		}
 
 		// Bounty or POW Found, Exit Immediately
-		if (bounty_found)
+		if (bounty_found) {
+
+			// The Bounty Submission Carries The POW Hash, So Rerun The Round To Get It
+			if (!verify_pow) {
+				memcpy(vm_m, work->vm_input, VM_M_ARRAY_SIZE * sizeof(uint32_t));
+				rc = inst->execute(work->work_id, &bounty_found, 1, &pow_found, work->pow_target, work->pow_hash);
+			}
 			return 1;
+		}
 		else if (pow_found)
 			return 2;
 
@@ -1536,6 +1636,7 @@ static void dump_vm(int idx) {
 static void update_pending_cnt(uint64_t work_id, bool add) {
 	int i;
 
+	pthread_mutex_lock(&work_lock);
 	for (i = 0; i < g_work_package_cnt; i++) {
 		if (work_id == g_work_package[i].work_id) {
 
@@ -1547,33 +1648,43 @@ static void update_pending_cnt(uint64_t work_id, bool add) {
 			break;
 		}
 	}
+	pthread_mutex_unlock(&work_lock);
 }
 
 extern void clear_all_workpackages(){
 	int i=0;
 	for(i=0; i<g_work_package_cnt; ++i){
-			if(g_work_package[i].storage)
-				free(g_work_package[i].storage);
+			storage_release(g_work_package[i].storage);
+	}
+	for (i = 0; i < STORAGE_CACHE_SZ; i++) {
+		storage_release(g_storage_cache[i].buf);
+		g_storage_cache[i].buf = NULL;
 	}
 	free(g_work_package);
 }
 extern bool add_work_package(struct work_package *work_package) {
+
+	// The Submit Thread Looks Packages Up Under work_lock, So Hold It While The List Moves
+	pthread_mutex_lock(&work_lock);
 	g_work_package = realloc(g_work_package, sizeof(struct work_package) * (g_work_package_cnt + 1));
 	if (!g_work_package) {
+		pthread_mutex_unlock(&work_lock);
 		applog(LOG_ERR, "ERROR: Unable to allocate memory for work_package");
 		return false;
 	}
 
 	memcpy(&g_work_package[g_work_package_cnt], work_package, sizeof(struct work_package));
 	g_work_package_cnt++;
+	pthread_mutex_unlock(&work_lock);
 
 	return true;
 }
 
 static bool get_work(CURL *curl) {
 	int err, rc;
-	json_t *val;
-	struct work work;
+	bool ok;
+	static struct mineable_work mw;		// Reused So Polling Doesn't Reallocate The Package List
+	struct work work[MAX_PORTFOLIO];
 	struct timeval tv_start, tv_end, diff;
 
 	memset(g_work_id, 0, sizeof(g_work_id));
@@ -1582,26 +1693,16 @@ static bool get_work(CURL *curl) {
 
 	gettimeofday(&tv_start, NULL);
 	if (!opt_test_miner) {
-		val = json_rpc_call(curl, rpc_url, rpc_userpass, "requestType=getMineableWork&n=1", &err);
+		ok = get_mineable_work(curl, rpc_url, rpc_userpass, &mw, &err);
 	}
 	else {
-		json_error_t err_val;
-		val = JSON_LOAD_FILE(test_filename, &err_val);
-		if (!json_is_object(val)) {
-			if (err_val.line < 0)
-				applog(LOG_ERR, "%s\n", err_val.text);
-			else
-				applog(LOG_ERR, "%s:%d: %s\n", test_filename, err_val.line, err_val.text);
+		ok = load_mineable_work(test_filename, &mw);
+		if (!ok)
 			return false;
-		}
-
-		char *str = json_dumps(val, JSON_INDENT(3));
-		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
-		free(str);
 	}
 
-	if (!val) {
-		applog(LOG_ERR, "ERROR: 'json_rpc_call' failed...retrying in %d seconds", opt_fail_pause);
+	if (!ok) {
+		applog(LOG_ERR, "ERROR: 'getMineableWork' failed...retrying in %d seconds", opt_fail_pause);
 		sleep(opt_fail_pause);
 		return false;
 	}
@@ -1612,8 +1713,7 @@ static bool get_work(CURL *curl) {
 		applog(LOG_DEBUG, "DEBUG: Time to get work: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
 	}
 
-	rc = decode_work(curl, val, &work);
-	json_decref(val);
+	rc = decode_work(curl, &mw, work);
 
 	gettimeofday(&tv_start, NULL);
 	if (opt_protocol) {
@@ -1626,11 +1726,11 @@ static bool get_work(CURL *curl) {
 	g_work_time = time(NULL);
 
 	if (rc > 0) {
-		strncpy(g_work_id, work.work_str, 21);
-		strncpy(g_work_nm, work.work_nm, 49);
-		ints2hex(work.pow_target, 4, g_pow_target_str, 33);
-		memcpy(g_pow_target, work.pow_target, 4 * sizeof(uint32_t));
-		memcpy(&g_work, &work, sizeof(struct work));
+		strncpy(g_work_id, work[0].work_str, 21);
+		strncpy(g_work_nm, work[0].work_nm, 49);
+		ints2hex(work[0].pow_target, 4, g_pow_target_str, 33);
+		memcpy(g_pow_target, work[0].pow_target, 4 * sizeof(uint32_t));
+		memcpy(&g_work, &work[0], sizeof(struct work));
 
 		// Reset POW Counter When Block Changes
 		//if (work.block_id != g_cur_block_id) {
@@ -1638,14 +1738,15 @@ static bool get_work(CURL *curl) {
 		//	applog(LOG_DEBUG, "New Block - now mining block: %llu", work.block_id);
 		//}
 
-		// Restart Miner Threads If Work Package Changes
-		if (work.work_id != g_cur_work_id) {
-			applog(LOG_NOTICE, "Switching to work_id: %s (target: %s)", work.work_str, g_pow_target_str);
-			restart_threads();
-		}
+		if (work[0].work_id != g_cur_work_id)
+			applog(LOG_NOTICE, "Switching to work_id: %s (target: %s)", work[0].work_str, g_pow_target_str);
+
+		// Hand Each Miner Thread Its Package
+		assign_threads(work, rc);
+		publish_work();
 
-		g_cur_work_id = work.work_id;
-		g_cur_block_id = work.block_id;
+		g_cur_work_id = work[0].work_id;
+		g_cur_block_id = work[0].block_id;
 	}
 	else {
 		g_cur_work_id = 0;
@@ -1654,11 +1755,14 @@ static bool get_work(CURL *curl) {
 		memset(&g_work, 0, sizeof(struct work));
 		g_work.package_id = -1;
 		g_work.iteration_id = -1;
-		restart_threads();
+		memset(g_thr_work, 0, opt_n_threads * sizeof(struct work));
+		publish_work();
 	}
 
 	pthread_mutex_unlock(&work_lock);
 
+	update_ignore_flags();
+
 	if (!rc)
 		return false;
 
@@ -1683,28 +1787,31 @@ static double calc_diff(uint32_t *target) {
 	return (double)(diff_1 / diff);
 }
 
-static int decode_work(CURL *curl, const json_t *val, struct work *work) {
-	int i, j, rc, num_pkg, best_pkg, bty_rcvd, work_pkg_id, iteration_id;
-	uint64_t work_id;
-	uint32_t storage_id, pow_tgt[4];
-	uint64_t best_wcet = 0xFFFFFFFF;
-	double difficulty, best_profit = 0, profit = 0;
-	char *tgt = NULL, *src = NULL, *str = NULL, *best_src = NULL, *best_tgt = NULL, *elastic_src = NULL;
-	json_t *wrk = NULL, *pkg = NULL;
-
-	memset(work, 0, sizeof(struct work));
-
-	if (opt_protocol) {
-		str = json_dumps(val, JSON_INDENT(3));
-		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
-		free(str);
-	}
-
-	wrk = json_object_get(val, "work_packages");
-
-	if (!wrk) {
-		applog(LOG_ERR, "Invalid JSON response to getMineableWork request");
-		return 0;
+// Ranks The Available Packages And Fills 'work' With The Best 'opt_portfolio' Of Them.
+// Returns The Number Of Packages Selected, -1 If None Are Available Or 0 On Error
+static int decode_work(CURL *curl, const struct mineable_work *mw, struct work *work) {
+	int i, j, rc, num_pkg, num_sel, num_building, num_storage, bty_rcvd, work_pkg_id, iteration_id;
+	int sel[MAX_PORTFOLIO];
+	uint64_t work_id, block_id;
+	uint32_t pow_tgt[4];
+	int storage_id;
+	bool new_block = false;
+	struct storage_buf *buf;
+	double difficulty, profit = 0;
+	const char *tgt = NULL, *str = NULL;
+	char **req = NULL;
+	json_t **rsp = NULL;
+	const struct mineable_pkg *pkg = NULL;
+
+	memset(work, 0, opt_portfolio * sizeof(struct work));
+
+	if (opt_protocol || opt_test_miner) {
+		for (i = 0; i < mw->num_pkg; i++) {
+			pkg = &mw->pkg[i];
+			applog(LOG_DEBUG, "DEBUG: Package - id: %s, block_id: %s, target: %s, iterations: %d/%d, bounties: %d/%u, rewards: %llu/%llu",
+				pkg->id, pkg->block_id, pkg->target, pkg->iterations_left, pkg->iterations, pkg->bty_rcvd, pkg->bounty_limit,
+				(unsigned long long)pkg->pow_reward, (unsigned long long)pkg->bty_reward);
+		}
 	}
 
 	// Set All Packages In Global List To Inactive
@@ -1712,24 +1819,59 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 		g_work_package[i].active = false;
 
 	// Check If Any Active Work Packages Are Available
-	num_pkg = json_array_size(wrk);
+	num_pkg = mw->num_pkg;
 	if (num_pkg == 0) {
 		applog(LOG_INFO, "No work available...retrying in %ds", opt_scantime);
 		return -1;
 	}
 
-	best_pkg = -1;
+	num_sel = 0;
+	num_building = 0;
+	num_storage = 0;
+
+	// Fetch The Source & Storage Of Every New Package At Once ('rsp[2i]' / 'rsp[2i+1]')
+	req = calloc(2 * num_pkg, sizeof(char *));
+	rsp = calloc(2 * num_pkg, sizeof(json_t *));
+	if (!req || !rsp) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for getWork requests");
+		num_sel = 0;
+		goto out;
+	}
+
+	for (i = 0; i < num_pkg; i++) {
+		str = mw->pkg[i].id;
+		if (!str[0])
+			continue;
+
+		// Retired Packages Only Need Their Source Again To Rebuild The Library
+		j = find_work_package(strtoull(str, NULL, 10));
+		if ((j >= 0) && !g_work_package[j].retired)
+			continue;
+
+		req[2 * i] = malloc(250);
+		if (j < 0)
+			req[(2 * i) + 1] = malloc(250);
+		if (!req[2 * i] || ((j < 0) && !req[(2 * i) + 1])) {
+			applog(LOG_ERR, "ERROR: Unable to allocate memory for getWork requests");
+			num_sel = 0;
+			goto out;
+		}
+		sprintf(req[2 * i], "requestType=getWork&work_id=%s&with_source=1&with_finished=0", str);
+		if (j < 0)
+			sprintf(req[(2 * i) + 1], "requestType=getWork&work_id=%s&with_source=false&with_finished=false&with_storage=true", str);
+	}
+
+	fetch_all(&g_fetch_multi, req, rsp, 2 * num_pkg);
 
 	for (i = 0; i<num_pkg; i++) {
-		pkg = json_array_get(wrk, i);
-		tgt = (char *)json_string_value(json_object_get(pkg, "target"));
-//		str = (char *)json_string_value(json_object_get(pkg, "work_id"));
-		str = (char *)json_string_value(json_object_get(pkg, "id"));
+		pkg = &mw->pkg[i];
+		tgt = pkg->target;
+		str = pkg->id;
 
 // TODO: Need To Add Current Iteration Number To Message
 
-		int iterations = (int)json_integer_value(json_object_get(pkg, "iterations"));
-		int iterations_left = (int)json_integer_value(json_object_get(pkg, "iterations_left"));
+		int iterations = pkg->iterations;
+		int iterations_left = pkg->iterations_left;
 		iteration_id = iterations - iterations_left;
 
 
@@ -1739,9 +1881,10 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 		// Temp Fix
 
 
-		if (!tgt || !str || (iteration_id < 0)) {
+		if (!tgt[0] || !str[0] || (iteration_id < 0)) {
 			applog(LOG_ERR, "Unable to parse work package");
-			return 0;
+			num_sel = 0;
+			goto out;
 		}
 		work_id = strtoull(str, NULL, 10);
 		applog(LOG_DEBUG, "DEBUG: Checking work_id: %s (iteration_id: %d)", str, iteration_id);
@@ -1754,6 +1897,16 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 
 				// Update Iteration ID
 				g_work_package[j].iteration_id = iteration_id;
+				g_work_package[j].node_storage_id = pkg->storage_id;
+
+				// POW Found On The Previous Block Is Dropped Below
+				block_id = strtoull(pkg->block_id, NULL, 10);
+				if (g_work_package[j].block_id != block_id) {
+					pthread_mutex_lock(&work_lock);
+					g_work_package[j].block_id = block_id;
+					pthread_mutex_unlock(&work_lock);
+					new_block = true;
+				}
 
 				// Set Status To Active
 				g_work_package[j].active = true;
@@ -1762,6 +1915,10 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 			}
 		}
 
+		// The Library Of A Returning Package Was Released - Rebuild It From The Prefetched Source
+		if ((work_pkg_id >= 0) && g_work_package[work_pkg_id].retired && !rebuild_library(work_pkg_id, rsp[2 * i]))
+			continue;
+
 		// Add New Work Packages
 		if (work_pkg_id < 0) {
 			struct work_package work_package;
@@ -1769,18 +1926,15 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 
 			work_package.work_id = work_id;
 			strncpy(work_package.work_str, str, 21);
-			str = (char *)json_string_value(json_object_get(pkg, "block_id"));
-			work_package.block_id = strtoull(str, NULL, 10);
-//			str = (char *)json_string_value(json_object_get(pkg, "title"));
-//			strncpy(work_package.work_nm, str, 49);
-			work_package.bounty_limit = (uint32_t)json_integer_value(json_object_get(pkg, "bounty_limit_per_iteration"));
-			work_package.bty_reward = (uint64_t)json_number_value(json_object_get(pkg, "xel_per_bounty"));
-			work_package.pow_reward = (uint64_t)json_number_value(json_object_get(pkg, "xel_per_pow"));
+			work_package.block_id = strtoull(pkg->block_id, NULL, 10);
+			work_package.bounty_limit = pkg->bounty_limit;
+			work_package.bty_reward = pkg->bty_reward;
+			work_package.pow_reward = pkg->pow_reward;
 			work_package.pending_bty_cnt = 0;
 			work_package.blacklisted = false;
 
-			// Get Source From Node
-			if (!get_work_source(curl, work_package.work_str, elastic_src)) {
+			// Parse The Prefetched Source
+			if (!decode_work_source(rsp[2 * i], work_package.work_str)) {
 				work_package.blacklisted = true;
 				applog(LOG_ERR, "ERROR: Unable to get 'source' for work_id: %s", work_package.work_str);
 				continue;
@@ -1803,21 +1957,26 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 			work_package.storage_id = 0;
 			work_package.storage_sz = ast_submit_sz;	// Currently, Storage Size = Submit Size
 			work_package.storage_idx = ast_submit_idx;	// Currently, Storage Index = Submti Index
-			work_package.storage = malloc(ast_submit_sz * sizeof(uint32_t));
+			work_package.storage = NULL;
+			work_package.storage_iter = -1;
+			work_package.node_storage_id = pkg->storage_id;
+			work_package.storage_pending = false;
 			work_package.iterations = iterations;
 			// Calculate WCET
 			work_package.WCET = calc_wcet();
 			if (!work_package.WCET) {
 				work_package.blacklisted = true;
 				applog(LOG_ERR, "ERROR: Unable to calculate WCET for work_id: %s", work_package.work_str);
-				return 0;
+				num_sel = 0;
+				goto out;
 			}
 
 			// Convert The ElasticPL Source Into A C Program
 			if (!convert_ast_to_c(work_package.work_str)) {
 				work_package.blacklisted = true;
 				applog(LOG_ERR, "ERROR: Unable to convert 'source' to C for work_id: %s", work_package.work_str);
-				return 0;
+				num_sel = 0;
+				goto out;
 			}
 
 			// Convert The ElasticPL Source Into A C Program Library
@@ -1825,14 +1984,22 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 				if (!create_opencl_source(NULL)) {
 					work_package.blacklisted = true;
 					applog(LOG_ERR, "ERROR: Unable to convert 'source' to OpenCL for work_id: %s", work_package.work_str);
-					return 0;
+					num_sel = 0;
+					goto out;
 				}
 			}
 			else {
-				if (!compile_library(work_package.work_str)) {
-					work_package.blacklisted = true;
-					applog(LOG_ERR, "ERROR: Unable to create C Library for work_id: %s\n\n%s\n", work_package.work_str, str);
-					return 0;
+				// Compiled On A Build Thread While The Remaining Packages Are Parsed
+				work_package.building = true;
+			}
+
+			// Use The Storage Prefetched With The Source (Otherwise It Is Fetched Once Selected)
+			if (work_package.storage_sz && rsp[(2 * i) + 1]) {
+				storage_id = decode_work_storage(rsp[(2 * i) + 1], work_id, work_package.work_str, work_package.storage_sz, &buf);
+				if (storage_id >= 0) {
+					work_package.storage = buf;
+					work_package.storage_id = storage_id;
+					work_package.storage_iter = iteration_id;
 				}
 			}
 
@@ -1842,6 +2009,14 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 			work_package.active = true;
 			add_work_package(&work_package);
 			work_pkg_id = g_work_package_cnt - 1;
+
+			if (work_package.building && !compile_library_async(work_package.work_str, library_built)) {
+				applog(LOG_ERR, "ERROR: Unable to create C Library for work_id: %s", work_package.work_str);
+				pthread_mutex_lock(&work_lock);
+				g_work_package[work_pkg_id].building = false;
+				g_work_package[work_pkg_id].blacklisted = true;
+				pthread_mutex_unlock(&work_lock);
+			}
 		}
 
 		// Check If Work Has Been Blacklisted
@@ -1850,8 +2025,23 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 			continue;
 		}
 
+		// Packages Join Once Their Library Is Built (See library_built)
+		if (g_work_package[work_pkg_id].building) {
+			applog(LOG_DEBUG, "DEBUG: Skipping work_id: %s - Library Still Building", g_work_package[work_pkg_id].work_str);
+			num_building++;
+			continue;
+		}
+
+		// Packages Whose Storage Couldn't Be Prefetched Join Once storage_thread Has It
+		if (g_work_package[work_pkg_id].storage_sz && (g_work_package[work_pkg_id].storage_iter < 0)) {
+			applog(LOG_DEBUG, "DEBUG: Skipping work_id: %s - Waiting For Storage", g_work_package[work_pkg_id].work_str);
+			queue_storage_fetch(&g_work_package[work_pkg_id]);
+			num_storage++;
+			continue;
+		}
+
 		// Check If Work Has Available Bounties
-		bty_rcvd = (int)json_integer_value(json_object_get(pkg, "received_bounties"));
+		bty_rcvd = pkg->bty_rcvd;
 		if (g_work_package[work_pkg_id].bounty_limit*g_work_package[work_pkg_id].iterations <= (bty_rcvd + g_work_package[work_pkg_id].pending_bty_cnt)) {
 			applog(LOG_DEBUG, "DEBUG: Skipping work_id: %s - No Bounties Left", g_work_package[work_pkg_id].work_str);
 			continue;
@@ -1861,222 +2051,850 @@ static int decode_work(CURL *curl, const json_t *val, struct work *work) {
 		rc = hex2ints(pow_tgt, 4, tgt, strlen(tgt));
 		if (!rc) {
 			applog(LOG_ERR, "Invalid Target in JSON response for work_id: %s", g_work_package[work_pkg_id].work_str);
-			return 0;
+			num_sel = 0;
+			goto out;
 		}
 
-		difficulty = calc_diff(pow_tgt);
-		profit = ((double)g_work_package[work_pkg_id].pow_reward / ((double)g_work_package[work_pkg_id].WCET * difficulty));
+		memcpy(g_work_package[work_pkg_id].pow_target, pow_tgt, 4 * sizeof(uint32_t));
 
-		// Select Best Work Package
-		if (opt_pref == PREF_WCET && (g_work_package[work_pkg_id].WCET < best_wcet)) {
-			best_pkg = work_pkg_id;
-			best_src = (char *)json_string_value(json_object_get(pkg, "source"));
-			best_tgt = tgt;
-			best_wcet = g_work_package[work_pkg_id].WCET;
+		// Nothing Left To Earn On This Package Until The Next Block
+		if (g_work_package[work_pkg_id].pow_capped && g_work_package[work_pkg_id].bty_capped) {
+			applog(LOG_DEBUG, "DEBUG: Skipping work_id: %s - Limits Reached For This Block", g_work_package[work_pkg_id].work_str);
+			continue;
 		}
 
+		difficulty = calc_diff(pow_tgt);
+		profit = ((double)g_work_package[work_pkg_id].pow_reward / ((double)g_work_package[work_pkg_id].WCET * difficulty));
+
 		//
 		// TODO:  Add Bounty Reward Profitability Check
 		//
 
-		else if ((opt_pref == PREF_PROFIT) && (profit > best_profit)) {
-			best_pkg = work_pkg_id;
-			best_src = (char *)json_string_value(json_object_get(pkg, "source"));
-			best_tgt = tgt;
-			best_profit = profit;
-		}
+		// Score The Package According To The Mining Preference
+		if (opt_pref == PREF_WCET)
+			g_work_package[work_pkg_id].score = 1.0 / (double)g_work_package[work_pkg_id].WCET;
+		else if ((opt_pref == PREF_PROFIT) && (profit > 0))
+			g_work_package[work_pkg_id].score = profit;
 		else if (opt_pref == PREF_WORKID && (!strcmp(g_work_package[work_pkg_id].work_str, pref_workid))) {
-			best_pkg = work_pkg_id;
-			best_src = (char *)json_string_value(json_object_get(pkg, "source"));
-			best_tgt = tgt;
+			g_work_package[work_pkg_id].score = 1.0;
+			sel[0] = work_pkg_id;
+			num_sel = 1;
 			break;
 		}
+		else
+			continue;
+
+		// Keep The Best 'opt_portfolio' Packages, Sorted Best First
+		for (j = num_sel; (j > 0) && better_package(work_pkg_id, sel[j - 1]); j--) {
+			if (j < opt_portfolio)
+				sel[j] = sel[j - 1];
+		}
+		if (j < opt_portfolio) {
+			sel[j] = work_pkg_id;
+			if (num_sel < opt_portfolio)
+				num_sel++;
+		}
+	}
+
+	// Queued POW Is Only Dropped Once The New Block Is Known, So None Found On It Is Lost
+	if (new_block)
+		submit_purge_pow();
+
+	// Release The Libraries Of Packages That Left getMineableWork (OpenCL Has No Per Package Library)
+	for (i = 0; !opt_opencl && (i < g_work_package_cnt); i++) {
+		if (g_work_package[i].active || g_work_package[i].retired || g_work_package[i].building || g_work_package[i].blacklisted)
+			continue;
+
+		pthread_mutex_lock(&work_lock);
+		g_work_package[i].retired = true;
+		pthread_mutex_unlock(&work_lock);
+
+		library_retire(g_work_package[i].work_str);
+	}
+
+	// Nothing Ready Yet - library_built() / storage_thread Trigger Another Pass When Done
+	if (!num_sel && (num_building || num_storage)) {
+		if (num_building)
+			applog(LOG_INFO, "Waiting for %d job %s to compile", num_building, (num_building == 1) ? "library" : "libraries");
+		if (num_storage)
+			applog(LOG_INFO, "Waiting for storage of %d work %s", num_storage, (num_storage == 1) ? "package" : "packages");
+		num_sel = -1;
+		goto out;
 	}
 
 	// If No Work Matched Current Preference Switch To Profit Mode
-	if (best_pkg < 0) {
+	if (!num_sel) {
 		opt_pref = PREF_PROFIT;
 		applog(LOG_INFO, "No work available that matches preference...retrying in %ds", opt_scantime);
-		return -1;
+		num_sel = -1;
+		goto out;
 	}
 
-	// Get Updated Storage Data
-	if (g_work_package[best_pkg].storage_sz && ((g_work.package_id != best_pkg) || (g_work.iteration_id != g_work_package[best_pkg].iteration_id))) {
+	// Storage For A New Iteration Is Fetched & Decoded In The Background (See storage_thread).
+	// Until It Is Ready, The Package Is Mined On The Iteration Its Current Storage Belongs To (See match_storage)
+	for (i = 0; i < num_sel; i++) {
+		struct work_package *wp = &g_work_package[sel[i]];
+
+		if (wp->storage_sz && (wp->storage_iter != (int)wp->iteration_id))
+			queue_storage_fetch(wp);
+
+		// Copy Work Package Details To Work
+		pthread_mutex_lock(&work_lock);
+		work[i].package_id = sel[i];
+		work[i].block_id = wp->block_id;
+		work[i].work_id = wp->work_id;
+		work[i].iteration_id = wp->iteration_id;
+		strncpy(work[i].work_str, wp->work_str, 21);
+		strncpy(work[i].work_nm, wp->work_nm, 49);
+		memcpy(work[i].pow_target, wp->pow_target, 4 * sizeof(uint32_t));
+		pthread_mutex_unlock(&work_lock);
+	}
 
-		// Allocate Memory For Storage
-		if (!g_work_package[best_pkg].storage) {
-			g_work_package[best_pkg].storage = malloc(g_work_package[best_pkg].storage_sz * sizeof(uint32_t));
-			if (!g_work_package[best_pkg].storage) {
-				applog(LOG_ERR, "Unable to allocate storage for work_id: %s", g_work_package[best_pkg].work_str);
-				return 0;
-			}
-		}
+out:
+	if (req && rsp)
+		clear_fetch(req, rsp, 2 * num_pkg);
+	free(req);
+	free(rsp);
 
-		// Get Storage Values From Node
-		storage_id = get_work_storage(curl, g_work_package[best_pkg].work_str, g_work_package[best_pkg].storage);
-		if (storage_id < 0) {
-			applog(LOG_ERR, "ERROR: Unable to get 'storage' for work_id: %s", g_work_package[best_pkg].work_str);
-			return 0;
-		}else{
-			applog(LOG_DEBUG, "First storage int for work_id %s is %u", g_work_package[best_pkg].work_str, g_work_package[best_pkg].storage[0]);
-		}
+	return num_sel;
+}
+
+// Frees The Requests & Responses Of fetch_all()
+static void clear_fetch(char **req, json_t **rsp, int cnt) {
+	int i;
 
-		g_work_package[best_pkg].storage_id = storage_id;
+	for (i = 0; i < cnt; i++) {
+		free(req[i]);
+		if (rsp[i])
+			json_decref(rsp[i]);
+		req[i] = NULL;
+		rsp[i] = NULL;
 	}
+}
 
-	// Copy Work Package Details To Work
-	work->package_id = best_pkg;
-	work->block_id = g_work_package[best_pkg].block_id;
-	work->work_id = g_work_package[best_pkg].work_id;
-	strncpy(work->work_str, g_work_package[best_pkg].work_str, 21);
-	strncpy(work->work_nm, g_work_package[best_pkg].work_nm, 49);
+// Called On A Build Thread Once A New Package's Library Is Ready (Or Failed To Build)
+static void library_built(char *work_str, bool rc) {
+	int idx;
 
-	// Convert Hex Target To Int Array
-	rc = hex2ints(work->pow_target, 4, tgt, strlen(tgt));
-	if (!rc) {
-		applog(LOG_ERR, "Invalid Target in JSON response for work_id: %s", work->work_str);
-		return 0;
+	pthread_mutex_lock(&work_lock);
+	idx = find_work_package(strtoull(work_str, NULL, 10));
+	if (idx >= 0) {
+		g_work_package[idx].building = false;
+		if (!rc)
+			g_work_package[idx].blacklisted = true;
 	}
+	pthread_mutex_unlock(&work_lock);
 
-	return 1;
+	if (rc)
+		applog(LOG_DEBUG, "DEBUG: Library ready for work_id: %s", work_str);
+	else
+		applog(LOG_ERR, "ERROR: Unable to create C Library for work_id: %s", work_str);
+
+	// Rank The Package Against The Others Right Away
+	g_rebalance = true;
+	tq_wake(thr_info[work_thr_id].q);
 }
 
-static bool get_work_source(CURL *curl, char *work_str, char *elastic_src) {
-	int err, rc;
-	char req[100], *str = NULL;
-	size_t num_pkg;
-	json_t *val, *wrk, *pkg;
-	struct timeval tv_start, tv_end, diff;
+// Rebuilds The Library Of A Package That Returned After Being Retired
+static bool rebuild_library(int idx, json_t *val) {
+	char *work_str = g_work_package[idx].work_str;
 
-	sprintf(req, "requestType=getWork&work_id=%s&with_source=1&with_finished=0", work_str);
+	applog(LOG_DEBUG, "DEBUG: Rebuilding library for work_id: %s", work_str);
 
-	gettimeofday(&tv_start, NULL);
-	val = json_rpc_call(curl, rpc_url, rpc_userpass, req, &err);
-	if (!val) {
-		applog(LOG_ERR, "ERROR: 'json_rpc_call' for 'source' failed...retrying in %d seconds", opt_fail_pause);
-		sleep(opt_fail_pause);
+	if (!decode_work_source(val, work_str) || !convert_ast_to_c(work_str)) {
+		applog(LOG_ERR, "ERROR: Unable to rebuild C Library for work_id: %s", work_str);
+		pthread_mutex_lock(&work_lock);
+		g_work_package[idx].blacklisted = true;
+		pthread_mutex_unlock(&work_lock);
 		return false;
 	}
 
-	gettimeofday(&tv_end, NULL);
-	if (opt_protocol) {
-		timeval_subtract(&diff, &tv_end, &tv_start);
-		applog(LOG_DEBUG, "DEBUG: Time to get source: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
-	}
+	pthread_mutex_lock(&work_lock);
+	g_work_package[idx].retired = false;
+	g_work_package[idx].building = true;
+	pthread_mutex_unlock(&work_lock);
 
-	if (opt_protocol) {
-		str = json_dumps(val, JSON_INDENT(3));
-		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
-		free(str);
+	if (!compile_library_async(work_str, library_built)) {
+		applog(LOG_ERR, "ERROR: Unable to create C Library for work_id: %s", work_str);
+		pthread_mutex_lock(&work_lock);
+		g_work_package[idx].building = false;
+		g_work_package[idx].blacklisted = true;
+		pthread_mutex_unlock(&work_lock);
+		return false;
 	}
 
-	wrk = json_object_get(val, "work_packages");
+	return true;
+}
 
-	if (!wrk) {
-		applog(LOG_ERR, "Invalid JSON response to getWork request");
-		return 0;
+// Queues A Background Fetch Of The Storage For The Package's Current Iteration.  When
+// getMineableWork Lists A storage_id That Is Already Cached, It Is Swapped In Right Away
+static bool queue_storage_fetch(struct work_package *wp) {
+	struct storage_job *job;
+	struct storage_buf *buf;
+	pthread_t thr;
+
+	if (!g_storage_q) {
+		g_storage_q = tq_new();
+		if (!g_storage_q || pthread_create(&thr, NULL, storage_thread, NULL)) {
+			applog(LOG_ERR, "ERROR: Unable to start storage thread");
+			if (g_storage_q)
+				tq_free(g_storage_q);
+			g_storage_q = NULL;
+			return false;
+		}
 	}
 
-	// Check If Any Active Work Packages Are Available
-	num_pkg = json_array_size(wrk);
-	if (num_pkg != 1) {
-		applog(LOG_INFO, "Unable to retrieve source for work_id %s", work_str);
-		return false;
+	pthread_mutex_lock(&work_lock);
+	if (wp->storage_pending) {
+		pthread_mutex_unlock(&work_lock);
+		return true;
 	}
 
-	pkg = json_array_get(wrk, 0);
-
-	// Get Encrypted Source From JSON Message
-	str = (char *)json_string_value(json_object_get(pkg, "source_code"));
-
-	// Extract The ElasticPL Source Code
-	if (!str || strlen(str) > MAX_SOURCE_SIZE || strlen(str) == 0) {
-		applog(LOG_ERR, "ERROR: Invalid 'source' for work_id: %s", work_str);
-		return false;
+	if (wp->node_storage_id >= 0) {
+		buf = storage_cache_get(wp->work_id, (uint32_t)wp->node_storage_id);
+		if (buf) {
+			storage_release(wp->storage);
+			wp->storage = buf;
+			wp->storage_id = (uint32_t)wp->node_storage_id;
+			wp->storage_iter = (int)wp->iteration_id;
+			pthread_mutex_unlock(&work_lock);
+			applog(LOG_DEBUG, "DEBUG: Reusing cached storage %d for work_id: %s", wp->node_storage_id, wp->work_str);
+			return true;
+		}
 	}
 
-	elastic_src = malloc(MAX_SOURCE_SIZE);
-	if (!elastic_src) {
-		applog(LOG_ERR, "ERROR: Unable to allocate memory for ElasticPL Source");
+	job = calloc(1, sizeof(struct storage_job));
+	if (!job) {
+		pthread_mutex_unlock(&work_lock);
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for storage request");
 		return false;
 	}
+	job->work_id = wp->work_id;
+	strncpy(job->work_str, wp->work_str, 21);
+	job->storage_sz = wp->storage_sz;
+	job->iteration_id = (int)wp->iteration_id;
 
-	rc = ascii85dec(elastic_src, MAX_SOURCE_SIZE, str);
-	if (!rc) {
-		applog(LOG_ERR, "ERROR: Unable to decode 'source' for work_id: %s\n\n%s\n", work_str, str);
-		free(elastic_src);
+	wp->storage_pending = tq_push(g_storage_q, job);
+	pthread_mutex_unlock(&work_lock);
+
+	if (!wp->storage_pending) {
+		free(job);
 		return false;
 	}
 
-	applog(LOG_DEBUG, "DEBUG: Running ElasticPL Parser");
+	return true;
+}
 
-	if (opt_debug_epl)
-		applog(LOG_DEBUG, "DEBUG: ElasticPL Source Code -\n%s", elastic_src);
+// Fetches & Decodes Storage For New Iterations Off The workio Thread, So Miner Threads Keep
+// Running On The Previous Iteration Until The New Storage Is Ready
+static void *storage_thread(void *userdata) {
+	struct storage_job *job[MAX_PORTFOLIO];
+	struct storage_buf *buf;
+	char *req[MAX_PORTFOLIO];
+	json_t *rsp[MAX_PORTFOLIO];
+	int i, idx, cnt, storage_id;
+	bool ready;
 
-	// Convert ElasticPL Into AST
-	if (!create_epl_ast(elastic_src)) {
-		applog(LOG_ERR, "ERROR: Unable to convert 'source' to AST for work_id: %s\n\n%s\n", work_str, str);
-		free(elastic_src);
-		return false;
-	}
+	pthread_detach(pthread_self());
 
-	gettimeofday(&tv_start, NULL);
-	if (opt_protocol) {
-		timeval_subtract(&diff, &tv_start, &tv_end);
-		applog(LOG_DEBUG, "DEBUG: Time to parse source: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
-	}
+	while (1) {
+		job[0] = (struct storage_job *)tq_pop(g_storage_q, NULL);
+		if (!job[0])
+			continue;
 
-	free(elastic_src);
-	json_decref(val);
+		// Fetch Everything Queued Meanwhile At Once
+		cnt = 1;
+		while ((cnt < MAX_PORTFOLIO) && (job[cnt] = (struct storage_job *)tq_pop_nowait(g_storage_q)))
+			cnt++;
 
-	return true;
-}
+		for (i = 0; i < cnt; i++) {
+			req[i] = malloc(250);
+			if (req[i])
+				sprintf(req[i], "requestType=getWork&work_id=%s&with_source=false&with_finished=false&with_storage=true", job[i]->work_str);
+		}
 
-static int get_work_storage(CURL *curl, char *work_str, uint32_t *storage) {
-	int err;
-	uint32_t storage_id, iteration_id;
-	size_t num_pkg, max_str_len;
-	char req[250], *str = NULL;
-	json_t *val, *wrk, *pkg;
-	struct timeval tv_start, tv_end, diff;
+		fetch_all(&g_storage_multi, req, rsp, cnt);
+
+		ready = false;
+		for (i = 0; i < cnt; i++) {
+			storage_id = decode_work_storage(rsp[i], job[i]->work_id, job[i]->work_str, job[i]->storage_sz, &buf);
+			if (storage_id < 0)
+				applog(LOG_ERR, "ERROR: Unable to get 'storage' for work_id: %s", job[i]->work_str);
+
+			// Failed Fetches Are Retried On The Next Scan
+			pthread_mutex_lock(&work_lock);
+			idx = find_work_package(job[i]->work_id);
+			if (idx >= 0) {
+				g_work_package[idx].storage_pending = false;
+				if (buf) {
+					storage_release(g_work_package[idx].storage);
+					g_work_package[idx].storage = buf;
+					g_work_package[idx].storage_id = storage_id;
+					g_work_package[idx].storage_iter = job[i]->iteration_id;
+					buf = NULL;
+					ready = true;
+				}
+			}
+			pthread_mutex_unlock(&work_lock);
 
-	sprintf(req, "requestType=getWork&work_id=%s&with_source=false&with_finished=false&with_storage=true", work_str);
+			storage_release(buf);
+			free(job[i]);
+		}
 
-	gettimeofday(&tv_start, NULL);
-	val = json_rpc_call(curl, rpc_url, rpc_userpass, req, &err);
-	if (!val) {
-		applog(LOG_ERR, "ERROR: 'json_rpc_call' for 'storage' failed...retrying in %d seconds", opt_fail_pause);
-		sleep(opt_fail_pause);
-		return -1;
-	}
+		clear_fetch(req, rsp, cnt);
 
-	gettimeofday(&tv_end, NULL);
-	if (opt_protocol) {
-		timeval_subtract(&diff, &tv_end, &tv_start);
-		applog(LOG_DEBUG, "DEBUG: Time to get storage: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+		// Move The Threads To The New Iteration
+		if (ready) {
+			g_rebalance = true;
+			tq_wake(thr_info[work_thr_id].q);
+		}
 	}
 
-	if (opt_protocol) {
-		str = json_dumps(val, JSON_INDENT(3));
-		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
-		free(str);
-	}
+	return NULL;
+}
 
-	wrk = json_object_get(val, "work_packages");
+// Packages That Still Accept POW Rank Ahead Of Capped Ones, Then By Score
+static bool better_package(int a, int b) {
+	if (g_work_package[a].pow_capped != g_work_package[b].pow_capped)
+		return !g_work_package[a].pow_capped;
 
-	if (!wrk) {
-		applog(LOG_ERR, "Invalid JSON response to getWork request");
-		return 0;
+	return g_work_package[a].score > g_work_package[b].score;
+}
+
+// Splits The Miner Threads Across The Selected Packages In Proportion To Their Score.
+// Threads Stay On Their Current Package Where Possible, So Only The Difference Switches
+static void assign_threads(struct work *work, int cnt) {
+	int i, j, n, left, extra, want[MAX_PORTFOLIO];
+	double weight[MAX_PORTFOLIO], total = 0;
+	bool *done, changed = false;
+
+	// Capped Packages Only Earn Bounties, So They Get No Share Beyond Their First Thread
+	for (j = 0; j < cnt; j++) {
+		weight[j] = g_work_package[work[j].package_id].pow_capped ? 0.0 : g_work_package[work[j].package_id].score;
+		total += weight[j];
 	}
 
-	// Check If Any Active Work Packages Are Available
-	num_pkg = json_array_size(wrk);
-	if (num_pkg != 1) {
-		applog(LOG_INFO, "Unable to retrieve storage for work_id %s", work_str);
-		return false;
+	// Every Package Gets One Thread (While They Last), The Rest Are Split By Weight
+	n = (cnt < opt_n_threads) ? cnt : opt_n_threads;
+	left = opt_n_threads - n;
+	for (j = 0; j < cnt; j++)
+		want[j] = (j < n) ? 1 : 0;
+
+	for (j = 0; j < n; j++) {
+		extra = (total > 0) ? (int)(left * weight[j] / total) : (left / n);
+		want[j] += extra;
+		left -= extra;
 	}
+	for (j = 0; left > 0; j = (j + 1) % n, left--)
+		want[j]++;
 
-	pkg = json_array_get(wrk, 0);
+	done = calloc(opt_n_threads, sizeof(bool));
+	if (!done) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for thread assignment");
+		return;
+	}
+
+	// Keep Threads On Packages That Still Want Them (Picks Up New Target / Iteration)
+	for (i = 0; i < opt_n_threads; i++) {
+		for (j = 0; j < cnt; j++) {
+			if (want[j] && (g_thr_work[i].work_id == work[j].work_id)) {
+				memcpy(&g_thr_work[i], &work[j], sizeof(struct work));
+				g_thr_work[i].thr_id = i;
+				want[j]--;
+				done[i] = true;
+				break;
+			}
+		}
+	}
+
+	// Move The Remaining Threads To Packages That Are Short
+	for (i = 0, j = 0; i < opt_n_threads; i++) {
+		if (done[i])
+			continue;
+		while ((j < cnt) && !want[j])
+			j++;
+		if (j == cnt)
+			break;
+		memcpy(&g_thr_work[i], &work[j], sizeof(struct work));
+		g_thr_work[i].thr_id = i;
+		want[j]--;
+		changed = true;
+	}
+
+	free(done);
+
+	if (changed && (opt_portfolio > 1)) {
+		for (j = 0; j < cnt; j++) {
+			for (i = 0, n = 0; i < opt_n_threads; i++)
+				n += (g_thr_work[i].work_id == work[j].work_id);
+			applog(LOG_NOTICE, "Portfolio: work_id %s - %d thread%s (score: %.3g%s)", work[j].work_str, n, (n == 1) ? "" : "s", g_work_package[work[j].package_id].score, g_work_package[work[j].package_id].pow_capped ? ", POW capped" : "");
+		}
+	}
+}
+
+// Posts A Snapshot Of Each Thread's Assigned Work To Its Mailbox (Caller Holds work_lock).
+// Threads Take It Without Locking; A Snapshot Not Yet Taken Is Simply Replaced
+static void publish_work(void) {
+	struct work_snapshot *snap[MAX_PORTFOLIO], *old;
+	int i, j, cnt = 0;
+
+	// Worker Processes Pick Their Work Up From The Shared Board Instead
+	if (opt_supervise) {
+		supervise_publish(g_thr_work);
+		return;
+	}
+
+	for (i = 0; i < opt_n_threads; i++) {
+
+		// Threads On The Same Package Share One Snapshot
+		for (j = 0; j < cnt; j++) {
+			if (snap[j]->work.work_id == g_thr_work[i].work_id)
+				break;
+		}
+		if (j == cnt) {
+			if ((cnt == MAX_PORTFOLIO) || !(snap[cnt] = snapshot_create(&g_thr_work[i]))) {
+				applog(LOG_ERR, "ERROR: Unable to allocate work snapshot");
+				break;
+			}
+			cnt++;
+		}
+
+		ATOMIC_INC(&snap[j]->refcnt);
+		old = ATOMIC_XCHG_PTR(&work_restart[i].snap, snap[j]);
+		snapshot_release(old);
+
+		// Stop The Current Scan So The Thread Picks Up The New Target / Work Right Away
+		work_restart[i].restart = 1;
+	}
+
+	// Drop The Publisher's References
+	for (j = 0; j < cnt; j++)
+		snapshot_release(snap[j]);
+
+	unpark_threads();
+}
+
+static struct work_snapshot *snapshot_create(struct work *work) {
+	struct work_snapshot *snap;
+
+	snap = calloc(1, sizeof(struct work_snapshot));
+	if (!snap)
+		return NULL;
+
+	memcpy(&snap->work, work, sizeof(struct work));
+	if (work->work_id) {
+		memcpy(&snap->pkg, &g_work_package[work->package_id], sizeof(struct work_package));
+		match_storage(&snap->work, &snap->pkg);
+		if (snap->pkg.storage)
+			ATOMIC_INC(&snap->pkg.storage->refcnt);
+
+		// Threads Holding The Snapshot May Still Load The Library
+		library_pin(snap->pkg.work_str, true);
+	}
+	snap->refcnt = 1;
+
+	return snap;
+}
+
+static void snapshot_release(struct work_snapshot *snap) {
+	if (snap && (ATOMIC_DEC(&snap->refcnt) == 0)) {
+		storage_release(snap->pkg.storage);
+		if (snap->work.work_id)
+			library_pin(snap->pkg.work_str, false);
+		free(snap);
+	}
+}
+
+static struct storage_buf *storage_create(uint32_t storage_sz) {
+	struct storage_buf *buf;
+
+	buf = malloc(sizeof(struct storage_buf) + storage_sz * sizeof(uint32_t));
+	if (!buf)
+		return NULL;
+
+	buf->data = (uint32_t *)(buf + 1);
+	buf->refcnt = 1;
+
+	return buf;
+}
+
+static void storage_release(struct storage_buf *buf) {
+	if (buf && (ATOMIC_DEC(&buf->refcnt) == 0))
+		free(buf);
+}
+
+// Points A Published Copy Of A Package At The Iteration Its Storage Belongs To, As Storage
+// For A Newer Iteration May Still Be Loading On storage_thread
+extern void match_storage(struct work *work, struct work_package *pkg) {
+	if (pkg->storage_sz && (pkg->storage_iter >= 0))
+		pkg->iteration_id = (uint32_t)pkg->storage_iter;
+
+	work->iteration_id = pkg->iteration_id;
+	work->storage_id = (pkg->storage_id < 0xFFFF) ? pkg->storage_id : 0;
+}
+
+// Returns A Reference To The Cached Storage Of (work_id, storage_id), Or NULL
+static struct storage_buf *storage_cache_get(uint64_t work_id, uint32_t storage_id) {
+	struct storage_buf *buf = NULL;
+	int i;
+
+	pthread_mutex_lock(&storage_lock);
+	for (i = 0; i < STORAGE_CACHE_SZ; i++) {
+		if (g_storage_cache[i].buf && (g_storage_cache[i].work_id == work_id) && (g_storage_cache[i].storage_id == storage_id)) {
+			buf = g_storage_cache[i].buf;
+			ATOMIC_INC(&buf->refcnt);
+			g_storage_cache[i].last_use = ++g_storage_tick;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&storage_lock);
+
+	return buf;
+}
+
+// Caches Decoded Storage, Replacing The Least Recently Used Entry When Full
+static void storage_cache_put(uint64_t work_id, uint32_t storage_id, struct storage_buf *buf) {
+	int i, slot = 0;
+
+	pthread_mutex_lock(&storage_lock);
+	for (i = 0; i < STORAGE_CACHE_SZ; i++) {
+		if (!g_storage_cache[i].buf || ((g_storage_cache[i].work_id == work_id) && (g_storage_cache[i].storage_id == storage_id))) {
+			slot = i;
+			break;
+		}
+		if (g_storage_cache[i].last_use < g_storage_cache[slot].last_use)
+			slot = i;
+	}
+
+	storage_release(g_storage_cache[slot].buf);
+	ATOMIC_INC(&buf->refcnt);
+	g_storage_cache[slot].work_id = work_id;
+	g_storage_cache[slot].storage_id = storage_id;
+	g_storage_cache[slot].buf = buf;
+	g_storage_cache[slot].last_use = ++g_storage_tick;
+	pthread_mutex_unlock(&storage_lock);
+}
+
+// Returns The Newest Snapshot Posted For The Thread (Now Owned By The Caller), Or NULL
+static struct work_snapshot *snapshot_take(int thr_id) {
+	if (!ATOMIC_LOAD(&work_restart[thr_id].snap))
+		return NULL;
+
+	return ATOMIC_XCHG_PTR(&work_restart[thr_id].snap, NULL);
+}
+
+// The Global Ignore Flags Are Only Raised Once Every Package Being Mined Is Capped
+static void update_ignore_flags(void) {
+	bool pow = true, bty = true, any = false;
+	int i;
+
+	pthread_mutex_lock(&work_lock);
+	for (i = 0; i < opt_n_threads; i++) {
+		if (!g_thr_work[i].work_id)
+			continue;
+		pow &= g_work_package[g_thr_work[i].package_id].pow_capped;
+		bty &= g_work_package[g_thr_work[i].package_id].bty_capped;
+		any = true;
+	}
+	pthread_mutex_unlock(&work_lock);
+
+	if (!any)
+		pow = bty = false;
+
+	if (opt_supervise)
+		supervise_set_ignore(pow, bty);
+	else
+		set_ignore_flags(pow, bty);
+}
+
+extern void set_ignore_flags(bool pow, bool bty) {
+	ATOMIC_STORE(&g_pow_ignore, pow);
+	ATOMIC_STORE(&g_bounty_ignore, bty);
+
+	if (!pow || !bty)
+		unpark_threads();
+}
+
+// Worker Process Side Of publish_work() - 'storage' Is The Worker's Own Copy From The Board
+extern void deliver_work(int thr_id, struct work *work, struct work_package *pkg, uint32_t *storage) {
+	struct work_snapshot *snap, *old;
+
+	snap = calloc(1, sizeof(struct work_snapshot));
+	if (!snap) {
+		applog(LOG_ERR, "ERROR: Unable to allocate work snapshot");
+		return;
+	}
+
+	memcpy(&snap->work, work, sizeof(struct work));
+	memcpy(&snap->pkg, pkg, sizeof(struct work_package));
+	snap->pkg.storage = NULL;
+	if (work->work_id && pkg->storage_sz) {
+		snap->pkg.storage = storage_create(pkg->storage_sz);
+		if (!snap->pkg.storage) {
+			applog(LOG_ERR, "ERROR: Unable to allocate work snapshot");
+			free(snap);
+			return;
+		}
+		memcpy(snap->pkg.storage->data, storage, pkg->storage_sz * sizeof(uint32_t));
+	}
+	snap->refcnt = 1;
+
+	old = ATOMIC_XCHG_PTR(&work_restart[thr_id].snap, snap);
+	snapshot_release(old);
+	work_restart[thr_id].restart = 1;
+
+	unpark_threads();
+}
+
+// Called By The Supervisor When A Package Keeps Crashing Its Worker Processes
+extern void blacklist_package(uint64_t work_id) {
+	int idx;
+
+	pthread_mutex_lock(&work_lock);
+	idx = find_work_package(work_id);
+	if (idx >= 0)
+		g_work_package[idx].blacklisted = true;
+	pthread_mutex_unlock(&work_lock);
+
+	g_rebalance = true;
+	tq_wake(thr_info[work_thr_id].q);
+}
+
+// Blocks An Idle Miner Thread Until unpark_threads() Is Called After 'gen' Was Read
+static void park_thread(uint32_t gen) {
+	pthread_mutex_lock(&park_lock);
+	while (g_park_gen == gen)
+		pthread_cond_wait(&park_cond, &park_lock);
+	pthread_mutex_unlock(&park_lock);
+}
+
+static void unpark_threads(void) {
+	pthread_mutex_lock(&park_lock);
+	g_park_gen++;
+	pthread_cond_broadcast(&park_cond);
+	pthread_mutex_unlock(&park_lock);
+}
+
+// Clears The Per Package POW / Bounty Limits When A New Block Arrives
+static void reset_package_limits(void) {
+	int i;
+
+	for (i = 0; i < g_work_package_cnt; i++) {
+		g_work_package[i].pow_cnt = 0;
+		g_work_package[i].pow_capped = false;
+		g_work_package[i].bty_capped = false;
+	}
+}
+
+static int find_work_package(uint64_t work_id) {
+	int i;
+
+	for (i = 0; i < g_work_package_cnt; i++) {
+		if (g_work_package[i].work_id == work_id)
+			return i;
+	}
+
+	return -1;
+}
+
+// Issues The getWork Requests In 'req' (NULL Entries Are Skipped) Concurrently Over The
+// Calling Thread's 'multi' Handle & Stores Each Response In 'val' (NULL On Failure)
+static void fetch_all(CURLM **multi, char **req, json_t **val, int cnt) {
+	struct fetch_xfer {
+		CURL *curl;
+		struct data_buffer db;
+		char err_str[CURL_ERROR_SIZE];
+	} *xfer, *done;
+	struct timeval tv_start, tv_end, diff;
+	CURLMsg *msg;
+	int i, err, running, pending, num_req = 0;
+
+	memset(val, 0, cnt * sizeof(json_t *));
+
+	xfer = calloc(cnt, sizeof(struct fetch_xfer));
+	if (!xfer) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for getWork requests");
+		return;
+	}
+
+	if (!*multi) {
+		*multi = curl_multi_init();
+		if (!*multi) {
+			applog(LOG_ERR, "CURL initialization failed");
+			free(xfer);
+			return;
+		}
+		curl_multi_setopt(*multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)MAX_FETCH_CONNS);
+	}
+
+	gettimeofday(&tv_start, NULL);
+
+	for (i = 0; i < cnt; i++) {
+		if (!req[i])
+			continue;
+
+		xfer[i].curl = curl_easy_init();
+		if (!xfer[i].curl) {
+			applog(LOG_ERR, "CURL initialization failed");
+			continue;
+		}
+
+		json_rpc_prepare(xfer[i].curl, rpc_url, rpc_userpass, req[i], &xfer[i].db, xfer[i].err_str);
+		curl_easy_setopt(xfer[i].curl, CURLOPT_PRIVATE, &xfer[i]);
+		curl_multi_add_handle(*multi, xfer[i].curl);
+		num_req++;
+	}
+
+	do {
+		curl_multi_perform(*multi, &running);
+
+		while ((msg = curl_multi_info_read(*multi, &pending))) {
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+
+			curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&done);
+			val[done - xfer] = json_rpc_result(msg->data.result, &done->db, done->err_str, &err);
+			curl_multi_remove_handle(*multi, done->curl);
+		}
+
+		if (running)
+			curl_multi_poll(*multi, NULL, 0, 1000, NULL);
+	} while (running);
+
+	gettimeofday(&tv_end, NULL);
+	if (opt_protocol && num_req) {
+		timeval_subtract(&diff, &tv_end, &tv_start);
+		applog(LOG_DEBUG, "DEBUG: Time to get %d sources / storage: %.2f ms", num_req, (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+	}
+
+	for (i = 0; i < cnt; i++) {
+		if (xfer[i].curl)
+			curl_easy_cleanup(xfer[i].curl);
+	}
+	free(xfer);
+}
+
+// Parses The Source In A getWork Response Into The AST
+static bool decode_work_source(json_t *val, char *work_str) {
+	int rc;
+	char *str = NULL, *elastic_src = NULL;
+	size_t num_pkg;
+	json_t *wrk, *pkg;
+	struct timeval tv_start, tv_end, diff;
+
+	if (!val) {
+		applog(LOG_ERR, "ERROR: 'json_rpc_call' for 'source' failed");
+		return false;
+	}
+
+	gettimeofday(&tv_end, NULL);
+
+	if (opt_protocol) {
+		str = json_dumps(val, JSON_INDENT(3));
+		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
+		free(str);
+	}
+
+	wrk = json_object_get(val, "work_packages");
+
+	if (!wrk) {
+		applog(LOG_ERR, "Invalid JSON response to getWork request");
+		return 0;
+	}
+
+	// Check If Any Active Work Packages Are Available
+	num_pkg = json_array_size(wrk);
+	if (num_pkg != 1) {
+		applog(LOG_INFO, "Unable to retrieve source for work_id %s", work_str);
+		return false;
+	}
+
+	pkg = json_array_get(wrk, 0);
+
+	// Get Encrypted Source From JSON Message
+	str = (char *)json_string_value(json_object_get(pkg, "source_code"));
+
+	// Extract The ElasticPL Source Code
+	if (!str || strlen(str) > MAX_SOURCE_SIZE || strlen(str) == 0) {
+		applog(LOG_ERR, "ERROR: Invalid 'source' for work_id: %s", work_str);
+		return false;
+	}
+
+	elastic_src = malloc(MAX_SOURCE_SIZE);
+	if (!elastic_src) {
+		applog(LOG_ERR, "ERROR: Unable to allocate memory for ElasticPL Source");
+		return false;
+	}
+
+	rc = ascii85dec(elastic_src, MAX_SOURCE_SIZE, str);
+	if (!rc) {
+		applog(LOG_ERR, "ERROR: Unable to decode 'source' for work_id: %s\n\n%s\n", work_str, str);
+		free(elastic_src);
+		return false;
+	}
+
+	applog(LOG_DEBUG, "DEBUG: Running ElasticPL Parser");
+
+	if (opt_debug_epl)
+		applog(LOG_DEBUG, "DEBUG: ElasticPL Source Code -\n%s", elastic_src);
+
+	// Convert ElasticPL Into AST
+	if (!create_epl_ast(elastic_src)) {
+		applog(LOG_ERR, "ERROR: Unable to convert 'source' to AST for work_id: %s\n\n%s\n", work_str, str);
+		free(elastic_src);
+		return false;
+	}
+
+	gettimeofday(&tv_start, NULL);
+	if (opt_protocol) {
+		timeval_subtract(&diff, &tv_start, &tv_end);
+		applog(LOG_DEBUG, "DEBUG: Time to parse source: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+	}
+
+	free(elastic_src);
+
+	return true;
+}
+
+// Converts The Storage In A getWork Response Into '*buf' (The Cached Copy If This storage_id Was Seen Before).
+// Returns Its storage_id, 0xFFFF If There Is None Yet (All Zeros) Or -1 On Error
+static int decode_work_storage(json_t *val, uint64_t work_id, char *work_str, uint32_t storage_sz, struct storage_buf **buf) {
+	uint32_t storage_id, iteration_id;
+	size_t num_pkg;
+	char *str = NULL;
+	json_t *wrk, *pkg;
+	struct timeval tv_start, tv_end, diff;
+
+	*buf = NULL;
+
+	if (!val) {
+		applog(LOG_ERR, "ERROR: 'json_rpc_call' for 'storage' failed");
+		return -1;
+	}
+
+	gettimeofday(&tv_end, NULL);
+
+	if (opt_protocol) {
+		str = json_dumps(val, JSON_INDENT(3));
+		applog(LOG_DEBUG, "DEBUG: JSON Response -\n%s", str);
+		free(str);
+	}
+
+	wrk = json_object_get(val, "work_packages");
+
+	if (!wrk) {
+		applog(LOG_ERR, "Invalid JSON response to getWork request");
+		return -1;
+	}
+
+	// Check If Any Active Work Packages Are Available
+	num_pkg = json_array_size(wrk);
+	if (num_pkg != 1) {
+		applog(LOG_INFO, "Unable to retrieve storage for work_id %s", work_str);
+		return -1;
+	}
+
+	pkg = json_array_get(wrk, 0);
 
 	// Get Storage Values From JSON Message
 	str = (char *)json_string_value(json_object_get(pkg, "storage"));
@@ -2088,40 +2906,60 @@ static int get_work_storage(CURL *curl, char *work_str, uint32_t *storage) {
 	int iterations_left = (int)json_integer_value(json_object_get(pkg, "iterations_left"));
 	iteration_id = iterations - iterations_left;
 
-	// Storage Is Optional For Iteration 0
+	// Storage Is Optional For Iteration 0 - The Job Sees Zeros
 	if (!str && (iteration_id == 0)) {
-		json_decref(val);
+		*buf = storage_create(storage_sz);
+		if (!*buf) {
+			applog(LOG_ERR, "Unable to allocate storage for work_id: %s", work_str);
+			return -1;
+		}
+		memset((*buf)->data, 0, storage_sz * sizeof(uint32_t));
 		return 0xFFFF;
 	}
 
 	if (!str) {
 		applog(LOG_ERR, "ERROR: Invalid 'storage' for work_id: %s", work_str);
-		json_decref(val);
 		return -1;
 	}
 
-	if (!hex2ints(storage, sizeof(*storage), str, max_str_len)) {
+	// Storage Already Decoded For Another Iteration / Earlier Selection
+	*buf = storage_cache_get(work_id, storage_id);
+	if (*buf) {
+		applog(LOG_DEBUG, "DEBUG: Reusing cached storage %u for work_id: %s", storage_id, work_str);
+		return storage_id;
+	}
+
+	*buf = storage_create(storage_sz);
+	if (!*buf) {
+		applog(LOG_ERR, "Unable to allocate storage for work_id: %s", work_str);
+		return -1;
+	}
+
+	if (!hex2ints((*buf)->data, storage_sz, str, (int)strlen(str))) {
 		applog(LOG_ERR, "ERROR: Unable to convert 'storage' for work_id: %s", work_str);
-		json_decref(val);
+		storage_release(*buf);
+		*buf = NULL;
 		return -1;
 	}
 
+	storage_cache_put(work_id, storage_id, *buf);
+
 	gettimeofday(&tv_start, NULL);
 	if (opt_protocol) {
 		timeval_subtract(&diff, &tv_start, &tv_end);
 		applog(LOG_DEBUG, "DEBUG: Time to convert storage: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
 	}
 
-	json_decref(val);
 
 	return storage_id;
 }
 
-static bool submit_work(CURL *curl, struct submit_req *req) {
-	int err, submit_data_sz;
-	json_t *val = NULL;
-	struct timeval tv_start, tv_end, diff;
-	char *url = NULL, *data = NULL, *submit_data_hex = NULL, *err_desc = NULL;
+// Builds The URL & Post Data For A Submit Request (Returns false If There Is Nothing To Send)
+static bool submit_prepare(struct submit_req *req, char **url_out, char **data_out) {
+	int submit_data_sz;
+	char *url = NULL, *data = NULL, *submit_data_hex = NULL;
+
+	*url_out = *data_out = NULL;
 
 	url = calloc(1, strlen(rpc_url) + 50);
 	if (!url) {
@@ -2134,24 +2972,15 @@ static bool submit_work(CURL *curl, struct submit_req *req) {
 		// Allocate Memory For Data Buffers
 		submit_data_sz = (req->submit_data_sz * 8) + 1;
 		data = calloc(1, 512 + submit_data_sz);
-		if (!data) {
+		submit_data_hex = calloc(1, submit_data_sz);
+		if (!data || !submit_data_hex) {
 			applog(LOG_ERR, "ERROR: Unable to allocate memory to submit work data");
-			return false;
-		}
-		if (req->submit_data_sz) {
-			submit_data_hex = calloc(1, submit_data_sz);
-			if (!submit_data_hex) {
-				applog(LOG_ERR, "ERROR: Unable to allocate memory for submit data");
-				return false;
-			}
+			goto err_out;
 		}
 
 		if (req->submit_data_sz) {
 			if(!ints2hex(req->submit_data, req->submit_data_sz, submit_data_hex, submit_data_sz))
-				return false;
-		}
-		else {
-			submit_data_hex = calloc(1, sizeof(char));
+				goto err_out;
 		}
 
 		if (req->req_type == SUBMIT_BOUNTY) {
@@ -2167,26 +2996,45 @@ static bool submit_work(CURL *curl, struct submit_req *req) {
 	else {
 		applog(LOG_ERR, "ERROR: Unknown request type");
 		req->req_type = SUBMIT_COMPLETE;
-		free(url);
-		return true;
+		goto err_out;
 	}
 
-	gettimeofday(&tv_start, NULL);
-	val = json_rpc_call(curl, url, rpc_userpass, data, &err);
+	free(submit_data_hex);
+	*url_out = url;
+	*data_out = data;
+	return true;
+
+err_out:
+	free(url);
+	free(data);
+	free(submit_data_hex);
+	return false;
+}
+
+// Flags A Package's POW / Bounty Limit As Reached (Returns true If It Was Not Already)
+static bool cap_package(uint64_t work_id, bool pow) {
+	bool capped = false;
+	int idx;
+
+	pthread_mutex_lock(&work_lock);
+	idx = find_work_package(work_id);
+	if ((idx >= 0) && pow && !g_work_package[idx].pow_capped)
+		capped = g_work_package[idx].pow_capped = true;
+	else if ((idx >= 0) && !pow && !g_work_package[idx].bty_capped)
+		capped = g_work_package[idx].bty_capped = true;
+	pthread_mutex_unlock(&work_lock);
 
-	if (!val)
-		return false;
+	return capped;
+}
 
-	gettimeofday(&tv_end, NULL);
-	if (opt_protocol) {
-		timeval_subtract(&diff, &tv_end, &tv_start);
-		applog(LOG_DEBUG, "DEBUG: Time to submit solution: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
-	}
+// Reports The Node's Response To A Submit Request & Marks It Complete ('data' Is Masked For Logging)
+static void submit_result(struct submit_req *req, json_t *val, char *data) {
+	char *err_desc = NULL;
 
 	// Mask Passphrase
 	data[strlen(data) - strlen(passphrase)] = 0;
 
-	applog(LOG_DEBUG, "DEBUG: Submit request - %s %s", url, data);
+	applog(LOG_DEBUG, "DEBUG: Submit request - %s?requestType=submitSolution %s", rpc_url, data);
 
 	err_desc = (char *)json_string_value(json_object_get(val, "errorDescription"));
 
@@ -2204,12 +3052,13 @@ static bool submit_work(CURL *curl, struct submit_req *req) {
 				g_bounty_accepted_cnt++;
 			}
 			else if (strstr(err_desc, "limit of")) {
-				pthread_mutex_lock(&longpoll_lock);
-				if(!*g_bounty_ignore)
-					applog(LOG_NOTICE, "%s: %s***** Bounty limit reached for this block, pausing until next block *****", thr_info[req->thr_id].name, CL_YLW);
+				if (cap_package(req->work_id, false)) {
+					applog(LOG_NOTICE, "%s: %s***** Bounty limit reached for work_id %s this block, pausing it until next block *****", thr_info[req->thr_id].name, CL_YLW, req->work_str);
+					g_rebalance = true;
+					tq_wake(thr_info[work_thr_id].q);
+					update_ignore_flags();
+				}
 				g_bounty_rejected_cnt++;
-				*g_bounty_ignore=true;
-				pthread_mutex_unlock(&longpoll_lock);
 			}
 			else {
 				applog(LOG_NOTICE, "%s: %s***** Bounty Rejected! (Probably a new block is currenly being broadcast) *****", thr_info[req->thr_id].name, CL_RED);
@@ -2234,12 +3083,13 @@ static bool submit_work(CURL *curl, struct submit_req *req) {
 				g_pow_discarded_cnt++;
 			}
 			else if (strstr(err_desc, "limit of")) {
-				pthread_mutex_lock(&longpoll_lock);
-				if(!*g_pow_ignore)
-					applog(LOG_NOTICE, "%s: %s***** POW limit reached for this block, pausing until next block *****", thr_info[req->thr_id].name, CL_YLW);
+				if (cap_package(req->work_id, true)) {
+					applog(LOG_NOTICE, "%s: %s***** POW limit reached for work_id %s this block, pausing it until next block *****", thr_info[req->thr_id].name, CL_YLW, req->work_str);
+					g_rebalance = true;
+					tq_wake(thr_info[work_thr_id].q);
+					update_ignore_flags();
+				}
 				g_pow_discarded_cnt++;
-				*g_pow_ignore=true;
-				pthread_mutex_unlock(&longpoll_lock);
 			}
 			else {
 				applog(LOG_NOTICE, "%s: %s***** POW Rejected! (Probably a new block is currenly being broadcast) *****", thr_info[req->thr_id].name, CL_RED);
@@ -2252,13 +3102,6 @@ static bool submit_work(CURL *curl, struct submit_req *req) {
 		}
 		req->req_type = SUBMIT_COMPLETE;
 	}
-
-	json_decref(val);
-	free(url);
-	if (data) free(data);
-	if (submit_data_hex) free(submit_data_hex);
-
-	return true;
 }
 
 bool validate_work_source(int package_id, struct instance *inst) {
@@ -2430,24 +3273,25 @@ static void *cpu_miner_thread(void *userdata) {
 	int rc = 0;
 	double eval_rate;
 	struct instance *inst = NULL;
-	uint32_t rnd = 0, iteration = 0;
-
-	uint32_t vm_ints = 0;
-	uint32_t vm_uints = 0;
-	uint32_t vm_longs = 0;
-	uint32_t vm_ulongs = 0;
-	uint32_t vm_floats = 0;
-	uint32_t vm_doubles = 0;
-	uint32_t vm_storage = 0;
+	struct nonce_range nonce = { 0, 0 };
+	struct work_snapshot *snap = NULL, *next;
+	uint32_t iteration = 0, park_gen, verify_pow;
+	uint32_t *storage = NULL;
+	int lib_gen = 0;
+
+	struct vm_arena arena = { NULL, 0, false };
+	uint32_t vm_sizes[7] = { 0 };	// ints, uints, longs, ulongs, floats, doubles, storage
+	bool grow;
+
+	// Pin The Thread First So Its VM Memory Is Placed On The Local NUMA Node
+	affinity_apply(thr_id);
 
 	// Set lower priority
 	if (!opt_norenice)
 		thread_low_priority();
 
 	// Initialize Global Variables
-	vm_m = calloc(VM_M_ARRAY_SIZE, sizeof(uint32_t));
-
-	if (!vm_m ) {
+	if (!layout_vm_memory(&arena, vm_sizes)) {
 		applog(LOG_ERR, "CPU%d: Unable to allocate VM memory", thr_id);
 		goto out;
 	}
@@ -2457,125 +3301,114 @@ static void *cpu_miner_thread(void *userdata) {
 	gettimeofday((struct timeval *) &tv_start, NULL);
 
 	while (1) {
-		pthread_mutex_lock(&longpoll_lock);
-		bool res = *g_pow_ignore && *g_bounty_ignore;
-		pthread_mutex_unlock(&longpoll_lock);
-		if(res){
-			sleep(1);
+		// Read Before Checking, So A Wake-Up Between The Check And Parking Is Not Lost
+		park_gen = ATOMIC_LOAD(&g_park_gen);
+
+		if (ATOMIC_LOAD(&g_pow_ignore) && ATOMIC_LOAD(&g_bounty_ignore)) {
+			park_thread(park_gen);
 			continue;
 			// do not work if there is not chance to submit anyway
 		}
 
+		// Pick Up Newly Published Work
+		next = snapshot_take(thr_id);
+		if (next) {
+			snapshot_release(snap);
+			snap = next;
+		}
+
 		// No Work Available
-		if (!g_work.work_id) {
+		if (!snap || !snap->work.work_id) {
 			if (work.work_id)
 				memset(&work, 0, sizeof(struct work));
-			sleep(1);
+			park_thread(park_gen);
 			continue;
 		}
 
-		// Check If We Are Mining The Most Current Work
-		if (work.work_id != g_work.work_id) {
+		// Check If We Are Mining The Work Assigned To This Thread
+		if (work.work_id != snap->work.work_id) {
 
-			// Copy Global Work Into Local Thread Work
-			memcpy((void *)&work, (void *)&g_work, sizeof(struct work));
+			// Copy Assigned Work Into Local Thread Work
+			memcpy((void *)&work, (void *)&snap->work, sizeof(struct work));
 			work.thr_id = thr_id;
 
-			// Allocate Memory For Global Variables
-			if (g_work_package[work.package_id].vm_ints > vm_ints) {
-				vm_ints = g_work_package[work.package_id].vm_ints;
-				vm_i = realloc(vm_i, vm_ints * sizeof(int32_t));
-				memset(vm_i, 0, vm_ints * sizeof(int32_t));
-			}
-			if (g_work_package[work.package_id].vm_uints > vm_uints) {
-				vm_uints = g_work_package[work.package_id].vm_uints;
-				vm_u = realloc(vm_u, vm_uints * sizeof(uint32_t));
-				memset(vm_u, 0, vm_uints * sizeof(uint32_t));
-			}
-			if (g_work_package[work.package_id].vm_longs > vm_longs) {
-				vm_longs = g_work_package[work.package_id].vm_longs;
-				vm_l = realloc(vm_l, vm_longs * sizeof(int64_t));
-				memset(vm_l, 0, vm_longs * sizeof(int64_t));
-			}
-			if (g_work_package[work.package_id].vm_ulongs > vm_ulongs) {
-				vm_ulongs = g_work_package[work.package_id].vm_ulongs;
-				vm_ul = realloc(vm_ul, vm_ulongs * sizeof(uint64_t));
-				memset(vm_ul, 0, vm_ulongs * sizeof(uint64_t));
-			}
-			if (g_work_package[work.package_id].vm_floats > vm_floats) {
-				vm_floats = g_work_package[work.package_id].vm_floats;
-				vm_f = realloc(vm_f, vm_floats * sizeof(float));
-				memset(vm_f, 0, vm_floats * sizeof(float));
-			}
-			if (g_work_package[work.package_id].vm_doubles > vm_doubles) {
-				vm_doubles = g_work_package[work.package_id].vm_doubles;
-				vm_d = realloc(vm_d, vm_doubles * sizeof(double));
-				memset(vm_d, 0, vm_doubles * sizeof(double));
-			}
-			if (g_work_package[work.package_id].storage_sz > vm_storage) {
-				vm_storage = g_work_package[work.package_id].storage_sz;
-				vm_s = realloc(vm_s, vm_storage * sizeof(uint32_t));
-				memset(vm_s, 0, vm_storage * sizeof(uint32_t));
-			}
-
-			if ((vm_ints && !vm_i) ||
-				(vm_uints && !vm_u) ||
-				(vm_longs && !vm_l) ||
-				(vm_ulongs && !vm_ul) ||
-				(vm_floats && !vm_f) ||
-				(vm_doubles && !vm_d) ||
-				(vm_storage && !vm_s)) {
-
+			// Grow The VM Memory To Fit The Largest Work Seen So Far
+			grow = false;
+			grow |= update_vm_size(&vm_sizes[0], snap->pkg.vm_ints);
+			grow |= update_vm_size(&vm_sizes[1], snap->pkg.vm_uints);
+			grow |= update_vm_size(&vm_sizes[2], snap->pkg.vm_longs);
+			grow |= update_vm_size(&vm_sizes[3], snap->pkg.vm_ulongs);
+			grow |= update_vm_size(&vm_sizes[4], snap->pkg.vm_floats);
+			grow |= update_vm_size(&vm_sizes[5], snap->pkg.vm_doubles);
+			grow |= update_vm_size(&vm_sizes[6], snap->pkg.storage_sz);
+
+			if (grow && !layout_vm_memory(&arena, vm_sizes)) {
 				applog(LOG_ERR, "CPU%d: Unable to allocate VM memory", thr_id);
 				goto out;
 			}
 
-			// Create A Compiled VM Instance For The Thread
-			if (inst)
-				free_library(inst);
-			inst = calloc(1, sizeof(struct instance));
-			create_instance(inst, work.work_str);
+			// Share The Compiled VM Instance Of The Package With The Other Threads On It
+			release_instance(inst);
+			lib_gen = ATOMIC_LOAD(&g_library_gen);
+			inst = acquire_instance(work.work_str);
+			if (!inst) {
+				applog(LOG_ERR, "CPU%d: Unable to load job library", thr_id);
+				goto out;
+			}
 
-			// Set Round / Iteration For The Work
-			rnd = 0;
-			iteration = g_work_package[work.package_id].iteration_id;
+			// Set Iteration For The Work
+			iteration = snap->pkg.iteration_id;
 
-			// Copy New Storage Values To VM
-			if (g_work_package[work.package_id].storage_sz) {
-				if (g_work_package[work.package_id].storage_id < 0xFFFF)
-					memcpy(vm_s, g_work_package[work.package_id].storage, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-				else
-					memset(vm_s, 0, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-			}
+			// Point s[] At The Shared Storage Of The Iteration Instead Of Copying It
+			storage = snap->pkg.storage ? snap->pkg.storage->data : vm_s;
 
-			inst->initialize(vm_m, vm_i, vm_u, vm_l, vm_ul, vm_f, vm_d, vm_s);
+			inst->initialize(vm_m, vm_i, vm_u, vm_l, vm_ul, vm_f, vm_d, storage);
 
 
 		}
 		// Otherwise, Just Update POW Target / Iteration / Storage
 		else {
-			memcpy(&work.pow_target, &g_work.pow_target, 4 * sizeof(uint32_t));
+			if (next)
+				memcpy(&work.pow_target, &snap->work.pow_target, 4 * sizeof(uint32_t));
+
+			// Switch To A Faster Build Of The Same Job Once The Autotuner Finds One
+			if (opt_autotune && (lib_gen != ATOMIC_LOAD(&g_library_gen))) {
+				lib_gen = ATOMIC_LOAD(&g_library_gen);
+				if (library_updated(inst, work.work_str)) {
+					release_instance(inst);
+					inst = acquire_instance(work.work_str);
+					if (!inst) {
+						applog(LOG_ERR, "CPU%d: Unable to load job library", thr_id);
+						goto out;
+					}
+					inst->initialize(vm_m, vm_i, vm_u, vm_l, vm_ul, vm_f, vm_d, storage);
+					applog(LOG_DEBUG, "DEBUG: CPU%d: Loaded autotuned library", thr_id);
+				}
+			}
 
-			if (work.iteration_id != g_work.iteration_id) {
+			if (work.iteration_id != snap->work.iteration_id) {
 
-				// Set Round / Iteration For The Work
-				rnd = 0;
-				iteration = g_work_package[work.package_id].iteration_id;
+				// Set Iteration For The Work
+				iteration = snap->pkg.iteration_id;
+				work.iteration_id = snap->work.iteration_id;
+			}
+			work.storage_id = snap->work.storage_id;
+			work.block_id = snap->work.block_id;
 
-				// Copy New Storage Values To VM
-				if (g_work_package[work.package_id].storage_sz) {
-					if (g_work_package[work.package_id].storage_id < 0xFFFF)
-						memcpy(vm_s, g_work_package[work.package_id].storage, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-					else
-						memset(vm_s, 0, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-				}
+			// The Previous Snapshot (And Possibly Its Storage) Has Been Released
+			if (storage != (snap->pkg.storage ? snap->pkg.storage->data : vm_s)) {
+				storage = snap->pkg.storage ? snap->pkg.storage->data : vm_s;
+				inst->initialize(vm_m, vm_i, vm_u, vm_l, vm_ul, vm_f, vm_d, storage);
 			}
 		}
 
 		work_restart[thr_id].restart = 0;
 
+		// Skip The POW Check Entirely While No POW Can Be Submitted For This Package
+		verify_pow = !(snap->pkg.pow_capped || ATOMIC_LOAD(&g_pow_ignore) || (ignore_mask & 1));
+
 		// Run VM To Check For POW Hash & Bounties
-		rc = execute_vm(thr_id, &rnd, iteration, &work, inst, &hashes_done);
+		rc = execute_vm(thr_id, &nonce, iteration, &work, inst, verify_pow, &hashes_done);
 
 		// Record Elapsed Time
 		gettimeofday(&tv_end, NULL);
@@ -2599,10 +3432,7 @@ static void *cpu_miner_thread(void *userdata) {
 		}
 
 		// Submit Work That Meets Bounty Criteria
-		pthread_mutex_lock(&longpoll_lock);
-		bool ign = *g_bounty_ignore;
-		pthread_mutex_unlock(&longpoll_lock);
-		if (ign==false && (rc == 1 && (ignore_mask&2)==0)) {
+		if (!ATOMIC_LOAD(&g_bounty_ignore) && (rc == 1 && (ignore_mask&2)==0)) {
 
 			if(delay_sleep>0)
 				sleep(delay_sleep);
@@ -2621,13 +3451,14 @@ static void *cpu_miner_thread(void *userdata) {
 			memcpy(&wc->work, &work, sizeof(struct work));
 
 			// Save Values To Be Submitted To Node
-			if (g_work_package[work.package_id].submit_sz) {
-				wc->submit_data = malloc(g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
-				memcpy(wc->submit_data, &vm_u[g_work_package[work.package_id].storage_idx], g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
+			if (snap->pkg.submit_sz) {
+				wc->submit_data = malloc(snap->pkg.submit_sz * sizeof(uint32_t));
+				wc->submit_sz = snap->pkg.submit_sz;
+				memcpy(wc->submit_data, &vm_u[snap->pkg.storage_idx], snap->pkg.submit_sz * sizeof(uint32_t));
 			}
 
 			// Add Solution To Queue
-			if (!tq_push(thr_info[work_thr_id].q, wc)) {
+			if (!submit_push(wc)) {
 				applog(LOG_ERR, "ERROR: Unable to add solution to queue.  Shutting down thread for CPU%d", thr_id);
 				if (wc->submit_data) free(wc->submit_data);
 				free(wc);
@@ -2638,10 +3469,7 @@ static void *cpu_miner_thread(void *userdata) {
 		}
 
 		// Submit Work That Meets POW Target
-		pthread_mutex_lock(&longpoll_lock);
-		ign = *g_pow_ignore;
-		pthread_mutex_unlock(&longpoll_lock);
-		if (ign==false && (rc == 2 && (ignore_mask&1)==0)) {
+		if (!ATOMIC_LOAD(&g_pow_ignore) && (rc == 2 && (ignore_mask&1)==0)) {
 
 			if(delay_sleep>0)
 				sleep(delay_sleep);
@@ -2649,14 +3477,8 @@ static void *cpu_miner_thread(void *userdata) {
 			applog(LOG_DEBUG, "CPU%d: Submitting POW Solution", thr_id);
 			applog(LOG_DEBUG, "DEBUG: Hash - %08X%08X%08X...  Tgt - %s", work.pow_hash[0], work.pow_hash[1], work.pow_hash[2], g_pow_target_str);
 			applog(LOG_DEBUG, "DEBUG: First 4 Inputs were: %d, %d, %d, %d", work.vm_input[0], work.vm_input[1], work.vm_input[2], work.vm_input[3]);
-			pthread_mutex_lock(&longpoll_lock);
-			bool ign2 = *g_pow_ignore && *g_bounty_ignore;
-			pthread_mutex_unlock(&longpoll_lock);
-			if(ign2){
-						sleep(1);
-						continue;
-						// do not work if there is not chance to submit anyway
-					}
+			if (ATOMIC_LOAD(&g_pow_ignore) && ATOMIC_LOAD(&g_bounty_ignore))
+				continue;	// Parks At The Top Of The Loop
 
 			wc = (struct workio_cmd *) calloc(1, sizeof(*wc));
 			if (!wc) {
@@ -2669,13 +3491,14 @@ static void *cpu_miner_thread(void *userdata) {
 			memcpy(&wc->work, &work, sizeof(struct work));
 
 			// Save Values To Be Submitted To Node
-			if (g_work_package[work.package_id].submit_sz) {
-				wc->submit_data = malloc(g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
-				memcpy(wc->submit_data, &vm_u[g_work_package[work.package_id].storage_idx], g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
+			if (snap->pkg.submit_sz) {
+				wc->submit_data = malloc(snap->pkg.submit_sz * sizeof(uint32_t));
+				wc->submit_sz = snap->pkg.submit_sz;
+				memcpy(wc->submit_data, &vm_u[snap->pkg.storage_idx], snap->pkg.submit_sz * sizeof(uint32_t));
 			}
 
 			// Add Solution To Queue
-			if (!tq_push(thr_info[work_thr_id].q, wc)) {
+			if (!submit_push(wc)) {
 				applog(LOG_ERR, "ERROR: Unable to add solution to queue.  Shutting down thread for CPU%d", thr_id);
 				if (wc->submit_data) free(wc->submit_data);
 				free(wc);
@@ -2686,24 +3509,59 @@ static void *cpu_miner_thread(void *userdata) {
 	}
 
 out:
-	if (inst)
-		free_library(inst);
-	if (inst) free(inst);
+	release_instance(inst);
 	inst = NULL;
-	if (vm_m) free(vm_m);
-	if (vm_i) free(vm_i);
-	if (vm_u) free(vm_u);
-	if (vm_l) free(vm_l);
-	if (vm_ul) free(vm_ul);
-	if (vm_f) free(vm_f);
-	if (vm_d) free(vm_d);
-	if (vm_s) free(vm_s);
+	snapshot_release(snap);
+	vm_arena_release(&arena);
 
 	tq_freeze(mythr->q);
 
 	return NULL;
 }
 
+static bool update_vm_size(uint32_t *cur, uint32_t size) {
+	if (size <= *cur)
+		return false;
+	*cur = size;
+	return true;
+}
+
+// Carves The VM Arrays Of A Miner Thread Out Of Its Arena, Each Starting On A Cache Line.
+// The Arena Is Cleared Here By The (Pinned) Thread, Which Places Its Pages
+static bool layout_vm_memory(struct vm_arena *arena, uint32_t *vm_sizes) {
+	void **ptr[8] = { (void **)&vm_m, (void **)&vm_i, (void **)&vm_u, (void **)&vm_l, (void **)&vm_ul, (void **)&vm_f, (void **)&vm_d, (void **)&vm_s };
+	size_t len[8], total = 0;
+	char *p;
+	int i;
+
+	len[0] = VM_M_ARRAY_SIZE * sizeof(uint32_t);
+	len[1] = vm_sizes[0] * sizeof(int32_t);
+	len[2] = vm_sizes[1] * sizeof(uint32_t);
+	len[3] = vm_sizes[2] * sizeof(int64_t);
+	len[4] = vm_sizes[3] * sizeof(uint64_t);
+	len[5] = vm_sizes[4] * sizeof(float);
+	len[6] = vm_sizes[5] * sizeof(double);
+	len[7] = vm_sizes[6] * sizeof(uint32_t);
+
+	for (i = 0; i < 8; i++) {
+		len[i] = (len[i] + 63) & ~(size_t)63;
+		total += len[i];
+	}
+
+	if ((total > arena->size) && !vm_arena_reserve(arena, total))
+		return false;
+
+	memset(arena->base, 0, total);
+
+	p = (char *)arena->base;
+	for (i = 0; i < 8; i++) {
+		*ptr[i] = len[i] ? p : NULL;
+		p += len[i];
+	}
+
+	return true;
+}
+
 #ifdef USE_OPENCL
 static void *gpu_miner_thread(void *userdata) {
 	struct thr_info *mythr = (struct thr_info *) userdata;
@@ -2719,6 +3577,9 @@ static void *gpu_miner_thread(void *userdata) {
 	double eval_rate;
 	struct instance *inst = NULL;
 	uint32_t *mult32 = (uint32_t *)work.multiplicator;
+	struct work_snapshot *snap = NULL, *next;
+	uint32_t park_gen;
+	uint64_t round;
 
 	// Set lower priority
 	if (!opt_norenice)
@@ -2747,51 +3608,49 @@ static void *gpu_miner_thread(void *userdata) {
 	gettimeofday((struct timeval *) &tv_start, NULL);
 
 	while (1) {
+		park_gen = ATOMIC_LOAD(&g_park_gen);
+
+		// Pick Up Newly Published Work
+		next = snapshot_take(thr_id);
+		if (next) {
+			snapshot_release(snap);
+			snap = next;
+		}
 
 		// No Work Available
-		if (!g_work.work_id) {
+		if (!snap || !snap->work.work_id) {
 			if (work.work_id)
 				memset(&work, 0, sizeof(struct work));
-			sleep(1);
+			park_thread(park_gen);
 			continue;
 		}
 
-		// Check If We Are Mining The Most Current Work
-		if (work.work_id != g_work.work_id) {
+		// Check If We Are Mining The Work Assigned To This Thread
+		if (work.work_id != snap->work.work_id) {
 
 
 
-			// Copy Global Work Into Local Thread Work
-			memcpy(&work, &g_work, sizeof(struct work));
+			// Copy Assigned Work Into Local Thread Work
+			memcpy(&work, &snap->work, sizeof(struct work));
 			work.thr_id = thr_id;
 
-			// Allocate Memory For Storage
-			if (g_work_package[work.package_id].storage_sz > vm_storage) {
-				vm_storage = g_work_package[work.package_id].storage_sz;
-				vm_submit = realloc(vm_s, vm_storage * sizeof(uint32_t));
-				vm_s = realloc(vm_s, vm_storage * sizeof(uint32_t));
-				memset(vm_s, 0, vm_storage * sizeof(uint32_t));
+			// Allocate Memory For Submit Data
+			if (snap->pkg.storage_sz > vm_storage) {
+				vm_storage = snap->pkg.storage_sz;
+				vm_submit = realloc(vm_submit, vm_storage * sizeof(uint32_t));
 
-				if (vm_storage && (!vm_s || !vm_submit)) {
+				if (vm_storage && !vm_submit) {
 					applog(LOG_ERR, "GPU%d: Unable to allocate memory for storage", thr_id);
 					goto out;
 				}
 			}
 
-			// Copy New Storage Values To VM
-			if (g_work_package[work.package_id].storage_sz) {
-				if (g_work_package[work.package_id].storage_id < 0xFFFF)
-					memcpy(vm_s, g_work_package[work.package_id].storage, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-				else
-					memset(vm_s, 0, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-			}
-
 			// Randomize Inputs
-			mult32[0] = thr_id;												// Ensures Each Thread Is Unique
+			mult32[0] = 0;													// N/A - Rounds Are Unique Across Threads
 			mult32[1] = 0;													// Round - Value Will Be Incremented For Each GPU Thread
-			mult32[2] = g_work_package[work.package_id].iteration_id;		// Iteration
+			mult32[2] = snap->pkg.iteration_id;		// Iteration
 			mult32[3] = 0;													// GPU OpenCL Thread ID
-			mult32[7] = genrand_int32();									// Random Number
+			mult32[7] = nonce_salt;											// Random Number (Per Process)
 
 			// Load & Compile OpenCL Code
 			ocl_source = opencl_load_source(work.work_str);
@@ -2809,7 +3668,7 @@ static void *gpu_miner_thread(void *userdata) {
 			}
 
 			// Create OpenCL Kernel / Set Arguments
-			if (!opencl_create_kernel(&gpu[thr_id], ocl_source, g_work_package[0].storage_sz)) {
+			if (!opencl_create_kernel(&gpu[thr_id], ocl_source, snap->pkg.storage_sz)) {
 				memset(&work, 0, sizeof(struct work));
 				free(ocl_source);
 				sleep(15);
@@ -2817,26 +3676,35 @@ static void *gpu_miner_thread(void *userdata) {
 			}
 
 			free(ocl_source);
+
+			// Upload The Shared Storage Straight To The Device
+			if (snap->pkg.storage && !opencl_load_storage(&gpu[thr_id], snap->pkg.storage->data, snap->pkg.storage_sz)) {
+				memset(&work, 0, sizeof(struct work));
+				sleep(15);
+				continue;
+			}
 		}
 		else {
 			// Update Target For Work
-			memcpy(&work.pow_target, &g_work.pow_target, 4 * sizeof(uint32_t));
+			memcpy(&work.pow_target, &snap->work.pow_target, 4 * sizeof(uint32_t));
+			work.storage_id = snap->work.storage_id;
+			work.block_id = snap->work.block_id;
 
-			if (work.iteration_id != g_work.iteration_id) {
+			if (work.iteration_id != snap->work.iteration_id) {
+				work.iteration_id = snap->work.iteration_id;
 
 				// Randomize Inputs
-				mult32[0] = thr_id;												// Ensures Each Thread Is Unique
+				mult32[0] = 0;													// N/A - Rounds Are Unique Across Threads
 				mult32[1] = 0;													// Round - Value Will Be Incremented After Each Pass
-				mult32[2] = g_work_package[work.package_id].iteration_id;		// Iteration
+				mult32[2] = snap->pkg.iteration_id;		// Iteration
 				mult32[3] = 0;													// GPU OpenCL Thread ID
-				mult32[7] = genrand_int32();									// Random Number
-
-				// Copy New Storage Values To VM
-				if (g_work_package[work.package_id].storage_sz) {
-					if (g_work_package[work.package_id].iteration_id)
-						memcpy(vm_s, g_work_package[work.package_id].storage, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
-					else
-						memset(vm_s, 0, g_work_package[work.package_id].storage_sz * sizeof(uint32_t));
+				mult32[7] = nonce_salt;											// Random Number (Per Process)
+
+				// Upload The Shared Storage Of The New Iteration
+				if (snap->pkg.storage && !opencl_load_storage(&gpu[thr_id], snap->pkg.storage->data, snap->pkg.storage_sz)) {
+					memset(&work, 0, sizeof(struct work));
+					sleep(15);
+					continue;
 				}
 			}
 
@@ -2844,32 +3712,33 @@ static void *gpu_miner_thread(void *userdata) {
 
 		work_restart[thr_id].restart = 0;
 
+		// Claim One Round For Each GPU Thread In This Pass
+		round = nonce_alloc(gpu[thr_id].threads);
+		vm_round[0] = (uint32_t)round;
+		mult32[4] = (uint32_t)(round >> 32);
+
 		// Get Values For VM Inputs
 		get_opencl_base_data(&work, vm_input);
 
 		// Execute The VM
-		if (!opencl_run_kernel(&gpu[thr_id], vm_round, vm_result, vm_output, vm_submit, g_work_package[0].storage_sz))
+		if (!opencl_run_kernel(&gpu[thr_id], vm_round, vm_result, vm_output, vm_submit, snap->pkg.storage_sz))
 			goto out;
 
 		if (!vm_result[0])
 			continue;
 
 		// Update Multiplicator To Include Round Number & Thread ID
-		mult32[1] = vm_output[0];						// Round Number
-		mult32[3] = vm_output[0] % gpu[thr_id].threads;	// GPU Thread ID
+		mult32[1] = vm_round[0] + vm_output[0];			// Round Number
+		mult32[3] = vm_output[0];						// GPU Thread ID
 
 		// Copy Hash To Work Structure
 		memcpy(&work.pow_hash[0], &vm_output[1], 16);
 
 		// Check For Bounty Solutions
-		pthread_mutex_lock(&longpoll_lock);
-		bool ign = *g_bounty_ignore;
-		pthread_mutex_unlock(&longpoll_lock);
+		bool ign = ATOMIC_LOAD(&g_bounty_ignore);
 
 		// Check For POW Solutions
-		pthread_mutex_lock(&longpoll_lock);
-		bool ignpow = *g_pow_ignore;
-		pthread_mutex_unlock(&longpoll_lock);
+		bool ignpow = ATOMIC_LOAD(&g_pow_ignore);
 		if (ign==false && (vm_result[0] > 1)) {
 			applog(LOG_NOTICE, "%s - %d: Submitting Bounty Solution", mythr->name, mult32[3]);
 
@@ -2885,13 +3754,14 @@ static void *gpu_miner_thread(void *userdata) {
 			memcpy(&wc->work, &work, sizeof(struct work));
 
 			// Save Values To Be Submitted To Node
-			if (g_work_package[work.package_id].submit_sz) {
-				wc->submit_data = malloc(g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
-				memcpy(wc->submit_data, vm_submit, g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
+			if (snap->pkg.submit_sz) {
+				wc->submit_data = malloc(snap->pkg.submit_sz * sizeof(uint32_t));
+				wc->submit_sz = snap->pkg.submit_sz;
+				memcpy(wc->submit_data, vm_submit, snap->pkg.submit_sz * sizeof(uint32_t));
 			}
 
 			// Add Solution To Queue
-			if (!tq_push(thr_info[work_thr_id].q, wc)) {
+			if (!submit_push(wc)) {
 				applog(LOG_ERR, "ERROR: Unable to add solution to queue.  Shutting down thread for GPU%d", thr_id);
 				if (wc->submit_data) free(wc->submit_data);
 				free(wc);
@@ -2917,13 +3787,14 @@ static void *gpu_miner_thread(void *userdata) {
 			memcpy(&wc->work, &work, sizeof(struct work));
 
 			// Save Values To Be Submitted To Node
-			if (g_work_package[work.package_id].submit_sz) {
-				wc->submit_data = malloc(g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
-				memcpy(wc->submit_data, vm_submit, g_work_package[work.package_id].submit_sz * sizeof(uint32_t));
+			if (snap->pkg.submit_sz) {
+				wc->submit_data = malloc(snap->pkg.submit_sz * sizeof(uint32_t));
+				wc->submit_sz = snap->pkg.submit_sz;
+				memcpy(wc->submit_data, vm_submit, snap->pkg.submit_sz * sizeof(uint32_t));
 			}
 
 			// Add Solution To Queue
-			if (!tq_push(thr_info[work_thr_id].q, wc)) {
+			if (!submit_push(wc)) {
 				applog(LOG_ERR, "ERROR: Unable to add solution to queue.  Shutting down thread for GPU%d", thr_id);
 				if (wc->submit_data) free(wc->submit_data);
 				free(wc);
@@ -2937,9 +3808,6 @@ static void *gpu_miner_thread(void *userdata) {
 		gettimeofday(&tv_end, NULL);
 		timeval_subtract(&diff, &tv_end, &tv_start);
 		if (diff.tv_sec >= 5) {
-
-			mult32[7] = genrand_int32();
-
 			if (!opt_quiet) {
 				eval_rate = (double)((hashes_done / (diff.tv_sec + (diff.tv_usec / 1000000.0))) / 1000.0);
 				sprintf(str, eval_rate >= 1000.0 ? "%0.2f mEval/s" : "%0.2f kEval/s", (eval_rate >= 1000.0) ? eval_rate / 1000 : eval_rate);
@@ -2949,8 +3817,6 @@ static void *gpu_miner_thread(void *userdata) {
 			hashes_done = 0;
 		}
 
-		// Increment multiplicator
-		mult32[1] += 1;	// Increment Round
 		mult32[3] = 0;	// Reset GPU OpenCL Thread ID
 	}
 
@@ -2969,20 +3835,13 @@ out:
 	if (vm_round) free(vm_round);
 	if (vm_result) free(vm_result);
 	if (vm_submit) free(vm_submit);
-	if (vm_s) free(vm_s);
+	snapshot_release(snap);
 	tq_freeze(mythr->q);
 
 	return NULL;
 }
 #endif
 
-static void restart_threads(void)
-{
-	int i;
-	for (i = 0; i < opt_n_threads; i++)
-		work_restart[i].restart = 1;
-}
-
 static void *longpoll_thread(void *userdata)
 {
 	struct thr_info *mythr = (struct thr_info *) userdata;
@@ -3045,9 +3904,13 @@ static void *longpoll_thread(void *userdata)
 
 					// Reset POW Counter When Block Changes
 					g_cur_pow_cnt = 0;
-					*g_pow_ignore = false;
-					*g_bounty_ignore = false;
+					ATOMIC_STORE(&g_pow_ignore, false);
+					ATOMIC_STORE(&g_bounty_ignore, false);
 					pthread_mutex_unlock(&longpoll_lock);
+
+					// Fetch The New Work Right Away (Stale POW Is Dropped Once It Arrives)
+					tq_wake(thr_info[work_thr_id].q);
+					unpark_threads();
 				}
 			}
 		}
@@ -3077,9 +3940,13 @@ static void *longpoll_thread(void *userdata)
 
 						// Reset POW Counter When Block Changes
 						g_cur_pow_cnt = 0;
-						*g_pow_ignore = false;
-						*g_bounty_ignore = false;
+						ATOMIC_STORE(&g_pow_ignore, false);
+						ATOMIC_STORE(&g_bounty_ignore, false);
 						pthread_mutex_unlock(&longpoll_lock);
+
+						// Fetch The New Work Right Away (Stale POW Is Dropped Once It Arrives)
+						tq_wake(thr_info[work_thr_id].q);
+						unpark_threads();
 					}
 				}
 			}
@@ -3099,8 +3966,9 @@ static void *workio_thread(void *userdata)
 {
 	struct thr_info *mythr = (struct thr_info *) userdata;
 	CURL *curl;
-	struct workio_cmd *wc;
-	int i, failures;
+	struct timespec ts;
+	time_t wait;
+	int failures;
 
 	curl = curl_easy_init();
 	if (!curl) {
@@ -3112,12 +3980,13 @@ static void *workio_thread(void *userdata)
 
 	while (1) {
 
-		sleep(1);
-
-		// Get Work (New Block or Every 'Scantime' To Check For Difficulty Change)
-		if (g_new_block || (time(NULL) - g_work_time) >= opt_scantime) {
-			applog(LOG_DEBUG, "Getting new work (reason: new block or just too long ago)");
+		// Get Work (New Block, Package Capped or Every 'Scantime' To Check For Difficulty Change)
+		if (g_new_block || g_rebalance || (time(NULL) - g_work_time) >= opt_scantime) {
+			applog(LOG_DEBUG, "Getting new work (reason: new block, rebalance or just too long ago)");
 
+			if (g_new_block)
+				reset_package_limits();
+			g_rebalance = false;
 
 			if (!get_work(curl)) {
 				if ((opt_retries >= 0) && (++failures > opt_retries)) {
@@ -3139,6 +4008,117 @@ static void *workio_thread(void *userdata)
 
 		}
 
+		// Block Until Longpoll Reports A New Block, A Package Is Capped Or The Next Scan Is Due
+		// (Solutions Are Handled By The Submit Thread)
+		if (!g_new_block && !g_rebalance) {
+			wait = g_work_time + opt_scantime - time(NULL);
+			if (wait < 1)
+				wait = 1;
+			ts.tv_sec = time(NULL) + wait;
+			ts.tv_nsec = 0;
+
+			tq_pop(mythr->q, &ts);
+		}
+	}
+
+	tq_freeze(mythr->q);
+	curl_easy_cleanup(curl);
+
+	return NULL;
+}
+
+// Queues A Solution For The Submit Thread
+extern bool submit_push(struct workio_cmd *wc) {
+	CURLM *multi;
+
+	if (!tq_push(thr_info[submit_thr_id].q, wc))
+		return false;
+
+	multi = g_submit_multi;
+	if (multi)
+		curl_multi_wakeup(multi);
+
+	return true;
+}
+
+// Handles A Finished Transfer - Failed Requests Go Back On The Queue For A Retry In A Second
+static void submit_finish(struct submit_xfer *xfer, int rc) {
+	int err;
+	json_t *val;
+	struct timeval tv_end, diff;
+
+	val = json_rpc_result(rc, &xfer->db, xfer->err_str, &err);
+	if (val) {
+		gettimeofday(&tv_end, NULL);
+		if (opt_protocol) {
+			timeval_subtract(&diff, &tv_end, &xfer->tv_start);
+			applog(LOG_DEBUG, "DEBUG: Time to submit solution: %.2f ms", (1000.0 * diff.tv_sec) + (0.001 * diff.tv_usec));
+		}
+
+		submit_result(xfer->req, val, xfer->data);
+		json_decref(val);
+	}
+	else {
+		applog(LOG_ERR, "ERROR: Submit bounty request failed");
+	}
+
+	if (xfer->req->req_type == SUBMIT_COMPLETE) {
+		applog(LOG_DEBUG, "DEBUG: Submit complete...deleting request");
+		free_submit_req(xfer->req);
+	}
+	else {
+		xfer->req->delay_tm = time(NULL) + 1;
+		xfer->req->retries++;
+		pthread_mutex_lock(&submit_lock);
+		if (!submit_heap_push(xfer->req))
+			free_submit_req(xfer->req);
+		pthread_mutex_unlock(&submit_lock);
+	}
+
+	xfer->req = NULL;
+	free(xfer->url);
+	free(xfer->data);
+	xfer->url = xfer->data = NULL;
+	xfer->busy = false;
+}
+
+// Submits Solutions Over A Pool Of Keep-Alive Connections, Up To --submit-conc At Once,
+// So A Burst Of Solutions Neither Queues Behind Each Other Nor Behind get_work()
+static void *submit_thread(void *userdata)
+{
+	struct thr_info *mythr = (struct thr_info *) userdata;
+	struct submit_xfer *xfer, *done;
+	struct submit_req *req;
+	struct workio_cmd *wc;
+	CURLSH *share;
+	CURLMsg *msg;
+	CURL *curl;
+	time_t now;
+	int i, j, running, pending;
+
+	xfer = calloc(opt_submit_conc, sizeof(struct submit_xfer));
+	share = curl_share_init();
+	if (!xfer || !share) {
+		applog(LOG_ERR, "ERROR: Unable to initialize submit thread");
+		return NULL;
+	}
+
+	// Transfers Only Run On This Thread, So The Share Needs No Lock Callbacks
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	curl_multi_setopt(g_submit_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)opt_submit_conc);
+	curl_multi_setopt(g_submit_multi, CURLMOPT_MAXCONNECTS, (long)opt_submit_conc);
+
+	for (i = 0; i < opt_submit_conc; i++) {
+		xfer[i].curl = curl_easy_init();
+		if (!xfer[i].curl) {
+			applog(LOG_ERR, "CURL initialization failed");
+			return NULL;
+		}
+	}
+
+	while (1) {
+
 		// Check For New Solutions On Queue
 		wc = (struct workio_cmd *) tq_pop_nowait(mythr->q);
 		while (wc) {
@@ -3147,158 +4127,262 @@ static void *workio_thread(void *userdata)
 			wc = (struct workio_cmd *) tq_pop_nowait(mythr->q);
 		}
 
-		// Submit POW / Bounty
-		for (i = 0; i < g_submit_req_cnt; i++) {
+		// Start The Most Urgent Due Requests While Connections Are Free
+		pthread_mutex_lock(&submit_lock);
+		for (j = 0; j < opt_submit_conc; j++) {
+			if (xfer[j].busy)
+				continue;
 
-// TODO - The Hold / Complete logic was originally used when bounties were announced, then confirmed.
-//        The logic will remain in place until it's determined if we need any retry logic around bounty submissions
+			now = time(NULL);
+			while ((req = submit_heap_pop(now))) {
 
-			// Skip Completed Requests
-			if (g_submit_req[i].req_type == SUBMIT_COMPLETE)
-				continue;
+				// Remove Stale Requests After 15min
+				if (now - req->start_tm >= 900) {
+					applog(LOG_DEBUG, "DEBUG: Submit request timed out after 15min");
+					free_submit_req(req);
+					g_bounty_timeout_cnt++;
+					continue;
+				}
 
-			// Skip Requests That Are On Hold
-			if (g_submit_req[i].delay_tm >= time(NULL))
-				continue;
+				if (submit_prepare(req, &xfer[j].url, &xfer[j].data))
+					break;
+
+				// Unknown Request Types Are Marked Complete, Anything Else Is Retried
+				if (req->req_type == SUBMIT_COMPLETE) {
+					free_submit_req(req);
+				}
+				else {
+					req->delay_tm = now + 1;
+					submit_heap_push(req);
+				}
+			}
+			if (!req)
+				break;
+
+			xfer[j].req = req;
 
-			// Submit Request
-			if (!submit_work(curl, &g_submit_req[i]))
-				applog(LOG_ERR, "ERROR: Submit bounty request failed");
+			json_rpc_prepare(xfer[j].curl, xfer[j].url, rpc_userpass, xfer[j].data, &xfer[j].db, xfer[j].err_str);
+			curl_easy_setopt(xfer[j].curl, CURLOPT_SHARE, share);
+			curl_easy_setopt(xfer[j].curl, CURLOPT_PRIVATE, &xfer[j]);
+			gettimeofday(&xfer[j].tv_start, NULL);
+
+			curl_multi_add_handle(g_submit_multi, xfer[j].curl);
+			xfer[j].busy = true;
 		}
+		pthread_mutex_unlock(&submit_lock);
 
-		// Remove Completed Solutions
-		for (i = 0; i < g_submit_req_cnt; i++) {
-			if (g_submit_req[i].req_type == SUBMIT_COMPLETE) {
-				applog(LOG_DEBUG, "DEBUG: Submit complete...deleting request");
-				delete_submit_req(i);
+		// Collect Finished Transfers
+		curl_multi_perform(g_submit_multi, &running);
+		while ((msg = curl_multi_info_read(g_submit_multi, &pending))) {
+			if (msg->msg != CURLMSG_DONE)
 				continue;
-			}
 
-			// Remove Stale Requests After 15min
-			if (time(NULL) - g_submit_req[i].start_tm >= 900) {
-				applog(LOG_DEBUG, "DEBUG: Submit request timed out after 15min");
-				delete_submit_req(i);
-				g_bounty_timeout_cnt++;
-			}
+			curl = msg->easy_handle;
+			curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char **)&done);
+			submit_finish(done, msg->data.result);
+			curl_multi_remove_handle(g_submit_multi, curl);
+			curl_easy_reset(curl);
 		}
 
-		// Sleep For 15 Sec If No Work
-		if (!g_work.work_id) {
-			for (i = 0; i < 15; i++) {
-				sleep(1);
-				if (g_new_block || g_submit_req_cnt)
-					break;
-			}
-		}
+		// Block Until A Transfer Progresses Or A Solution Is Queued.  Requests
+		// On Hold Or That Failed Are Retried Every Second
+		curl_multi_poll(g_submit_multi, NULL, 0, 1000, NULL);
 	}
 
-	tq_freeze(mythr->q);
-	curl_easy_cleanup(curl);
-
 	return NULL;
 }
 
 static bool add_submit_req(struct work *work, uint32_t *data, enum submit_commands req_type) {
+	struct work_package *wp;
+	struct submit_req *req;
+	uint32_t submit_sz;
+	uint64_t reward;
 
-	pthread_mutex_lock(&submit_lock);
+	// Packages May Be Added By The workio Thread Meanwhile
+	pthread_mutex_lock(&work_lock);
+	wp = &g_work_package[work->package_id];
+	submit_sz = wp->submit_sz;
+	reward = (req_type == SUBMIT_POW) ? wp->pow_reward : wp->bty_reward;
 
 	if (req_type == SUBMIT_POW) {
-		// Ignore Stale Submissions
-		if (work->block_id != g_cur_block_id) {
-			pthread_mutex_unlock(&submit_lock);
+
+		// Ignore Stale Submissions (Package Closed, Already Capped Or Found On An Earlier Block)
+		if (!wp->active || wp->pow_capped || (work->block_id != wp->block_id)) {
+			pthread_mutex_unlock(&work_lock);
+			if (data) free(data);
 			return true;
 		}
 
-		// Don't Exceed Max POW Sumbissions Per Block
-		if (g_cur_pow_cnt < MAX_POW_PER_BLOCK) {
+		// Don't Exceed Max POW Sumbissions Per Block For This Package
+		if (wp->pow_cnt < MAX_POW_PER_BLOCK) {
+			wp->pow_cnt++;
 			pthread_mutex_lock(&longpoll_lock);
 			g_cur_pow_cnt++;
 			pthread_mutex_unlock(&longpoll_lock);
 		}
 		else {
-			pthread_mutex_lock(&longpoll_lock);
-			if(*g_pow_ignore==false){
-				*g_pow_ignore = true;
-				applog(LOG_NOTICE, "%s***** miner has already submitted %d POW this block, we pause for a while *****", CL_YLW, MAX_POW_PER_BLOCK);
-			}
-			pthread_mutex_unlock(&longpoll_lock);
+			wp->pow_capped = true;
+			g_rebalance = true;
+			applog(LOG_NOTICE, "%s***** miner has already submitted %d POW for work_id %s this block, moving threads to other work *****", CL_YLW, MAX_POW_PER_BLOCK, wp->work_str);
 
-			pthread_mutex_unlock(&submit_lock);
+			pthread_mutex_unlock(&work_lock);
 
+			tq_wake(thr_info[work_thr_id].q);
+			update_ignore_flags();
+
+			if (data) free(data);
 			return true;
 		}
 	}
+	else {
+		wp->pending_bty_cnt++;
+	}
+	pthread_mutex_unlock(&work_lock);
 
-	g_submit_req = realloc(g_submit_req, (g_submit_req_cnt + 1) * sizeof(struct submit_req));
-	if (!g_submit_req) {
-		g_submit_req_cnt = 0;
+	req = calloc(1, sizeof(struct submit_req));
+	if (!req) {
 		applog(LOG_ERR, "ERROR: Bounty request allocation failed");
+		if (data) free(data);
 		return false;
 	}
-	g_submit_req[g_submit_req_cnt].thr_id = work->thr_id;
-	g_submit_req[g_submit_req_cnt].bounty = false;
-	g_submit_req[g_submit_req_cnt].req_type = req_type;
-	g_submit_req[g_submit_req_cnt].start_tm = time(NULL);
-	g_submit_req[g_submit_req_cnt].delay_tm = 0;
-	g_submit_req[g_submit_req_cnt].retries = 0;
-	g_submit_req[g_submit_req_cnt].work_id = work->work_id;
-	strncpy(g_submit_req[g_submit_req_cnt].work_str, work->work_str, 21);
-	bin2hex((unsigned char *)work->multiplicator, 32, g_submit_req[g_submit_req_cnt].mult, 65);
-	bin2hex((unsigned char *)work->pow_hash, 16, g_submit_req[g_submit_req_cnt].hash, 33);
-	g_submit_req[g_submit_req_cnt].iteration_id = work->iteration_id;
-	g_submit_req[g_submit_req_cnt].storage_id = (g_work_package[work->package_id].storage_id < 0xFFFF) ? g_work_package[work->package_id].storage_id : 0;
-	g_submit_req[g_submit_req_cnt].submit_data_sz = g_work_package[work->package_id].submit_sz;
-	g_submit_req[g_submit_req_cnt].submit_data = data;
-	if (req_type != SUBMIT_POW) {
-		g_submit_req[g_submit_req_cnt].bounty = true;
-		update_pending_cnt(work->work_id, true);
-	}
-	g_submit_req_cnt++;
+	req->thr_id = work->thr_id;
+	req->bounty = (req_type != SUBMIT_POW);
+	req->req_type = req_type;
+	req->start_tm = time(NULL);
+	req->delay_tm = 0;
+	req->retries = 0;
+	req->reward = reward;
+	req->work_id = work->work_id;
+	req->block_id = work->block_id;
+	strncpy(req->work_str, work->work_str, 21);
+	bin2hex((unsigned char *)work->multiplicator, 32, req->mult, 65);
+	bin2hex((unsigned char *)work->pow_hash, 16, req->hash, 33);
+	req->iteration_id = work->iteration_id;
+	req->storage_id = work->storage_id;	// The Storage The Solution Was Found With
+	req->submit_data_sz = submit_sz;
+	req->submit_data = data;
 
+	pthread_mutex_lock(&submit_lock);
+	if (!submit_heap_push(req)) {
+		pthread_mutex_unlock(&submit_lock);
+		free_submit_req(req);
+		return false;
+	}
 	pthread_mutex_unlock(&submit_lock);
+
 	return true;
 }
 
-static bool delete_submit_req(int idx) {
-	struct submit_req *req = NULL;
-	int i;
+static void free_submit_req(struct submit_req *req) {
+	if (req->submit_data)
+		free(req->submit_data);
 
-	pthread_mutex_lock(&submit_lock);
+	if (req->bounty)
+		update_pending_cnt(req->work_id, false);
+
+	free(req);
+}
+
+// Orders The Submit Queue: Requests On Hold Last, Then Bounties (Oldest First, As Their
+// Reveal Window Closes First), Then POW By Reward.  All POW Of A Block Share One Deadline
+static bool submit_before(struct submit_req *a, struct submit_req *b) {
+	if (a->delay_tm != b->delay_tm)
+		return a->delay_tm < b->delay_tm;
+	if (a->bounty != b->bounty)
+		return a->bounty;
+	if (a->bounty && (a->start_tm != b->start_tm))
+		return a->start_tm < b->start_tm;
+	if (a->reward != b->reward)
+		return a->reward > b->reward;
+	return a->start_tm < b->start_tm;
+}
+
+static void submit_heap_down(int i) {
+	struct submit_req *tmp;
+	int child;
 
-	// Clear Storage Buffer
-	if (g_submit_req[idx].submit_data)
-		free(g_submit_req[idx].submit_data);
+	while ((child = (2 * i) + 1) < g_submit_req_cnt) {
+		if ((child + 1 < g_submit_req_cnt) && submit_before(g_submit_heap[child + 1], g_submit_heap[child]))
+			child++;
+		if (!submit_before(g_submit_heap[child], g_submit_heap[i]))
+			break;
+		tmp = g_submit_heap[i];
+		g_submit_heap[i] = g_submit_heap[child];
+		g_submit_heap[child] = tmp;
+		i = child;
+	}
+}
 
-	if (g_submit_req[idx].bounty)
-		update_pending_cnt(g_submit_req[idx].work_id, false);
+// Caller Holds submit_lock
+static bool submit_heap_push(struct submit_req *req) {
+	struct submit_req **heap, *tmp;
+	int i, parent;
 
-	if (g_submit_req_cnt > 1) {
-		req = malloc((g_submit_req_cnt - 1) * sizeof(struct submit_req));
-		if (!req) {
+	if (g_submit_req_cnt == g_submit_heap_sz) {
+		heap = realloc(g_submit_heap, (g_submit_heap_sz ? 2 * g_submit_heap_sz : 64) * sizeof(struct submit_req *));
+		if (!heap) {
 			applog(LOG_ERR, "ERROR: Bounty request allocation failed");
-			pthread_mutex_unlock(&submit_lock);
 			return false;
 		}
+		g_submit_heap = heap;
+		g_submit_heap_sz = g_submit_heap_sz ? 2 * g_submit_heap_sz : 64;
 	}
-	else {
-		if (g_submit_req) free(g_submit_req);
-		g_submit_req = 0;
-		g_submit_req_cnt = 0;
-		pthread_mutex_unlock(&submit_lock);
-		return true;
+
+	i = g_submit_req_cnt++;
+	g_submit_heap[i] = req;
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (!submit_before(g_submit_heap[i], g_submit_heap[parent]))
+			break;
+		tmp = g_submit_heap[i];
+		g_submit_heap[i] = g_submit_heap[parent];
+		g_submit_heap[parent] = tmp;
+		i = parent;
 	}
 
-	for (i = 0; i < idx; i++)
-		memcpy(&req[i], &g_submit_req[i], sizeof(struct submit_req));
+	return true;
+}
+
+// Removes The Most Urgent Request If It Is Due By 'now' (Caller Holds submit_lock)
+static struct submit_req *submit_heap_pop(time_t now) {
+	struct submit_req *req;
+
+	if (!g_submit_req_cnt || (g_submit_heap[0]->delay_tm > now))
+		return NULL;
+
+	req = g_submit_heap[0];
+	g_submit_heap[0] = g_submit_heap[--g_submit_req_cnt];
+	submit_heap_down(0);
+
+	return req;
+}
 
-	for (i = idx + 1; i < g_submit_req_cnt; i++)
-		memcpy(&req[i - 1], &g_submit_req[i], sizeof(struct submit_req));
+// Drops Queued POW Found On A Block Other Than The One Its Package Is Now On, As The Node
+// Would Only Reject It.  Requests Already Being Sent Are Left To Finish
+static void submit_purge_pow(void) {
+	struct submit_req *req;
+	int i, idx, cnt = 0, purged;
 
-	free(g_submit_req);
-	g_submit_req = req;
-	g_submit_req_cnt--;
+	pthread_mutex_lock(&submit_lock);
+	pthread_mutex_lock(&work_lock);
+	for (i = 0; i < g_submit_req_cnt; i++) {
+		req = g_submit_heap[i];
+		idx = req->bounty ? -1 : find_work_package(req->work_id);
+		if (req->bounty || ((idx >= 0) && (g_work_package[idx].block_id == req->block_id)))
+			g_submit_heap[cnt++] = req;
+		else
+			free_submit_req(req);
+	}
+	pthread_mutex_unlock(&work_lock);
+	purged = g_submit_req_cnt - cnt;
+	g_submit_req_cnt = cnt;
+
+	for (i = (cnt / 2) - 1; i >= 0; i--)
+		submit_heap_down(i);
 	pthread_mutex_unlock(&submit_lock);
-	return true;
+
+	if (purged)
+		applog(LOG_DEBUG, "DEBUG: Dropped %d queued POW from the previous block", purged);
 }
 
 static void *key_monitor_thread(void *userdata)
@@ -3409,8 +4493,6 @@ static void free_up(){
 
 		applog(LOG_DEBUG, "Cleaning up");
 
-		if(g_bounty_ignore) free((void*)g_bounty_ignore);
-		if(g_pow_ignore) free((void*)g_pow_ignore);
 		if (rpc_url) free(rpc_url);
 		if (rpc_user) free(rpc_user);
 		if (rpc_pass) free(rpc_pass);
@@ -3422,7 +4504,7 @@ static void free_up(){
 
 		// now clear Threads
 		if(thr_info){
-			for(i=0; i<opt_n_threads + 3; ++i){
+			for(i=0; i<opt_n_threads + 5; ++i){
 					// clear theads
 					if(thr_info[i].q)
 						tq_free(thr_info[i].q);
@@ -3430,9 +4512,14 @@ static void free_up(){
 			free(thr_info);
 		}
 
-		// clear work restart
-		if(work_restart)
+		// clear work restart (and any snapshots not yet taken)
+		if(work_restart){
+			for(i=0; i<opt_n_threads; ++i)
+				snapshot_release(work_restart[i].snap);
 			free(work_restart);
+		}
+		if(g_thr_work)
+			free(g_thr_work);
 
 
 		if(thr_deadswitch){
@@ -3450,14 +4537,34 @@ static int thread_create(struct thr_info *thr, void* func)
 	return err;
 }
 
+#ifndef WIN32
+// Locks A Worker Process Uses Are Held Across fork() (--supervise) So It Never Starts With
+// One Taken By A Coordinator Thread That Doesn't Exist In The Child
+static void fork_prepare(void) {
+	library_lock(true);
+	pthread_mutex_lock(&park_lock);
+	pthread_mutex_lock(&applog_lock);
+}
+
+static void fork_parent(void) {
+	pthread_mutex_unlock(&applog_lock);
+	pthread_mutex_unlock(&park_lock);
+	library_lock(false);
+}
+
+static void fork_child(void) {
+	fork_parent();
+	pthread_cond_init(&park_cond, NULL);
+
+	// The Submit Engine Stays With The Coordinator
+	g_submit_multi = NULL;
+}
+#endif
+
 int main(int argc, char **argv) {
 	struct thr_info *thr;
 	int i, err, thr_idx, num_gpus = 0;
 
-	g_pow_ignore = (bool*)malloc(sizeof(bool));
-	g_bounty_ignore = (bool*)malloc(sizeof(bool));
-	*g_pow_ignore = false;
-	*g_bounty_ignore = false;
 
 	fprintf(stdout, "** Elastic Compute Engine **\n");
 	fprintf(stdout, "   Miner Version: " MINER_VERSION"\n");
@@ -3510,6 +4617,18 @@ int main(int argc, char **argv) {
 			opt_n_threads = num_gpus;
 	}
 
+	// The OpenCL Program Is Built For A Single Job At A Time
+	if (opt_opencl && (opt_portfolio > 1)) {
+		applog(LOG_ERR, "ERROR: --portfolio is not supported with OpenCL.  Mining one work package at a time");
+		opt_portfolio = 1;
+	}
+
+	// Workers Load The Coordinator's Job Libraries By Path
+	if (opt_supervise && opt_opencl) {
+		applog(LOG_ERR, "ERROR: --supervise is not supported with OpenCL.  Mining in a single process");
+		opt_supervise = false;
+	}
+
 	if (!rpc_url)
 		rpc_url = strdupcs("http://127.0.0.1:6876/nxt");
 
@@ -3522,6 +4641,20 @@ int main(int argc, char **argv) {
 		sprintf(rpc_userpass, "%s:%s", rpc_user, rpc_pass);
 	}
 
+	// Decoder Benchmark Runs Without A Node
+	if (opt_test_decode_bench) {
+		benchmark_decode();
+		free_up();
+		return 0;
+	}
+
+	// Miners Behind The Proxy Send Their Own Passphrase With Each Solution
+	if (opt_proxy_port) {
+		err = !proxy_run(opt_proxy_bind, opt_proxy_port, rpc_url, rpc_userpass, opt_fail_pause);
+		free_up();
+		return err;
+	}
+
 	if (!opt_test_vm && !passphrase) {
 		applog(LOG_ERR, "ERROR: Passphrase (option -P) is required");
 		free_up();
@@ -3530,6 +4663,9 @@ int main(int argc, char **argv) {
 
 	// Seed Random Number Generator
 	init_genrand((unsigned long)time(NULL));
+	nonce_init(opt_shard, opt_shards);
+	if (opt_shards > 1)
+		applog(LOG_INFO, "Mining shard %u of %u", opt_shard, opt_shards);
 //	RAND_poll();
 
 	// Reset Package / Iteration
@@ -3548,7 +4684,12 @@ int main(int argc, char **argv) {
 		free_up();
 		return 1;
 	}
-	thr_info = (struct thr_info*) calloc(opt_n_threads + 3, sizeof(struct thr_info));
+	g_thr_work = (struct work*) calloc(opt_n_threads, sizeof(struct work));
+	if (!g_thr_work){
+		free_up();
+		return 1;
+	}
+	thr_info = (struct thr_info*) calloc(opt_n_threads + 5, sizeof(struct thr_info));
 	if (!thr_info){
 		free_up();
 		return 1;
@@ -3596,6 +4737,24 @@ int main(int argc, char **argv) {
 	pthread_mutex_init(&submit_lock, NULL);
 	pthread_mutex_init(&longpoll_lock, NULL);
 
+	// Init Submit Thread Info
+	submit_thr_id = opt_n_threads + 4;
+	thr = &thr_info[submit_thr_id];
+	thr->id = submit_thr_id;
+	thr->q = tq_new();
+	g_submit_multi = curl_multi_init();
+	if (!thr->q || !g_submit_multi) {
+		free_up();
+		return 1;
+	}
+
+	// Start Submit Thread
+	if (thread_create(thr, submit_thread)) {
+		applog(LOG_ERR, "Submit thread create failed");
+		free_up();
+		return 1;
+	}
+
 	// Init workio Thread Info
 	work_thr_id = opt_n_threads;
 	thr = &thr_info[work_thr_id];
@@ -3613,7 +4772,24 @@ int main(int argc, char **argv) {
 		return 1;
 	}
 
-	applog(LOG_INFO, "Attempting to start %d miner threads", opt_n_threads);
+	// Plan Where Each CPU Miner Thread Runs Before Any Of Them Start
+	if (!opt_opencl && !affinity_init(opt_n_threads)) {
+		free_up();
+		return 1;
+	}
+
+	// Set Up The Shared Board Before Any Worker Is Forked
+	if (opt_supervise) {
+		if (!supervise_init(opt_n_threads, cpu_miner_thread)) {
+			free_up();
+			return 1;
+		}
+#ifndef WIN32
+		pthread_atfork(fork_prepare, fork_parent, fork_child);
+#endif
+	}
+
+	applog(LOG_INFO, "Attempting to start %d miner %s", opt_n_threads, opt_supervise ? "processes" : "threads");
 
 	thr_idx = 0;
 
@@ -3634,7 +4810,7 @@ int main(int argc, char **argv) {
 			sprintf(thr->name, "GPU%d", i);
 		}
 		else {
-			err = thread_create(thr, cpu_miner_thread);
+			err = opt_supervise ? 0 : thread_create(thr, cpu_miner_thread);
 			sprintf(thr->name, "CPU%d", i);
 		}
 		if (err) {
@@ -3644,7 +4820,13 @@ int main(int argc, char **argv) {
 		}
 	}
 
-	applog(LOG_INFO, "%d mining threads started", opt_n_threads);
+	// Fork The Worker Processes & Start Watching Them
+	if (opt_supervise && !supervise_start(&thr_info[opt_n_threads + 3])) {
+		free_up();
+		return 1;
+	}
+
+	applog(LOG_INFO, "%d mining %s started", opt_n_threads, opt_supervise ? "processes" : "threads");
 
 	gettimeofday(&g_miner_start_time, NULL);
 